@@ -7,4 +7,7 @@ namespace cathedral
 {
     std::vector<std::byte> compress_data(std::span<const std::byte>);
     std::vector<std::byte> decompress_data(std::span<const std::byte>, size_t uncompressed_size);
+
+    // Decompresses straight into 'dst', which must be exactly the uncompressed size
+    void decompress_data(std::span<const std::byte> src, std::span<std::byte> dst);
 } // namespace cathedral
\ No newline at end of file
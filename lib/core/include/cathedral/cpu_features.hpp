@@ -0,0 +1,28 @@
+#pragma once
+
+#include <ien/platform.hpp>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define CATHEDRAL_ARCH_X86_64
+#endif
+
+// Marks a function as compiled for AVX2, so that it can coexist with baseline code and be picked at runtime
+#ifdef IEN_COMPILER_MSVC
+    #define CATHEDRAL_TARGET_AVX2
+#else
+    #define CATHEDRAL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace cathedral
+{
+    struct cpu_features
+    {
+        bool sse2 = false;
+        bool ssse3 = false;
+        bool sse41 = false;
+        bool avx2 = false;
+    };
+
+    // Instruction set extensions supported by the running CPU, detected once on first call
+    const cpu_features& get_cpu_features();
+} // namespace cathedral
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cathedral/core.hpp>
+
+#include <ien/platform.hpp>
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+namespace cathedral
+{
+    // Read only memory mapping of a whole file
+    class mapped_file
+    {
+    public:
+        explicit mapped_file(const std::string& path);
+        ~mapped_file();
+
+        CATHEDRAL_NON_COPYABLE(mapped_file);
+
+        mapped_file(mapped_file&& other) noexcept;
+        mapped_file& operator=(mapped_file&& other) noexcept;
+
+        std::span<const std::byte> data() const { return { _data, _size }; }
+
+        size_t size() const { return _size; }
+
+    private:
+        const std::byte* _data = nullptr;
+        size_t _size = 0;
+#ifdef IEN_OS_WIN
+        void* _file_handle = nullptr;
+        void* _mapping_handle = nullptr;
+#endif
+
+        void unmap();
+    };
+} // namespace cathedral
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cathedral
+{
+    // sRGB transfer function conversions between 8 bit encoded values and linear floats in [0, 1].
+    // Decoding is an exact table lookup. Encoding uses a piecewise linear table that stays within
+    // one step of exact rounding; inputs outside [0, 1] (and NaN) are clamped.
+    // The batch versions use AVX2 when the running CPU supports it and match the scalar ones bit for bit.
+
+    float srgb_to_linear(uint8_t value);
+    uint8_t linear_to_srgb(float value);
+
+    void srgb_to_linear(const uint8_t* src, float* dst, size_t count);
+    void linear_to_srgb(const float* src, uint8_t* dst, size_t count);
+} // namespace cathedral
@@ -28,16 +28,19 @@ namespace cathedral
     std::vector<std::byte> decompress_data(const std::span<const std::byte> data, const size_t uncompressed_size)
     {
         std::vector<std::byte> result(uncompressed_size);
+        decompress_data(data, result);
+        return result;
+    }
 
+    void decompress_data(const std::span<const std::byte> src, const std::span<std::byte> dst)
+    {
         const auto decompressed_size = LZ4_decompress_safe(
-            reinterpret_cast<const char*>(data.data()),
-            reinterpret_cast<char*>(result.data()),
-            static_cast<int>(data.size()),
-            static_cast<int>(result.size()));
+            reinterpret_cast<const char*>(src.data()),
+            reinterpret_cast<char*>(dst.data()),
+            static_cast<int>(src.size()),
+            static_cast<int>(dst.size()));
 
-        CRITICAL_CHECK(decompressed_size > 0, "LZ4 decompression failure");
-        CRITICAL_CHECK(std::cmp_equal(uncompressed_size, decompressed_size), "LZ4 returned unexpected decompressed size");
-
-        return result;
+        CRITICAL_CHECK(decompressed_size >= 0, "LZ4 decompression failure");
+        CRITICAL_CHECK(std::cmp_equal(dst.size(), decompressed_size), "LZ4 returned unexpected decompressed size");
     }
 } // namespace cathedral
\ No newline at end of file
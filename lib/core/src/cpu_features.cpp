@@ -0,0 +1,81 @@
+#include <cathedral/cpu_features.hpp>
+
+#ifdef CATHEDRAL_ARCH_X86_64
+    #ifdef IEN_COMPILER_MSVC
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+#include <array>
+#include <cstdint>
+
+namespace cathedral
+{
+    namespace
+    {
+#ifdef CATHEDRAL_ARCH_X86_64
+        std::array<uint32_t, 4> cpuid(const uint32_t leaf, const uint32_t subleaf)
+        {
+            std::array<uint32_t, 4> regs = {};
+    #ifdef IEN_COMPILER_MSVC
+            std::array<int, 4> msvc_regs = {};
+            __cpuidex(msvc_regs.data(), static_cast<int>(leaf), static_cast<int>(subleaf));
+            for (size_t i = 0; i < regs.size(); ++i)
+            {
+                regs[i] = static_cast<uint32_t>(msvc_regs[i]);
+            }
+    #else
+            __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+    #endif
+            return regs;
+        }
+
+        uint64_t read_xcr0()
+        {
+    #ifdef IEN_COMPILER_MSVC
+            return _xgetbv(0);
+    #else
+            uint32_t eax = 0;
+            uint32_t edx = 0;
+            __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+            return (static_cast<uint64_t>(edx) << 32) | eax;
+    #endif
+        }
+#endif
+
+        cpu_features detect_cpu_features()
+        {
+            cpu_features result;
+#ifdef CATHEDRAL_ARCH_X86_64
+            const auto max_leaf = cpuid(0, 0)[0];
+            if (max_leaf < 1)
+            {
+                return result;
+            }
+
+            const auto leaf1 = cpuid(1, 0);
+            result.sse2 = (leaf1[3] & (1U << 26)) != 0;
+            result.ssse3 = (leaf1[2] & (1U << 9)) != 0;
+            result.sse41 = (leaf1[2] & (1U << 19)) != 0;
+
+            // AVX state must also be enabled by the OS (OSXSAVE + XMM/YMM bits in XCR0)
+            const bool osxsave = (leaf1[2] & (1U << 27)) != 0;
+            const bool os_avx_enabled = osxsave && ((read_xcr0() & 0x06) == 0x06);
+            if (max_leaf >= 7 && os_avx_enabled)
+            {
+                const auto leaf7 = cpuid(7, 0);
+                result.avx2 = (leaf7[1] & (1U << 5)) != 0;
+            }
+#endif
+            return result;
+        }
+    } // namespace
+
+    const cpu_features& get_cpu_features()
+    {
+        static const cpu_features features = detect_cpu_features();
+        return features;
+    }
+} // namespace cathedral
@@ -0,0 +1,125 @@
+#include <cathedral/mapped_file.hpp>
+
+#if defined(IEN_OS_WIN)
+    #include <ien/win32/windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <utility>
+
+namespace cathedral
+{
+    mapped_file::mapped_file(const std::string& path)
+    {
+#if defined(IEN_OS_WIN)
+        _file_handle = CreateFileA(
+            path.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr);
+        CRITICAL_CHECK(_file_handle != INVALID_HANDLE_VALUE, "Unable to open file for mapping");
+
+        LARGE_INTEGER file_size;
+        CRITICAL_CHECK(GetFileSizeEx(_file_handle, &file_size) != 0, "Unable to query size of mapped file");
+        _size = static_cast<size_t>(file_size.QuadPart);
+        if (_size == 0)
+        {
+            return;
+        }
+
+        _mapping_handle = CreateFileMappingA(_file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CRITICAL_CHECK(_mapping_handle != nullptr, "Unable to create file mapping");
+
+        _data = static_cast<const std::byte*>(MapViewOfFile(_mapping_handle, FILE_MAP_READ, 0, 0, 0));
+        CRITICAL_CHECK(_data != nullptr, "Unable to map view of file");
+#else
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        CRITICAL_CHECK(fd != -1, "Unable to open file for mapping");
+
+        struct stat file_stat = {};
+        const bool stat_ok = fstat(fd, &file_stat) == 0;
+        _size = stat_ok ? static_cast<size_t>(file_stat.st_size) : 0;
+
+        void* mapping = MAP_FAILED;
+        if (stat_ok && _size > 0)
+        {
+            mapping = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+
+        // The mapping keeps its own reference to the file
+        close(fd);
+
+        CRITICAL_CHECK(stat_ok, "Unable to query size of mapped file");
+        if (_size == 0)
+        {
+            return;
+        }
+        CRITICAL_CHECK(mapping != MAP_FAILED, "Unable to map file");
+        _data = static_cast<const std::byte*>(mapping);
+#endif
+    }
+
+    mapped_file::~mapped_file()
+    {
+        unmap();
+    }
+
+    mapped_file::mapped_file(mapped_file&& other) noexcept
+        : _data(std::exchange(other._data, nullptr))
+        , _size(std::exchange(other._size, 0))
+#if defined(IEN_OS_WIN)
+        , _file_handle(std::exchange(other._file_handle, nullptr))
+        , _mapping_handle(std::exchange(other._mapping_handle, nullptr))
+#endif
+    {
+    }
+
+    mapped_file& mapped_file::operator=(mapped_file&& other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+#if defined(IEN_OS_WIN)
+            _file_handle = std::exchange(other._file_handle, nullptr);
+            _mapping_handle = std::exchange(other._mapping_handle, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+    void mapped_file::unmap()
+    {
+#if defined(IEN_OS_WIN)
+        if (_data != nullptr)
+        {
+            UnmapViewOfFile(_data);
+        }
+        if (_mapping_handle != nullptr)
+        {
+            CloseHandle(_mapping_handle);
+        }
+        if (_file_handle != nullptr && _file_handle != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(_file_handle);
+        }
+        _file_handle = nullptr;
+        _mapping_handle = nullptr;
+#else
+        if (_data != nullptr)
+        {
+            munmap(const_cast<std::byte*>(_data), _size);
+        }
+#endif
+        _data = nullptr;
+        _size = 0;
+    }
+} // namespace cathedral
@@ -0,0 +1,184 @@
+#include <cathedral/srgb.hpp>
+
+#include <cathedral/cpu_features.hpp>
+
+#ifdef CATHEDRAL_ARCH_X86_64
+    #include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+
+namespace cathedral
+{
+    namespace
+    {
+        // Encoding splits the float range [2^-13, 1) into 13 exponents x 8 mantissa buckets. Within a bucket the
+        // next 8 mantissa bits select a position, and the encoded value is (bias + scale * position) >> 16.
+        constexpr uint32_t ENCODE_MIN_BITS = (127 - 13) << 23;
+        constexpr uint32_t ENCODE_MAX_BITS = 0x3F7FFFFF; // Largest float below 1
+        constexpr uint32_t ENCODE_BUCKETS = 13 * 8;
+
+        struct encode_table
+        {
+            std::array<uint32_t, ENCODE_BUCKETS> bias;
+            std::array<uint32_t, ENCODE_BUCKETS> scale;
+        };
+
+        double srgb_encode_exact(const double linear)
+        {
+            return linear <= 0.0031308 ? linear * 12.92 : (1.055 * std::pow(linear, 1.0 / 2.4)) - 0.055;
+        }
+
+        const std::array<float, 256>& get_decode_table()
+        {
+            static const std::array<float, 256> table = [] {
+                std::array<float, 256> result = {};
+                for (size_t i = 0; i < result.size(); ++i)
+                {
+                    const double encoded = static_cast<double>(i) / 255.0;
+                    result[i] = static_cast<float>(
+                        encoded <= 0.04045 ? encoded / 12.92 : std::pow((encoded + 0.055) / 1.055, 2.4));
+                }
+                return result;
+            }();
+            return table;
+        }
+
+        // Least squares fit of each bucket against the exact curve, biased by half a step so that the final
+        // shift rounds to nearest
+        const encode_table& get_encode_table()
+        {
+            static const encode_table table = [] {
+                encode_table result = {};
+                for (uint32_t bucket = 0; bucket < ENCODE_BUCKETS; ++bucket)
+                {
+                    double sum_t = 0.0;
+                    double sum_y = 0.0;
+                    double sum_tt = 0.0;
+                    double sum_ty = 0.0;
+                    for (uint32_t t = 0; t < 256; ++t)
+                    {
+                        const uint32_t bits = ENCODE_MIN_BITS + (bucket << 20) + (t << 12) + (1U << 11);
+                        const double y = (srgb_encode_exact(std::bit_cast<float>(bits)) * 255.0) + 0.5;
+                        sum_t += t;
+                        sum_y += y;
+                        sum_tt += static_cast<double>(t) * t;
+                        sum_ty += t * y;
+                    }
+                    const double slope = ((256.0 * sum_ty) - (sum_t * sum_y)) / ((256.0 * sum_tt) - (sum_t * sum_t));
+                    const double intercept = (sum_y - (slope * sum_t)) / 256.0;
+                    result.bias[bucket] = static_cast<uint32_t>(std::lround(std::max(intercept, 0.0) * 65536.0));
+                    result.scale[bucket] = static_cast<uint32_t>(std::lround(slope * 65536.0));
+                }
+                return result;
+            }();
+            return table;
+        }
+
+        uint8_t encode(const encode_table& table, const float value)
+        {
+            uint32_t bits = std::bit_cast<uint32_t>(value);
+            if (!(value > std::bit_cast<float>(ENCODE_MIN_BITS)))
+            {
+                bits = ENCODE_MIN_BITS;
+            }
+            bits = std::min(bits, ENCODE_MAX_BITS);
+
+            const uint32_t bucket = (bits - ENCODE_MIN_BITS) >> 20;
+            const uint32_t t = (bits >> 12) & 0xFF;
+            return static_cast<uint8_t>((table.bias[bucket] + (table.scale[bucket] * t)) >> 16);
+        }
+
+#ifdef CATHEDRAL_ARCH_X86_64
+        CATHEDRAL_TARGET_AVX2 size_t srgb_to_linear_avx2(const uint8_t* src, float* dst, const size_t count)
+        {
+            const float* table = get_decode_table().data();
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+                const __m256i indices = _mm256_cvtepu8_epi32(bytes);
+                _mm256_storeu_ps(dst + i, _mm256_i32gather_ps(table, indices, 4));
+            }
+            return i;
+        }
+
+        CATHEDRAL_TARGET_AVX2 size_t linear_to_srgb_avx2(const float* src, uint8_t* dst, const size_t count)
+        {
+            const auto& table = get_encode_table();
+            const __m256 min_value = _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(ENCODE_MIN_BITS)));
+            const __m256 max_value = _mm256_castsi256_ps(_mm256_set1_epi32(static_cast<int>(ENCODE_MAX_BITS)));
+            const __m256i min_bits = _mm256_set1_epi32(static_cast<int>(ENCODE_MIN_BITS));
+            const __m256i t_mask = _mm256_set1_epi32(0xFF);
+            const auto* bias = reinterpret_cast<const int*>(table.bias.data());
+            const auto* scale = reinterpret_cast<const int*>(table.scale.data());
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                // max_ps returns its second operand for NaN inputs, which clamps them like the scalar path
+                const __m256 clamped = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src + i), min_value), max_value);
+                const __m256i bits = _mm256_castps_si256(clamped);
+                const __m256i bucket = _mm256_srli_epi32(_mm256_sub_epi32(bits, min_bits), 20);
+                const __m256i t = _mm256_and_si256(_mm256_srli_epi32(bits, 12), t_mask);
+
+                const __m256i result = _mm256_srli_epi32(
+                    _mm256_add_epi32(
+                        _mm256_i32gather_epi32(bias, bucket, 4),
+                        _mm256_mullo_epi32(_mm256_i32gather_epi32(scale, bucket, 4), t)),
+                    16);
+
+                const __m128i packed16 =
+                    _mm_packus_epi32(_mm256_castsi256_si128(result), _mm256_extracti128_si256(result, 1));
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(packed16, packed16));
+            }
+            return i;
+        }
+#endif
+    } // namespace
+
+    float srgb_to_linear(const uint8_t value)
+    {
+        return get_decode_table()[value];
+    }
+
+    uint8_t linear_to_srgb(const float value)
+    {
+        return encode(get_encode_table(), value);
+    }
+
+    void srgb_to_linear(const uint8_t* src, float* dst, const size_t count)
+    {
+        size_t i = 0;
+#ifdef CATHEDRAL_ARCH_X86_64
+        if (get_cpu_features().avx2)
+        {
+            i = srgb_to_linear_avx2(src, dst, count);
+        }
+#endif
+        const auto& table = get_decode_table();
+        for (; i < count; ++i)
+        {
+            dst[i] = table[src[i]];
+        }
+    }
+
+    void linear_to_srgb(const float* src, uint8_t* dst, const size_t count)
+    {
+        size_t i = 0;
+#ifdef CATHEDRAL_ARCH_X86_64
+        if (get_cpu_features().avx2)
+        {
+            i = linear_to_srgb_avx2(src, dst, count);
+        }
+#endif
+        const auto& table = get_encode_table();
+        for (; i < count; ++i)
+        {
+            dst[i] = encode(table, src[i]);
+        }
+    }
+} // namespace cathedral
@@ -3,7 +3,6 @@
 #include <QDialog>
 
 class QComboBox;
-class QLabel;
 class QLineEdit;
 class QPushButton;
 class QSpinBox;
@@ -30,6 +29,8 @@ namespace cathedral::editor
 
         const auto& mipgen_filter() const { return _mipfilter; }
 
+        const auto& bc7_search_depth() const { return _bc7_depth; }
+
     private:
         QStringList _banned_names;
 
@@ -38,14 +39,15 @@ namespace cathedral::editor
         QString _format;
         int _mips{};
         QString _mipfilter;
+        QString _bc7_depth;
 
         QLineEdit* _name_edit = nullptr;
         QLineEdit* _path_edit = nullptr;
         QSpinBox* _mips_spinbox = nullptr;
         QComboBox* _format_combo = nullptr;
         QComboBox* _filter_combo = nullptr;
+        QComboBox* _bc7_depth_combo = nullptr;
         QPushButton* _create_button = nullptr;
-        QLabel* _format_warning_label = nullptr;
 
         void clamp_mips(const ien::image_info& iinfo);
         void update_states();
@@ -6,14 +6,10 @@
 
 #include <cathedral/project/assets/texture_asset.hpp>
 
-#include <ien/arithmetic.hpp>
-#include <ien/initializers.hpp>
-
 #include <QComboBox>
 #include <QFileDialog>
 #include <QFormLayout>
 #include <QHBoxLayout>
-#include <QLabel>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QSpinBox>
@@ -49,39 +45,40 @@ namespace cathedral::editor
 
         _format_combo = new QComboBox;
 
-        _format_warning_label = new QLabel("?");
-        _format_warning_label->setToolTip(
-            "Compressed texture formats are available only for images which dimensions are a power of 2");
-        _format_warning_label->setStyleSheet(R"(QLabel{ 
-            border-width:1px; border-style:solid; border-color: red; 
-            background-color: #444444; color: yellow;
-        })");
-
-        auto* format_combo_layout = new QHBoxLayout;
-        format_combo_layout->addWidget(_format_combo, 1);
-        format_combo_layout->addWidget(_format_warning_label, 0);
-
         _mips_spinbox = new QSpinBox;
         _mips_spinbox->setMaximum(1);
         _mips_spinbox->setMinimum(1);
 
         QStringList filter_list;
-        for (const auto& filter : magic_enum::enum_names<ien::resize_filter>())
+        for (const auto& filter : magic_enum::enum_names<engine::mip_filter>())
         {
             filter_list << QString::fromStdString(std::string{ filter });
         }
         _filter_combo = new QComboBox;
         _filter_combo->addItems(filter_list);
 
+        QStringList bc7_depth_list;
+        for (const auto& depth : magic_enum::enum_names<engine::bc7_search_depth>())
+        {
+            bc7_depth_list << QString::fromStdString(std::string{ depth });
+        }
+        _bc7_depth_combo = new QComboBox;
+        _bc7_depth_combo->addItems(bc7_depth_list);
+        _bc7_depth_combo->setCurrentText(
+            QString::fromStdString(std::string{ magic_enum::enum_name(engine::bc7_search_depth::NORMAL) }));
+        _bc7_depth_combo->setEnabled(false);
+        _bc7_depth_combo->setToolTip("Deeper searches produce better BC7 blocks but take considerably longer");
+
         _create_button = new QPushButton("Create");
         _create_button->setEnabled(false);
 
         auto* main_layout = new QFormLayout;
         main_layout->addRow("Name: ", _name_edit);
         main_layout->addRow("Path: ", path_layout);
-        main_layout->addRow("Format: ", format_combo_layout);
+        main_layout->addRow("Format: ", _format_combo);
         main_layout->addRow("Mip levels: ", _mips_spinbox);
         main_layout->addRow("Mip creation filter: ", _filter_combo);
+        main_layout->addRow("BC7 search depth: ", _bc7_depth_combo);
         main_layout->addRow("", _create_button);
 
         setLayout(main_layout);
@@ -100,12 +97,11 @@ namespace cathedral::editor
         CRITICAL_CHECK(format_opt.has_value(), "Invalid enum value");
 
         const bool is_compressed = engine::is_compressed_format(*format_opt);
+        _bc7_depth_combo->setEnabled(
+            is_compressed && engine::get_format_compression_type(*format_opt) == engine::texture_compression_type::BPTC_BC7);
 
-        const auto max_mips = IEN_CONDITIONAL_INIT_LAZY(
-            uint32_t,
-            is_compressed,
-            gfx::get_max_mip_levels(iinfo.width, iinfo.height) - 2,
-            gfx::get_max_mip_levels(iinfo.width, iinfo.height));
+        // Compressed mips smaller than a block are padded, so every format gets the full mip chain
+        const auto max_mips = gfx::get_max_mip_levels(iinfo.width, iinfo.height);
 
         _mips_spinbox->setMinimum(1);
         _mips_spinbox->setMaximum(static_cast<int>(max_mips));
@@ -116,7 +112,6 @@ namespace cathedral::editor
     {
         if (_path_edit->text().isEmpty())
         {
-            _format_warning_label->setVisible(false);
             return;
         }
 
@@ -124,28 +119,14 @@ namespace cathedral::editor
         if (!iinfo)
         {
             _mips_spinbox->setMaximum(1);
-            _format_warning_label->setEnabled(false);
             show_error_message("Not a valid image file");
             return;
         }
 
-        const bool is_power_of_2 = ien::is_power_of_2(iinfo->width) && ien::is_power_of_2(iinfo->height);
-        _format_warning_label->setVisible(!is_power_of_2);
-
         QStringList format_list;
-        for (const auto& [fmt, name] : magic_enum::enum_entries<engine::texture_format>())
+        for (const auto& name : magic_enum::enum_names<engine::texture_format>())
         {
-            if (engine::is_compressed_format(fmt))
-            {
-                if (is_power_of_2)
-                {
-                    format_list << QString::fromStdString(std::string{ name });
-                }
-            }
-            else
-            {
-                format_list << QString::fromStdString(std::string{ name });
-            }
+            format_list << QString::fromStdString(std::string{ name });
         }
         const auto previous_text = _format_combo->currentText();
         _format_combo->blockSignals(true);
@@ -211,6 +192,7 @@ namespace cathedral::editor
         _format = _format_combo->currentText();
         _mips = _mips_spinbox->value();
         _mipfilter = _filter_combo->currentText();
+        _bc7_depth = _bc7_depth_combo->currentText();
 
         accept();
     }
@@ -39,9 +39,11 @@ namespace cathedral::editor
             {
             case texture_format::R8_LINEAR:
             case texture_format::R8_SRGB:
+            case texture_format::RGTC1_BC4_LINEAR:
                 return image_format::R;
             case texture_format::R8G8_LINEAR:
             case texture_format::R8G8_SRGB:
+            case texture_format::RGTC2_BC5_LINEAR:
                 return image_format::RG;
             case texture_format::R8G8B8_LINEAR:
             case texture_format::R8G8B8_SRGB:
@@ -50,6 +52,8 @@ namespace cathedral::editor
             case texture_format::DXT5_BC3_SRGB:
             case texture_format::DXT1_BC1_LINEAR:
             case texture_format::DXT5_BC3_LINEAR:
+            case texture_format::BPTC_BC7_SRGB:
+            case texture_format::BPTC_BC7_LINEAR:
             case texture_format::R8G8B8A8_SRGB:
             case texture_format::R8G8B8A8_LINEAR:
                 return image_format::RGBA;
@@ -205,13 +209,21 @@ namespace cathedral::editor
         }
 
         const auto mip_levels = newtex_diag->mips();
-        const auto mipgen_filter = magic_enum::enum_cast<ien::resize_filter>(newtex_diag->mipgen_filter().toStdString());
+        const auto mipgen_filter = magic_enum::enum_cast<engine::mip_filter>(newtex_diag->mipgen_filter().toStdString());
         if (!mipgen_filter)
         {
             show_error_message("Invalid mipmap generation filter", this);
             return;
         }
 
+        const auto bc7_depth =
+            magic_enum::enum_cast<engine::bc7_search_depth>(newtex_diag->bc7_search_depth().toStdString());
+        if (!bc7_depth)
+        {
+            show_error_message("Invalid BC7 search depth", this);
+            return;
+        }
+
         constexpr auto MAX_PROGESS_RANGE = 1000;
 
         auto* progress_diag = new QProgressDialog(this);
@@ -223,7 +235,7 @@ namespace cathedral::editor
         progress_diag->setAutoClose(false);
         progress_diag->show();
 
-        std::jthread work_thread([this, newtex_diag, progress_diag, format, mip_levels, mipgen_filter] {
+        std::jthread work_thread([this, newtex_diag, progress_diag, format, mip_levels, mipgen_filter, bc7_depth] {
             const auto get_progress_for_mip_index = [](const int index) -> int {
                 return MAX_PROGESS_RANGE - (MAX_PROGESS_RANGE / (2 << index));
             };
@@ -239,7 +251,10 @@ namespace cathedral::editor
             auto mip0_data = [&] {
                 if (is_compressed_format(*format))
                 {
-                    return create_compressed_texture_data(source_image, engine::get_format_compression_type(*format));
+                    return create_compressed_texture_data(
+                        source_image,
+                        engine::get_format_compression_type(*format),
+                        *bc7_depth);
                 }
 
                 std::vector<std::byte> result(source_image.size());
@@ -253,21 +268,29 @@ namespace cathedral::editor
 
             if (mip_levels > 1)
             {
-                const auto generated_mips = engine::create_image_mips(source_image, *mipgen_filter, mip_levels - 1);
-                for (size_t i = 0; i < generated_mips.size(); ++i)
+                const auto generated_mips = engine::create_image_mips(
+                    source_image,
+                    *mipgen_filter,
+                    mip_levels - 1,
+                    !is_texture_format_linear(*format));
+                for (size_t i = 0; i < generated_mips.level_count(); ++i)
                 {
-                    const auto& mip = generated_mips[i];
+                    const auto& mip = generated_mips.level(i);
+                    const auto mip_data = generated_mips.level_data(i);
                     if (is_compressed_format(*format))
                     {
-                        mips.push_back(create_compressed_texture_data(mip, engine::get_format_compression_type(*format)));
+                        mips.push_back(create_compressed_texture_data(
+                            mip_data,
+                            mip.width,
+                            mip.height,
+                            engine::get_format_compression_type(*format),
+                            *bc7_depth));
                     }
                     else
                     {
-                        auto& vec = mips.emplace_back();
-                        vec.resize(mip.size());
-                        std::memcpy(vec.data(), mip.data(), vec.size());
+                        mips.emplace_back(mip_data.begin(), mip_data.end());
                     }
-                    mip_sizes.emplace_back(mip.width(), mip.height());
+                    mip_sizes.emplace_back(mip.width, mip.height);
                     QMetaObject::invokeMethod(this, [progress_diag, get_progress_for_mip_index, i] {
                         progress_diag->setValue(get_progress_for_mip_index(static_cast<int>(i) + 1));
                     });
@@ -32,6 +32,10 @@
 
 #include <ien/fs_utils.hpp>
 
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+
 // clang-format off
 #if defined(IEN_OS_WIN)
     #include <ien/win32/windows.h>
@@ -63,6 +67,14 @@
 
 namespace cathedral::editor
 {
+    namespace
+    {
+        std::string get_pipeline_cache_dir(const project::project& pro)
+        {
+            return (std::filesystem::path(pro.cache_path()) / "pipelines").string();
+        }
+    } // namespace
+
     editor_window::editor_window(std::shared_ptr<project::project> project)
         : _project(std::move(project))
     {
@@ -159,12 +171,15 @@ namespace cathedral::editor
             return size;
         };
         vkctx_args.validation_layers = is_debug_build();
+        vkctx_args.pipeline_cache_dir = get_pipeline_cache_dir(*_project);
 
         _vkctx = std::make_unique<gfx::vulkan_context>(vkctx_args);
         _swapchain = std::make_unique<gfx::swapchain>(*_vkctx, vk::PresentModeKHR::eFifo);
 
         engine::renderer_args renderer_args;
         renderer_args.swapchain = &*_swapchain;
+        // Editor scenes can hold many meshes, their draws are recorded on a few threads
+        renderer_args.recording_threads = std::clamp(std::thread::hardware_concurrency() / 2, 2U, 4U);
         _renderer = std::make_unique<engine::renderer>(renderer_args);
 
         engine::scene_args scene_args;
@@ -195,6 +210,12 @@ namespace cathedral::editor
 
         setup_vkwidget_connections();
 
+        // Saved on exit too, this keeps compiled pipelines if the editor does not shut down cleanly
+        auto* pipeline_cache_timer = new QTimer(this);
+        pipeline_cache_timer->setInterval(60000);
+        connect(pipeline_cache_timer, &QTimer::timeout, this, [this] { _vkctx->save_pipeline_cache(); });
+        pipeline_cache_timer->start();
+
         _camera_selector->set_current_camera(editor_camera_type::EDITOR_3D);
     }
 
@@ -301,7 +322,12 @@ namespace cathedral::editor
         if (_project->load_project(dir.toStdString()) != project::load_project_status::OK)
         {
             show_error_message("Failure loading project");
+            return;
         }
+
+        // Pipelines compiled from now on belong to the new project's cache
+        _renderer->wait_pipeline_compiles();
+        _vkctx->set_pipeline_cache_dir(get_pipeline_cache_dir(*_project));
     }
 
     void editor_window::open_material_manager()
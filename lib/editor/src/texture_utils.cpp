@@ -83,15 +83,19 @@ namespace cathedral::editor
         case DXT1_BC1_SRGB:
         case DXT5_BC3_LINEAR:
         case DXT5_BC3_SRGB:
+        case BPTC_BC7_LINEAR:
+        case BPTC_BC7_SRGB:
             return rgba_to_qrgba(image_data);
         case R8G8B8_SRGB:
         case R8G8B8_LINEAR:
             return rgb_to_qrgba(image_data);
         case R8G8_SRGB:
         case R8G8_LINEAR:
+        case RGTC2_BC5_LINEAR:
             return rg_to_qrgba(image_data);
         case R8_SRGB:
         case R8_LINEAR:
+        case RGTC1_BC4_LINEAR:
             return r_to_qrgba(image_data);
         default:
             CRITICAL_ERROR("Unhandled texture format");
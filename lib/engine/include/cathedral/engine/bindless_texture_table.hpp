@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cathedral/core.hpp>
+
+#include <cathedral/gfx/pipeline.hpp>
+
+#include <vulkan/vulkan.hpp>
+
+#include <deque>
+#include <map>
+#include <utility>
+#include <vector>
+
+FORWARD_CLASS(cathedral::gfx, vulkan_context);
+
+namespace cathedral::engine
+{
+    class bindless_texture_table;
+    class descriptor_write_batch;
+
+    constexpr uint32_t BINDLESS_TEXTURE_SET_INDEX = 3;
+    constexpr uint32_t MAX_BINDLESS_MATERIAL_TEXTURES = 16;
+    constexpr uint32_t MAX_BINDLESS_NODE_TEXTURES = 16;
+
+    // Texture indices are pushed per draw, material indices first and node indices after them
+    constexpr uint32_t BINDLESS_TEXTURE_INDEX_COUNT = MAX_BINDLESS_MATERIAL_TEXTURES + MAX_BINDLESS_NODE_TEXTURES;
+    constexpr uint32_t BINDLESS_PUSH_CONSTANT_SIZE = BINDLESS_TEXTURE_INDEX_COUNT * sizeof(uint32_t);
+
+    // Reference to a table slot, handed back to the table once no frame in flight can be sampling it
+    class bindless_texture_index
+    {
+    public:
+        bindless_texture_index() = default;
+        bindless_texture_index(bindless_texture_table* table, uint32_t index);
+        ~bindless_texture_index();
+
+        CATHEDRAL_NON_COPYABLE(bindless_texture_index);
+        bindless_texture_index(bindless_texture_index&& other) noexcept;
+        bindless_texture_index& operator=(bindless_texture_index&& other) noexcept;
+
+        uint32_t get() const { return _index; }
+
+        explicit operator bool() const { return _table != nullptr; }
+
+    private:
+        bindless_texture_table* _table = nullptr;
+        uint32_t _index = 0;
+
+        void release();
+    };
+
+    struct bindless_texture_table_args
+    {
+        uint32_t capacity = 16384; // Clamped to the device's sampled image descriptor limits
+        uint32_t frames_in_flight = 1;
+    };
+
+    // Single partially bound array of combined image samplers shared by every material and node. Each distinct image
+    // view and sampler pair is written once and looked up by index in shaders, so texture changes never touch the
+    // material and node descriptor sets
+    class bindless_texture_table
+    {
+    public:
+        bindless_texture_table(const gfx::vulkan_context& vkctx, bindless_texture_table_args args);
+
+        // The GPU must be done with frame (frame - frames_in_flight)
+        void begin_frame(uint64_t frame);
+
+        // Index of the slot holding 'view' and 'sampler', queueing the descriptor write if it is not in the table yet
+        [[nodiscard]] bindless_texture_index acquire(
+            vk::ImageView view,
+            vk::Sampler sampler,
+            descriptor_write_batch& writes);
+
+        gfx::pipeline_descriptor_set descriptor_set_definition() const;
+
+        vk::DescriptorSet descriptor_set() const { return _set; }
+
+        uint32_t capacity() const { return _capacity; }
+
+        uint32_t used_slots() const { return static_cast<uint32_t>(_lookup.size()); }
+
+    private:
+        struct slot
+        {
+            vk::ImageView view;
+            vk::Sampler sampler;
+            uint32_t references = 0;
+        };
+
+        const gfx::vulkan_context& _vkctx;
+        bindless_texture_table_args _args;
+        uint32_t _capacity;
+        uint64_t _frame = 0;
+
+        vk::UniqueDescriptorSetLayout _layout;
+        vk::UniqueDescriptorPool _pool;
+        vk::DescriptorSet _set;
+
+        std::vector<slot> _slots;
+        std::map<std::pair<vk::ImageView, vk::Sampler>, uint32_t> _lookup;
+        std::vector<uint32_t> _free_slots;
+        std::deque<std::pair<uint64_t, uint32_t>> _pending_free;
+
+        void release(uint32_t index);
+
+        friend class bindless_texture_index;
+    };
+} // namespace cathedral::engine
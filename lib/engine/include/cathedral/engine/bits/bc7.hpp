@@ -0,0 +1,208 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace cathedral::engine
+{
+    enum class bc7_search_depth : uint8_t;
+}
+
+// BC7 (BPTC) block layout tables, shared by the encoder and the decoder.
+// See the "BC7 Format" section of the Khronos Data Format Specification.
+namespace cathedral::engine::bc7
+{
+    constexpr uint32_t MODE_COUNT = 8;
+    constexpr uint32_t PARTITION_COUNT = 64;
+    constexpr uint32_t MAX_SUBSETS = 3;
+    constexpr uint32_t BLOCK_PIXELS = 16;
+
+    struct mode_info
+    {
+        uint8_t subsets;
+        uint8_t partition_bits;
+        uint8_t rotation_bits;
+        uint8_t index_selection_bits;
+        uint8_t color_bits;
+        uint8_t alpha_bits;
+        uint8_t endpoint_pbits; // One p-bit per endpoint
+        uint8_t shared_pbits; // One p-bit per subset, shared by both endpoints
+        uint8_t index_bits;
+        uint8_t index2_bits;
+    };
+
+    constexpr std::array<mode_info, MODE_COUNT> MODES = { {
+        { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+        { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+        { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+        { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+        { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+        { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+        { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+        { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+    } };
+
+    constexpr std::array<uint8_t, 4> WEIGHTS_2 = { 0, 21, 43, 64 };
+    constexpr std::array<uint8_t, 8> WEIGHTS_3 = { 0, 9, 18, 27, 37, 46, 55, 64 };
+    constexpr std::array<uint8_t, 16> WEIGHTS_4 = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    constexpr const uint8_t* get_weights(const uint32_t index_bits)
+    {
+        switch (index_bits)
+        {
+        case 2:
+            return WEIGHTS_2.data();
+        case 3:
+            return WEIGHTS_3.data();
+        default:
+            return WEIGHTS_4.data();
+        }
+    }
+
+    constexpr uint8_t interpolate(const uint32_t e0, const uint32_t e1, const uint32_t weight)
+    {
+        return static_cast<uint8_t>((((64 - weight) * e0) + (weight * e1) + 32) >> 6);
+    }
+
+    // Bit i set => pixel i belongs to subset 1
+    constexpr std::array<uint16_t, PARTITION_COUNT> PARTITIONS_2 = {
+        0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+        0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+        0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+        0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+        0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+        0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+        0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+        0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+    };
+
+    constexpr std::array<std::array<uint8_t, BLOCK_PIXELS>, PARTITION_COUNT> PARTITIONS_3 = { {
+        { 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 1, 2, 2, 2, 2 },
+        { 0, 0, 0, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 2, 1 },
+        { 0, 0, 0, 0, 2, 0, 0, 1, 2, 2, 1, 1, 2, 2, 1, 1 },
+        { 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 1, 0, 1, 1, 1 },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2 },
+        { 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 2, 2 },
+        { 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1 },
+        { 0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1 },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2 },
+        { 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2 },
+        { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2 },
+        { 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2 },
+        { 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2 },
+        { 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2 },
+        { 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2, 1, 2, 2, 2 },
+        { 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0, 2, 2, 2, 0 },
+        { 0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2 },
+        { 0, 1, 1, 1, 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0 },
+        { 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2 },
+        { 0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1 },
+        { 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2, 0, 2, 2, 2 },
+        { 0, 0, 0, 1, 0, 0, 0, 1, 2, 2, 2, 1, 2, 2, 2, 1 },
+        { 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2 },
+        { 0, 0, 0, 0, 1, 1, 0, 0, 2, 2, 1, 0, 2, 2, 1, 0 },
+        { 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1, 0, 0, 0, 0 },
+        { 0, 0, 1, 2, 0, 0, 1, 2, 1, 1, 2, 2, 2, 2, 2, 2 },
+        { 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1, 0, 1, 1, 0 },
+        { 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1 },
+        { 0, 0, 2, 2, 1, 1, 0, 2, 1, 1, 0, 2, 0, 0, 2, 2 },
+        { 0, 1, 1, 0, 0, 1, 1, 0, 2, 0, 0, 2, 2, 2, 2, 2 },
+        { 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1 },
+        { 0, 0, 0, 0, 2, 0, 0, 0, 2, 2, 1, 1, 2, 2, 2, 1 },
+        { 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 2, 2, 2 },
+        { 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 2, 0, 0, 1, 1 },
+        { 0, 0, 1, 1, 0, 0, 1, 2, 0, 0, 2, 2, 0, 2, 2, 2 },
+        { 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0 },
+        { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0 },
+        { 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0 },
+        { 0, 1, 2, 0, 2, 0, 1, 2, 1, 2, 0, 1, 0, 1, 2, 0 },
+        { 0, 0, 1, 1, 2, 2, 0, 0, 1, 1, 2, 2, 0, 0, 1, 1 },
+        { 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0, 1, 1 },
+        { 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2 },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1 },
+        { 0, 0, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2, 1, 1, 2, 2 },
+        { 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 1, 1 },
+        { 0, 2, 2, 0, 1, 2, 2, 1, 0, 2, 2, 0, 1, 2, 2, 1 },
+        { 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 0, 1, 0, 1 },
+        { 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1 },
+        { 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2 },
+        { 0, 2, 2, 2, 0, 1, 1, 1, 0, 2, 2, 2, 0, 1, 1, 1 },
+        { 0, 0, 0, 2, 1, 1, 1, 2, 0, 0, 0, 2, 1, 1, 1, 2 },
+        { 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2 },
+        { 0, 2, 2, 2, 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2 },
+        { 0, 0, 0, 2, 1, 1, 1, 2, 1, 1, 1, 2, 0, 0, 0, 2 },
+        { 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2 },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2 },
+        { 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2, 2, 2, 2, 2 },
+        { 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2 },
+        { 0, 0, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2 },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2 },
+        { 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 1 },
+        { 0, 2, 2, 2, 1, 2, 2, 2, 0, 2, 2, 2, 1, 2, 2, 2 },
+        { 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2 },
+        { 0, 1, 1, 1, 2, 0, 1, 1, 2, 2, 0, 1, 2, 2, 2, 0 }
+    } };
+
+    constexpr std::array<uint8_t, PARTITION_COUNT> ANCHORS_2_SUBSET_1 = {
+        15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+        15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+        15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+        6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15
+    };
+
+    constexpr std::array<uint8_t, PARTITION_COUNT> ANCHORS_3_SUBSET_1 = {
+        3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6, 6, 5, 3, 3,
+        3, 3, 8, 15, 3, 3, 6, 10, 5, 8, 8, 6, 8, 5, 15, 15,
+        8, 15, 3, 5, 6, 10, 8, 15, 15, 3, 15, 5, 15, 15, 15, 15,
+        3, 15, 5, 5, 5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3, 3
+    };
+
+    constexpr std::array<uint8_t, PARTITION_COUNT> ANCHORS_3_SUBSET_2 = {
+        15, 8, 8, 3, 15, 15, 3, 8, 15, 15, 15, 15, 15, 15, 15, 8,
+        15, 8, 15, 3, 15, 8, 15, 8, 3, 15, 6, 10, 15, 15, 10, 8,
+        15, 3, 15, 10, 10, 8, 9, 10, 6, 15, 8, 15, 3, 6, 6, 8,
+        15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3, 15, 15, 8
+    };
+
+    constexpr uint32_t get_subset(const uint32_t subsets, const uint32_t partition, const uint32_t pixel)
+    {
+        switch (subsets)
+        {
+        case 2:
+            return (PARTITIONS_2[partition] >> pixel) & 1U;
+        case 3:
+            return PARTITIONS_3[partition][pixel];
+        default:
+            return 0;
+        }
+    }
+
+    // Anchor pixels store their index with the most significant bit implicitly zero
+    constexpr uint32_t get_anchor(const uint32_t subsets, const uint32_t partition, const uint32_t subset)
+    {
+        if (subset == 0)
+        {
+            return 0;
+        }
+        if (subsets == 2)
+        {
+            return ANCHORS_2_SUBSET_1[partition];
+        }
+        return subset == 1 ? ANCHORS_3_SUBSET_1[partition] : ANCHORS_3_SUBSET_2[partition];
+    }
+
+    constexpr bool is_anchor(const uint32_t subsets, const uint32_t partition, const uint32_t pixel)
+    {
+        return pixel == get_anchor(subsets, partition, get_subset(subsets, partition, pixel));
+    }
+
+    // Expands a quantized endpoint channel of 'bits' bits (p-bit included) to 8 bits
+    constexpr uint8_t unquantize(const uint32_t value, const uint32_t bits)
+    {
+        const uint32_t shifted = value << (8 - bits);
+        return static_cast<uint8_t>(shifted | (shifted >> bits));
+    }
+
+    // Encodes a 4x4 block of RGBA8 pixels into 16 bytes
+    void compress_block(const uint8_t* rgba_pixels, uint8_t* dst, bc7_search_depth depth);
+} // namespace cathedral::engine::bc7
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <vector>
+
+namespace cathedral::engine
+{
+    struct buffer_copy
+    {
+        vk::Buffer src;
+        vk::BufferCopy region;
+    };
+
+    // Pending copies into a single destination buffer. A copy that continues the previous one is merged into it, and a
+    // copy overlapping earlier ones replaces them there, so destination ranges never overlap and order does not matter
+    class buffer_copy_list
+    {
+    public:
+        void add(vk::Buffer src, vk::DeviceSize src_offset, vk::DeviceSize dst_offset, vk::DeviceSize size);
+
+        const std::vector<buffer_copy>& copies() const { return _copies; }
+
+        bool empty() const { return _copies.empty(); }
+
+        void clear() { _copies.clear(); }
+
+        // Destination range covering every copy
+        vk::DeviceSize dst_begin() const;
+        vk::DeviceSize dst_end() const;
+
+    private:
+        std::vector<buffer_copy> _copies;
+    };
+} // namespace cathedral::engine
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cathedral/core.hpp>
+
+#include <cathedral/gfx/descriptor_set_definition.hpp>
+
+#include <vulkan/vulkan.hpp>
+
+#include <deque>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+FORWARD_CLASS(cathedral::gfx, vulkan_context);
+
+namespace cathedral::engine
+{
+    class descriptor_allocator;
+
+    // Descriptor set handed back to its allocator for reuse once no frame in flight can be using it
+    class pooled_descriptor_set
+    {
+    public:
+        pooled_descriptor_set() = default;
+        pooled_descriptor_set(descriptor_allocator* allocator, uint32_t layout_id, vk::DescriptorSet set);
+        ~pooled_descriptor_set();
+
+        CATHEDRAL_NON_COPYABLE(pooled_descriptor_set);
+        pooled_descriptor_set(pooled_descriptor_set&& other) noexcept;
+        pooled_descriptor_set& operator=(pooled_descriptor_set&& other) noexcept;
+
+        vk::DescriptorSet get() const { return _set; }
+
+        vk::DescriptorSet operator*() const { return _set; }
+
+        explicit operator bool() const { return static_cast<bool>(_set); }
+
+    private:
+        descriptor_allocator* _allocator = nullptr;
+        uint32_t _layout_id = 0;
+        vk::DescriptorSet _set;
+
+        void release();
+    };
+
+    struct descriptor_allocator_args
+    {
+        uint32_t sets_per_pool = 256; // Doubled for every new pool in a chain, up to max_sets_per_pool
+        uint32_t max_sets_per_pool = 4096;
+        uint32_t frames_in_flight = 1;
+    };
+
+    struct descriptor_allocator_stats
+    {
+        size_t pool_count = 0;
+        uint64_t allocated_sets = 0;
+        uint64_t recycled_sets = 0;
+    };
+
+    // Allocates descriptor sets from chains of pools that grow on demand. Sets are keyed by their layout definition, and
+    // released sets are recycled for the same definition instead of being freed, so pools never fragment
+    class descriptor_allocator
+    {
+    public:
+        descriptor_allocator(const gfx::vulkan_context& vkctx, descriptor_allocator_args args = {});
+
+        // The GPU must be done with frame (frame - frames_in_flight)
+        void begin_frame(uint64_t frame);
+
+        // Layout owned by the allocator, shared by every user of an identical definition
+        vk::DescriptorSetLayout layout(const gfx::descriptor_set_definition& definition);
+
+        [[nodiscard]] pooled_descriptor_set allocate(const gfx::descriptor_set_definition& definition);
+
+        descriptor_allocator_stats stats() const;
+
+    private:
+        struct layout_entry
+        {
+            vk::UniqueDescriptorSetLayout layout;
+            std::vector<vk::DescriptorSet> free_sets;
+        };
+
+        struct pool_chain
+        {
+            std::vector<vk::UniqueDescriptorPool> pools;
+            size_t current = 0;
+            uint32_t next_pool_sets = 0;
+        };
+
+        const gfx::vulkan_context& _vkctx;
+        descriptor_allocator_args _args;
+        uint64_t _frame = 0;
+
+        std::map<std::vector<uint32_t>, uint32_t> _layout_ids;
+        std::vector<layout_entry> _layouts;
+        std::deque<std::tuple<uint64_t, uint32_t, vk::DescriptorSet>> _pending_recycle;
+
+        pool_chain _pools;
+
+        uint64_t _allocated_sets = 0;
+        uint64_t _recycled_sets = 0;
+
+        uint32_t layout_id(const gfx::descriptor_set_definition& definition);
+        vk::DescriptorSet allocate_from(pool_chain& chain, vk::DescriptorSetLayout layout);
+        void add_pool(pool_chain& chain);
+        void recycle(uint32_t layout_id, vk::DescriptorSet set);
+
+        friend class pooled_descriptor_set;
+    };
+
+    // Collects descriptor writes so they reach the driver in a single updateDescriptorSets call
+    class descriptor_write_batch
+    {
+    public:
+        void write_buffer(
+            vk::DescriptorSet set,
+            uint32_t binding,
+            vk::DescriptorType type,
+            const vk::DescriptorBufferInfo& info);
+
+        void write_images(
+            vk::DescriptorSet set,
+            uint32_t binding,
+            std::vector<vk::DescriptorImageInfo> infos,
+            uint32_t first_element = 0);
+
+        bool empty() const { return _writes.empty(); }
+
+        void flush(const gfx::vulkan_context& vkctx);
+
+    private:
+        std::deque<vk::DescriptorBufferInfo> _buffer_infos;
+        std::deque<std::vector<vk::DescriptorImageInfo>> _image_infos;
+        std::vector<vk::WriteDescriptorSet> _writes;
+    };
+} // namespace cathedral::engine
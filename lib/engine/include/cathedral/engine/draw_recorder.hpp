@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cathedral/core.hpp>
+
+#include <cathedral/engine/bindless_texture_table.hpp>
+
+#include <vulkan/vulkan.hpp>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+FORWARD_CLASS(cathedral::gfx, vulkan_context);
+
+namespace cathedral::engine
+{
+    // Everything needed to record one indexed draw, captured on the thread that walks the scene
+    struct draw_command
+    {
+        vk::Pipeline pipeline;
+        vk::PipelineLayout pipeline_layout;
+        std::array<vk::DescriptorSet, 4> descriptor_sets; // The bindless texture table goes last, when used
+        uint32_t descriptor_set_count = 3;
+        std::array<uint32_t, 3> dynamic_offsets = {}; // One dynamic uniform per set, the table has none
+        std::optional<std::array<uint32_t, BINDLESS_TEXTURE_INDEX_COUNT>> texture_indices;
+        vk::Buffer vertex_buffer;
+        vk::Buffer index_buffer;
+        int32_t vertex_offset = 0;
+        uint32_t first_index = 0;
+        uint32_t index_count = 0;
+    };
+
+    // Records 'draw', skipping the pipeline, descriptor set, push constant and buffer bindings already made by 'previous'
+    // in the same command buffer
+    void record_draw(vk::CommandBuffer cmdbuff, const draw_command& draw, const draw_command* previous = nullptr);
+
+    struct draw_recorder_args
+    {
+        const gfx::vulkan_context* vkctx = nullptr;
+        uint32_t thread_count = 1; // Including the calling thread
+        uint32_t frames_in_flight = 1;
+        uint32_t draws_per_chunk = 128;
+        vk::Format color_format = vk::Format::eUndefined;
+        vk::Format depthstencil_format = vk::Format::eUndefined;
+    };
+
+    // Records draw lists into secondary command buffers on a set of worker threads. Each thread allocates from its own
+    // command pools, one per frame in flight, which are reset as a whole when the frame comes around again
+    class draw_recorder
+    {
+    public:
+        explicit draw_recorder(draw_recorder_args args);
+        ~draw_recorder();
+
+        CATHEDRAL_NON_COPYABLE(draw_recorder);
+
+        // The GPU must be done with the frame that last used 'frame_index'
+        void begin_frame(uint32_t frame_index);
+
+        // Records each list in 'passes' into secondaries meant to run inside a dynamic rendering pass. Returns the
+        // secondaries of every pass in draw order
+        std::vector<std::vector<vk::CommandBuffer>> record(
+            std::span<const std::vector<draw_command>> passes,
+            const vk::Viewport& viewport,
+            const vk::Rect2D& scissor);
+
+        uint32_t thread_count() const { return _args.thread_count; }
+
+    private:
+        struct thread_pool
+        {
+            vk::UniqueCommandPool pool;
+            std::vector<vk::UniqueCommandBuffer> cmdbuffs;
+            uint32_t used = 0;
+        };
+
+        struct chunk
+        {
+            std::span<const draw_command> draws;
+            vk::CommandBuffer* result = nullptr;
+        };
+
+        draw_recorder_args _args;
+        std::vector<std::vector<thread_pool>> _pools; // [frame][thread]
+        uint32_t _frame_index = 0;
+
+        std::vector<chunk> _chunks;
+        vk::Viewport _viewport;
+        vk::Rect2D _scissor;
+        std::atomic<size_t> _next_chunk = 0;
+
+        std::mutex _mutex;
+        std::condition_variable_any _work_cv;
+        std::condition_variable _done_cv;
+        uint64_t _generation = 0;
+        size_t _chunks_done = 0;
+        uint32_t _active_workers = 0;
+
+        std::vector<std::jthread> _workers;
+
+        void worker_main(const std::stop_token& stop, uint32_t thread_index);
+        void run_chunks(uint32_t thread_index);
+        void record_chunk(uint32_t thread_index, const chunk& chk);
+        vk::CommandBuffer next_cmdbuff(uint32_t thread_index);
+    };
+} // namespace cathedral::engine
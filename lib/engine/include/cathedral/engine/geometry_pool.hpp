@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cathedral/engine/range_allocator.hpp>
+
+#include <cathedral/gfx/buffers/index_buffer.hpp>
+#include <cathedral/gfx/buffers/vertex_buffer.hpp>
+
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace cathedral::engine
+{
+    class upload_queue;
+
+    struct geometry_pool_args
+    {
+        uint32_t block_vertex_count = 1024 * 1024; // Meshes larger than a block get a block of their own
+        uint32_t block_index_count = 4 * 1024 * 1024;
+    };
+
+    struct geometry_range
+    {
+        uint32_t block = 0;
+        uint32_t vertex_offset = 0;
+        uint32_t vertex_count = 0;
+        uint32_t first_index = 0;
+        uint32_t index_count = 0;
+    };
+
+    struct geometry_pool_stats
+    {
+        size_t block_count = 0;
+        uint64_t used_vertices = 0;
+        uint64_t used_indices = 0;
+    };
+
+    // Suballocates mesh geometry from a few large vertex and index buffers, so meshes sharing a block are drawn with
+    // the same buffer bindings through their vertex offset and first index
+    class geometry_pool
+    {
+    public:
+        geometry_pool(const gfx::vulkan_context& vkctx, uint32_t vertex_size, geometry_pool_args args = {});
+
+        // Allocates room for the mesh and queues the upload of its data
+        geometry_range allocate(std::span<const float> vertex_data, std::span<const uint32_t> indices, upload_queue& queue);
+
+        // The range must not be in use by any frame in flight
+        void free(const geometry_range& range);
+
+        const gfx::vertex_buffer& vertex_buffer(uint32_t block) const { return _blocks[block]->vertex_buffer; }
+
+        const gfx::index_buffer& index_buffer(uint32_t block) const { return _blocks[block]->index_buffer; }
+
+        geometry_pool_stats stats() const;
+
+    private:
+        struct block
+        {
+            gfx::vertex_buffer vertex_buffer;
+            gfx::index_buffer index_buffer;
+            range_allocator vertex_alloc;
+            range_allocator index_alloc;
+        };
+
+        const gfx::vulkan_context& _vkctx;
+        uint32_t _vertex_size;
+        geometry_pool_args _args;
+        std::vector<std::unique_ptr<block>> _blocks;
+
+        uint32_t add_block(uint32_t vertex_count, uint32_t index_count);
+    };
+} // namespace cathedral::engine
@@ -2,6 +2,8 @@
 
 #include <cathedral/core.hpp>
 
+#include <cathedral/engine/bindless_texture_table.hpp>
+#include <cathedral/engine/descriptor_allocator.hpp>
 #include <cathedral/engine/material_domain.hpp>
 #include <cathedral/engine/shader.hpp>
 #include <cathedral/engine/shader_bindings.hpp>
@@ -10,7 +12,10 @@
 #include <cathedral/gfx/buffers/uniform_buffer.hpp>
 #include <cathedral/gfx/pipeline.hpp>
 
+#include <array>
 #include <functional>
+#include <future>
+#include <limits>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -51,26 +56,33 @@ namespace cathedral::engine
         void update_uniform(const std::function<void(T&)>& func)
         {
             CRITICAL_CHECK(sizeof(T) <= _uniform_data.size(), "Attempt to write beyond uniform data bounds");
-            const auto previous_data = _uniform_data;
             func(*reinterpret_cast<T*>(_uniform_data.data()));
-            if (previous_data != _uniform_data)
-            {
-                _uniform_needs_update = true;
-            }
         }
 
         void update();
 
         const auto& bound_textures() const { return _texture_slots; }
 
+        // False until the pipeline compiled on a worker thread has been swapped in by update()
+        bool pipeline_ready() const { return _pipeline != nullptr; }
+
         const gfx::pipeline& pipeline() const { return *_pipeline; }
 
-        vk::DescriptorSetLayout material_descriptor_set_layout() const { return *_material_descriptor_set_layout; }
+        vk::DescriptorSetLayout material_descriptor_set_layout() const { return _material_descriptor_set_layout; }
 
-        vk::DescriptorSetLayout node_descriptor_set_layout() const { return *_node_descriptor_set_layout; }
+        vk::DescriptorSetLayout node_descriptor_set_layout() const { return _node_descriptor_set_layout; }
 
         vk::DescriptorSet descriptor_set() const { return *_descriptor_set; }
 
+        // Bindless mode only. Node sets hold nothing but the node uniform binding, so every node of the material shares one
+        vk::DescriptorSet shared_node_descriptor_set() const { return *_shared_node_descriptor_set; }
+
+        // Bindless mode only, table indices of the material texture slots
+        const auto& bindless_texture_indices() const { return _bindless_texture_indices; }
+
+        // Dynamic offset of this frame's material uniform data in the renderer's uniform arena, written on first use
+        uint32_t frame_uniform_offset();
+
         const auto& material_descriptor_set_definition() const { return _material_descriptor_set_info; }
 
         const auto& node_descriptor_set_definition() const { return _node_descriptor_set_info; }
@@ -141,6 +153,21 @@ namespace cathedral::engine
         uint32_t uid() const { return _uid; }
 
     protected:
+        struct shader_sources
+        {
+            gfx::shader_args vertex;
+            gfx::shader_args fragment;
+            shader_preprocess_data vertex_pp_data;
+            shader_preprocess_data fragment_pp_data;
+        };
+
+        struct compiled_pipeline
+        {
+            std::shared_ptr<shader> vertex_shader;
+            std::shared_ptr<shader> fragment_shader;
+            std::shared_ptr<gfx::pipeline> pipeline;
+        };
+
         uint32_t _uid;
         renderer* _renderer;
         material_args _args;
@@ -151,28 +178,38 @@ namespace cathedral::engine
         uint32_t _material_uniform_block_size = 0;
         uint32_t _node_uniform_block_size = 0;
 
-        std::unique_ptr<gfx::pipeline> _pipeline;
+        std::shared_ptr<gfx::pipeline> _pipeline; // Shared with every material built from the same shaders and state
+        std::future<compiled_pipeline> _pending_pipeline;
         gfx::pipeline_descriptor_set _material_descriptor_set_info;
         gfx::pipeline_descriptor_set _node_descriptor_set_info;
-        vk::UniqueDescriptorSetLayout _material_descriptor_set_layout;
-        vk::UniqueDescriptorSetLayout _node_descriptor_set_layout;
-        vk::UniqueDescriptorSet _descriptor_set;
+        vk::DescriptorSetLayout _material_descriptor_set_layout; // Owned by the renderer's descriptor allocator
+        vk::DescriptorSetLayout _node_descriptor_set_layout;
+        pooled_descriptor_set _descriptor_set;
+        pooled_descriptor_set _shared_node_descriptor_set;
 
         std::unordered_map<std::string, uint32_t> _mat_var_offsets;
         std::unordered_map<std::string, uint32_t> _node_var_offsets;
 
-        std::unique_ptr<gfx::uniform_buffer> _material_uniform;
         std::vector<std::shared_ptr<texture>> _texture_slots;
+        std::vector<uint32_t> _texture_slot_generations;
+        bool _textures_need_write = false;
+        std::vector<bindless_texture_index> _bindless_texture_slots;
+        std::array<uint32_t, MAX_BINDLESS_MATERIAL_TEXTURES> _bindless_texture_indices = {};
 
         std::vector<std::byte> _uniform_data;
-        bool _uniform_needs_update = true;
+        uint32_t _uniform_offset = 0;
+        uint64_t _uniform_frame = std::numeric_limits<uint64_t>::max();
         bool _needs_pipeline_update = false;
 
-        void init_pipeline();
+        void init_descriptor_set_infos();
+        gfx::pipeline_args make_pipeline_args() const;
+        void compile_pipeline(shader_sources sources);
+        void install_pipeline(compiled_pipeline compiled);
         void init_descriptor_set_layouts();
         void init_descriptor_set();
         void init_default_textures();
+        void write_texture_descriptors();
 
-        void init_shaders_and_data();
+        shader_sources init_shaders_and_data();
     };
 } // namespace cathedral::engine
\ No newline at end of file
@@ -1,7 +1,7 @@
 #pragma once
 
+#include <cathedral/engine/geometry_pool.hpp>
 #include <cathedral/engine/mesh.hpp>
-#include <cathedral/gfx/buffers.hpp>
 
 #include <memory>
 #include <unordered_map>
@@ -10,10 +10,23 @@ namespace cathedral::engine
 {
     class renderer;
 
-    struct mesh_buffer
+    // A mesh's range in the renderer's geometry pool, handed back once no frame in flight can be drawing it
+    class mesh_buffer
     {
-        gfx::vertex_buffer vertex_buffer;
-        gfx::index_buffer index_buffer;
+    public:
+        mesh_buffer(renderer& rend, geometry_range range);
+        ~mesh_buffer();
+        CATHEDRAL_NON_COPYABLE(mesh_buffer);
+
+        const geometry_range& range() const { return _range; }
+
+        vk::Buffer vertex_buffer() const;
+
+        vk::Buffer index_buffer() const;
+
+    private:
+        renderer& _renderer;
+        geometry_range _range;
     };
 
     class mesh_buffer_storage
@@ -29,4 +42,4 @@ namespace cathedral::engine
         renderer* _renderer;
         std::unordered_map<std::string, std::weak_ptr<mesh_buffer>> _buffers;
     };
-} // namespace cathedral::engine
\ No newline at end of file
+} // namespace cathedral::engine
@@ -9,6 +9,8 @@
 
 #include <cathedral/gfx/buffers.hpp>
 
+#include <cathedral/sphere.hpp>
+
 namespace cathedral::engine
 {
     class material;
@@ -50,16 +52,19 @@ namespace cathedral::engine
         bool _needs_update_mesh = true;
         std::optional<std::string> _material_name;
         bool _needs_update_material = true;
-        std::unique_ptr<gfx::uniform_buffer> _mesh3d_uniform_buffer;
         std::weak_ptr<material> _material;
         uint32_t _material_uid = std::numeric_limits<uint32_t>::max();
-        vk::UniqueDescriptorSet _descriptor_set;
+        pooled_descriptor_set _descriptor_set;
+        std::vector<bindless_texture_index> _bindless_texture_slots;
+        std::array<uint32_t, MAX_BINDLESS_NODE_TEXTURES> _bindless_texture_indices = {};
         std::vector<std::string> _texture_names;
         std::vector<std::shared_ptr<texture>> _texture_slots;
+        std::vector<uint32_t> _texture_slot_generations;
         bool _needs_update_textures = true;
+        bool _descriptor_set_needs_rebuild = false;
+        std::optional<sphere> _local_bounds;
 
         std::vector<std::byte> _uniform_data;
-        bool _uniform_needs_update = true;
 
         void init_default_textures(const renderer& rend);
 
@@ -69,6 +74,14 @@ namespace cathedral::engine
 
         void update_bindings();
 
-        void bind_node_texture_slot(const renderer& rend, std::shared_ptr<texture>, uint32_t slot);
+        float projected_screen_size(const scene& scene) const;
+
+        void request_streamed_mips(scene& scene, const material& mat) const;
+
+        void bind_node_texture_slot(std::shared_ptr<texture>, uint32_t slot);
+
+        void rebuild_descriptor_set(renderer& rend);
+
+        void rebuild_bindless_texture_indices(renderer& rend);
     };
 } // namespace cathedral::engine
\ No newline at end of file
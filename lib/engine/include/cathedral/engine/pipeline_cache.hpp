@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cathedral/gfx/pipeline.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace cathedral::engine
+{
+    class descriptor_allocator;
+
+    struct pipeline_cache_stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t pipeline_count = 0;
+        size_t layout_count = 0;
+    };
+
+    // Hands out one shared pipeline per distinct set of pipeline_args, keyed by the SPIR-V of its shaders and its state.
+    // Set layouts come from the descriptor allocator and pipeline layouts are shared as well, so materials built from
+    // the same shaders bind the very same pipeline. Unlike the driver's vk::PipelineCache, which only speeds up
+    // compilation, cache hits create nothing at all
+    class pipeline_cache
+    {
+    public:
+        pipeline_cache(const gfx::vulkan_context& vkctx, descriptor_allocator& allocator);
+
+        // Fills in empty set and pipeline layouts in 'args' with shared ones
+        void resolve_layouts(gfx::pipeline_args& args);
+
+        // Resolves layouts first if needed. Safe to call from worker threads once every layout has been resolved
+        std::shared_ptr<gfx::pipeline> get(gfx::pipeline_args args);
+
+        pipeline_cache_stats stats() const;
+
+    private:
+        const gfx::vulkan_context& _vkctx;
+        descriptor_allocator& _allocator;
+
+        // Pipelines are only kept alive by their users, layouts live as long as the cache
+        std::map<std::vector<uint64_t>, vk::UniquePipelineLayout> _layouts;
+        std::map<std::vector<uint64_t>, std::weak_ptr<gfx::pipeline>> _pipelines;
+
+        mutable std::mutex _pipelines_mutex;
+        uint64_t _hits = 0;
+        uint64_t _misses = 0;
+
+        vk::PipelineLayout pipeline_layout(const gfx::pipeline_args& args);
+    };
+} // namespace cathedral::engine
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cathedral/core.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace cathedral::engine
+{
+    struct pipeline_compiler_args
+    {
+        uint32_t thread_count = 2; // 0 runs every job on the submitting thread, before submit returns
+    };
+
+    // Worker threads compiling shaders and creating pipelines off the frame loop. Jobs must not touch renderer state
+    // other than what is documented as thread safe, and hand their results back through the returned future
+    class pipeline_compiler
+    {
+    public:
+        explicit pipeline_compiler(pipeline_compiler_args args);
+        ~pipeline_compiler();
+
+        CATHEDRAL_NON_COPYABLE(pipeline_compiler);
+
+        template <typename Func>
+        [[nodiscard]] std::future<std::invoke_result_t<Func>> submit(Func&& func)
+        {
+            std::packaged_task<std::invoke_result_t<Func>()> task(std::forward<Func>(func));
+            auto result = task.get_future();
+            if (_workers.empty())
+            {
+                task();
+            }
+            else
+            {
+                push([task = std::move(task)]() mutable { task(); });
+            }
+            return result;
+        }
+
+        // Jobs queued but not yet picked up by a worker
+        size_t pending_jobs() const;
+
+        // Blocks until every queued job has run, so nothing else creates pipelines meanwhile
+        void wait_idle();
+
+        // Drops the queued jobs, whose futures report a broken promise, and joins the workers once their running jobs
+        // are done. Also done on destruction, nothing may be submitted afterwards
+        void shutdown();
+
+        uint32_t thread_count() const { return _args.thread_count; }
+
+    private:
+        pipeline_compiler_args _args;
+
+        mutable std::mutex _mutex;
+        std::condition_variable_any _work_cv;
+        std::condition_variable _idle_cv;
+        std::deque<std::move_only_function<void()>> _jobs;
+        uint32_t _running_jobs = 0;
+
+        std::vector<std::jthread> _workers;
+
+        void push(std::move_only_function<void()> job);
+        void worker_main(const std::stop_token& stop);
+    };
+} // namespace cathedral::engine
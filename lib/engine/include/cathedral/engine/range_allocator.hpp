@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+
+namespace cathedral::engine
+{
+    // First-fit free-list allocator over [0, capacity). Freed ranges are merged with their free neighbours, so the
+    // free list only ever holds ranges separated by allocations
+    class range_allocator
+    {
+    public:
+        explicit range_allocator(uint32_t capacity);
+
+        std::optional<uint32_t> allocate(uint32_t size);
+
+        void free(uint32_t offset, uint32_t size);
+
+        uint32_t capacity() const { return _capacity; }
+
+        uint32_t used() const { return _used; }
+
+        uint32_t largest_free_range() const;
+
+        size_t free_range_count() const { return _free_ranges.size(); }
+
+    private:
+        uint32_t _capacity;
+        uint32_t _used = 0;
+        std::map<uint32_t, uint32_t> _free_ranges; // offset -> size
+    };
+} // namespace cathedral::engine
@@ -2,19 +2,48 @@
 
 #include <cathedral/gfx/depthstencil_attachment.hpp>
 #include <cathedral/gfx/shader.hpp>
-#include <cathedral/gfx/swapchain.hpp>
+#include <cathedral/gfx/render_target.hpp>
 #include <cathedral/gfx/vulkan_context.hpp>
 
+#include <cathedral/engine/bindless_texture_table.hpp>
+#include <cathedral/engine/descriptor_allocator.hpp>
+#include <cathedral/engine/draw_recorder.hpp>
+#include <cathedral/engine/geometry_pool.hpp>
 #include <cathedral/engine/material.hpp>
+#include <cathedral/engine/pipeline_cache.hpp>
+#include <cathedral/engine/pipeline_compiler.hpp>
+#include <cathedral/engine/sampler_cache.hpp>
 #include <cathedral/engine/shader.hpp>
 #include <cathedral/engine/texture.hpp>
+#include <cathedral/engine/texture_streamer.hpp>
+#include <cathedral/engine/uniform_arena.hpp>
 #include <cathedral/engine/upload_queue.hpp>
 
+#include <array>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
 namespace cathedral::engine
 {
     struct renderer_args
     {
-        gfx::swapchain* swapchain = nullptr;
+        gfx::render_target* swapchain = nullptr; // A gfx::swapchain, or a gfx::offscreen_target when headless
+        uint32_t frames_in_flight = 2; // Frames the CPU may record ahead of the GPU, between 1 and 3
+        uint32_t recording_threads = 0; // Threads recording draws into secondary command buffers, 0 records inline
+        uint32_t draws_per_chunk = 128; // Draws per secondary command buffer when recording on threads
+        uint32_t pipeline_compile_threads = 2; // Threads compiling material pipelines, 0 compiles them on creation
+        uint32_t staging_buffer_size = 32 * 1024 * 1024; // Larger uploads are split, at the cost of extra submits
+        texture_streamer_args texture_streaming;
+        uniform_arena_args uniform_arena;
+        geometry_pool_args geometry_pool;
+        descriptor_allocator_args descriptor_allocator; // frames_in_flight is taken from the renderer
+        bool bindless_textures = false; // Requires a context created with descriptor indexing
+        bindless_texture_table_args bindless_texture_table; // frames_in_flight is taken from the renderer
     };
 
     enum class render_cmdbuff_type : uint8_t
@@ -24,16 +53,43 @@ namespace cathedral::engine
         OVERLAY
     };
 
+    constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+
     class renderer
     {
     public:
         explicit renderer(renderer_args args);
 
+        // Waits for the frames in flight, their resources are released with the renderer
+        ~renderer();
+
+        CATHEDRAL_NON_COPYABLE(renderer);
+
         void begin_frame();
         void end_frame();
 
         uint64_t current_frame() const { return _frame_count; }
 
+        uint32_t frames_in_flight() const { return _args.frames_in_flight; }
+
+        // Time begin_frame spent blocked on the GPU finishing the frame that last used the current frame's resources
+        std::chrono::nanoseconds last_frame_fence_wait() const { return _last_frame_fence_wait; }
+
+        // Keeps 'resource' alive until every frame that may have recorded a reference to it has completed on the GPU
+        template <typename T>
+        void retire(T resource)
+        {
+            _retired_resources.emplace_back(_frame_count, std::make_shared<T>(std::move(resource)));
+        }
+
+        // Runs 'func' once every frame that may have recorded a reference to what it releases has completed
+        void defer(std::function<void()> func)
+        {
+            _retired_resources.emplace_back(
+                _frame_count,
+                std::shared_ptr<void>(nullptr, [func = std::move(func)](void*) { func(); }));
+        }
+
         void recreate_swapchain_dependent_resources() const;
 
         const gfx::vulkan_context& vkctx() const { return _args.swapchain->vkctx(); }
@@ -43,29 +99,69 @@ namespace cathedral::engine
         vk::CommandBuffer render_cmdbuff(render_cmdbuff_type type) const
         {
             using enum render_cmdbuff_type;
+            const auto& frame = current_frame_resources();
             switch (type)
             {
             case OPAQUE:
-                return *_render_cmdbuff_opaque;
+                return *frame.render_cmdbuff_opaque;
             case TRANSPARENT:
-                return *_render_cmdbuff_transparent;
+                return *frame.render_cmdbuff_transparent;
             case OVERLAY:
-                return *_render_cmdbuff_overlay;
+                return *frame.render_cmdbuff_overlay;
             }
             std::unreachable();
         }
 
-        const gfx::swapchain& swapchain() const { return *_args.swapchain; }
+        // Records 'command' into the given pass, straight away or on the recording threads at the end of the frame
+        void draw(render_cmdbuff_type type, const draw_command& command);
+
+        bool records_on_threads() const { return _draw_recorder != nullptr; }
+
+        const gfx::render_target& swapchain() const { return *_args.swapchain; }
 
         upload_queue& get_upload_queue() { return *_upload_queue; }
 
+        texture_streamer& get_texture_streamer() { return _texture_streamer; }
+
+        sampler_cache& get_sampler_cache() { return _sampler_cache; }
+
+        sampler_cache_stats sampler_stats() const { return _sampler_cache.stats(); }
+
+        uniform_arena& get_uniform_arena() { return _uniform_arena; }
+
+        geometry_pool& get_geometry_pool() { return _geometry_pool; }
+
+        descriptor_allocator& get_descriptor_allocator() { return _descriptor_allocator; }
+
+        pipeline_cache& get_pipeline_cache() { return _pipeline_cache; }
+
+        pipeline_cache_stats pipeline_stats() const { return _pipeline_cache.stats(); }
+
+        bool compiles_pipelines_on_threads() const { return _pipeline_compiler->thread_count() > 0; }
+
+        pipeline_compiler& get_pipeline_compiler() { return *_pipeline_compiler; }
+
+        // Returns once no worker thread is compiling a pipeline, e.g. before the context's pipeline cache is replaced
+        void wait_pipeline_compiles();
+
+        // Descriptor writes queued here reach the driver together, before the next draw is recorded
+        descriptor_write_batch& descriptor_writes() { return _descriptor_writes; }
+
+        bool bindless_textures() const { return _bindless_textures != nullptr; }
+
+        bindless_texture_table& get_bindless_texture_table() { return *_bindless_textures; }
+
+        const geometry_pool& get_geometry_pool() const { return _geometry_pool; }
+
+        const uniform_arena& get_uniform_arena() const { return _uniform_arena; }
+
         [[nodiscard]] std::shared_ptr<texture> create_color_texture(
             std::string name,
             const ien::image& img,
             uint32_t mip_levels = 8,
             vk::Filter min_filter = vk::Filter::eLinear,
             vk::Filter mag_filter = vk::Filter::eLinear,
-            ien::resize_filter mipgen_filter = ien::resize_filter::BOX,
+            mip_filter mipgen_filter = mip_filter::BOX,
             vk::SamplerAddressMode address_mode = vk::SamplerAddressMode::eRepeat,
             uint32_t anisotropy = 8);
 
@@ -75,12 +171,14 @@ namespace cathedral::engine
             uint32_t mip_levels = 8,
             vk::Filter min_filter = vk::Filter::eLinear,
             vk::Filter mag_filter = vk::Filter::eLinear,
-            ien::resize_filter mipgen_filter = ien::resize_filter::BOX,
+            mip_filter mipgen_filter = mip_filter::BOX,
             vk::SamplerAddressMode address_mode = vk::SamplerAddressMode::eRepeat,
             uint32_t anisotropy = 8);
 
         [[nodiscard]] std::shared_ptr<texture> create_color_texture_from_data(const texture_args_from_data& args);
 
+        [[nodiscard]] std::shared_ptr<texture> create_streamed_texture(texture_args_streamed args);
+
         [[nodiscard]] std::shared_ptr<texture> default_texture() const { return _default_texture; }
 
         auto& materials() { return _materials; }
@@ -93,32 +191,59 @@ namespace cathedral::engine
 
         [[nodiscard]] std::weak_ptr<material> create_material(material_args args);
 
-        const auto& empty_uniform_buffer() const { return _empty_uniform_buffer; }
-
         ien::image capture_screenshot() const;
 
         uint32_t uid() const { return _uid; }
 
     private:
+        struct frame_resources
+        {
+            vk::UniqueFence frame_fence;
+            vk::UniqueSemaphore render_opaque_ready_semaphore;
+            vk::UniqueSemaphore render_transparent_ready_semaphore;
+            vk::UniqueSemaphore render_overlay_ready_semaphore;
+            vk::UniqueSemaphore present_ready_semaphore;
+
+            vk::UniqueCommandBuffer render_cmdbuff_opaque;
+            vk::UniqueCommandBuffer render_cmdbuff_transparent;
+            vk::UniqueCommandBuffer render_cmdbuff_overlay;
+        };
+
         renderer_args _args;
         uint32_t _uid;
 
         uint32_t _swapchain_image_index = 0;
         uint64_t _frame_count = 0;
+        std::chrono::nanoseconds _last_frame_fence_wait{ 0 };
+
+        std::vector<frame_resources> _frames;
+
+        // Declared ahead of the retired resources and materials, which may hand ranges and sets back when destroyed
+        geometry_pool _geometry_pool;
+        descriptor_allocator _descriptor_allocator;
+        pipeline_cache _pipeline_cache;
+        std::unique_ptr<pipeline_compiler> _pipeline_compiler; // Joined before the cache its jobs use goes away
+        descriptor_write_batch _descriptor_writes;
+        std::unique_ptr<bindless_texture_table> _bindless_textures;
+
+        std::deque<std::pair<uint64_t, std::shared_ptr<void>>> _retired_resources;
 
         std::unique_ptr<upload_queue> _upload_queue;
 
-        std::unique_ptr<gfx::depthstencil_attachment> _depth_attachment;
+        std::unique_ptr<draw_recorder> _draw_recorder;
+        std::array<std::vector<draw_command>, 3> _pending_draws;
+        std::array<std::optional<draw_command>, 3> _last_inline_draws;
+        vk::Viewport _viewport;
+        vk::Rect2D _scissor;
+
+        texture_streamer _texture_streamer;
+        gfx::memory_budget_subscription _memory_budget_subscription;
 
-        vk::UniqueFence _frame_fence;
-        vk::UniqueSemaphore _render_opaque_ready_semaphore;
-        vk::UniqueSemaphore _render_transparent_ready_semaphore;
-        vk::UniqueSemaphore _render_overlay_ready_semaphore;
-        vk::UniqueSemaphore _present_ready_semaphore;
+        sampler_cache _sampler_cache;
 
-        vk::UniqueCommandBuffer _render_cmdbuff_opaque;
-        vk::UniqueCommandBuffer _render_cmdbuff_transparent;
-        vk::UniqueCommandBuffer _render_cmdbuff_overlay;
+        uniform_arena _uniform_arena;
+
+        std::unique_ptr<gfx::depthstencil_attachment> _depth_attachment;
 
         std::shared_ptr<texture> _default_texture;
 
@@ -128,18 +253,25 @@ namespace cathedral::engine
 
         std::unordered_map<std::string, std::shared_ptr<material>> _materials;
 
-        std::unique_ptr<gfx::uniform_buffer> _empty_uniform_buffer;
+        frame_resources& current_frame_resources() { return _frames[_frame_count % _frames.size()]; }
+
+        const frame_resources& current_frame_resources() const { return _frames[_frame_count % _frames.size()]; }
+
+        void init_frame_resources();
+
+        void release_retired_resources();
 
         void reload_depthstencil_attachment() const;
 
         void begin_rendercmd();
 
+        void record_pending_draws();
+
         void submit_prerender_cmdbuffs();
         void submit_render_cmdbuff();
         void submit_present();
 
         void init_default_texture();
-        void init_empty_uniform_buffer();
 
         void begin_opaque_pass(glm::ivec2 surf_size);
         void begin_transparent_pass(glm::ivec2 surf_size);
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cathedral/gfx/sampler.hpp>
+
+#include <memory>
+#include <unordered_map>
+
+namespace cathedral::engine
+{
+    struct sampler_cache_stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t sampler_count = 0;
+    };
+
+    // Hands out one shared sampler per distinct sampler_info, textures reference them instead of owning their own
+    class sampler_cache
+    {
+    public:
+        explicit sampler_cache(const gfx::vulkan_context& vkctx);
+
+        std::shared_ptr<gfx::sampler> get(const gfx::sampler_info& info);
+
+        sampler_cache_stats stats() const;
+
+    private:
+        struct info_hash
+        {
+            size_t operator()(const gfx::sampler_info& info) const;
+        };
+
+        const gfx::vulkan_context& _vkctx;
+        std::unordered_map<gfx::sampler_info, std::shared_ptr<gfx::sampler>, info_hash> _samplers;
+        uint64_t _hits = 0;
+        uint64_t _misses = 0;
+    };
+} // namespace cathedral::engine
@@ -99,12 +99,13 @@ layout(set = 0, binding = 0) uniform _scene_uniform_data_ {
         CATHEDRAL_NON_COPYABLE(scene);
         CATHEDRAL_DEFAULT_MOVABLE(scene);
 
-        const gfx::uniform_buffer& uniform_buffer() const { return *_uniform_buffer; }
-
         renderer& get_renderer() const { return *_args.prenderer; }
 
         vk::DescriptorSet descriptor_set() const;
 
+        // Dynamic offset of this frame's scene uniform data in the renderer's uniform arena
+        uint32_t uniform_offset() const { return _uniform_offset; }
+
         void tick(const std::function<void(double deltatime)>&);
 
         template <typename T>
@@ -137,6 +138,8 @@ layout(set = 0, binding = 0) uniform _scene_uniform_data_ {
 
         void update_uniform(const std::function<void(scene_uniform_data&)>& func);
 
+        const scene_uniform_data& uniform_data() const { return _scene_uniform_data; }
+
         std::shared_ptr<mesh_buffer> get_mesh_buffers(const std::string& mesh_path, const mesh& mesh);
 
         static gfx::pipeline_descriptor_set descriptor_set_definition();
@@ -158,10 +161,9 @@ layout(set = 0, binding = 0) uniform _scene_uniform_data_ {
 
     private:
         scene_args _args;
-        std::unique_ptr<gfx::uniform_buffer> _uniform_buffer;
-        vk::UniqueDescriptorSetLayout _scene_descriptor_set_layout;
-        vk::UniqueDescriptorSet _scene_descriptor_set;
+        pooled_descriptor_set _scene_descriptor_set;
         scene_uniform_data _scene_uniform_data;
+        uint32_t _uniform_offset = 0;
         uint32_t _used_point_lights = 0;
         bool _in_editor = false;
         double _last_deltatime = 0;
@@ -172,7 +174,6 @@ layout(set = 0, binding = 0) uniform _scene_uniform_data_ {
 
         mesh_buffer_storage _mesh_buffer_storage;
 
-        void init_descriptor_set_layout();
         void init_descriptor_set();
 
         void reload_tree_parenting() const;
@@ -31,5 +31,9 @@ namespace cathedral::engine
 
     std::expected<shader_preprocess_data, std::string> get_shader_preprocess_data(std::string_view source);
 
-    std::expected<std::string, std::string> preprocess_shader(gfx::shader_type type, const shader_preprocess_data& pp_data);
+    // With 'bindless_textures', texture variables are looked up in the bindless texture table by their pushed indices
+    std::expected<std::string, std::string> preprocess_shader(
+        gfx::shader_type type,
+        const shader_preprocess_data& pp_data,
+        bool bindless_textures = false);
 } // namespace cathedral::engine
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <cathedral/engine/texture_compression.hpp>
 #include <cathedral/engine/texture_format.hpp>
+#include <cathedral/engine/texture_mip.hpp>
 
 #include <cathedral/gfx/image.hpp>
 #include <cathedral/gfx/sampler.hpp>
@@ -10,10 +11,12 @@
 
 #include <glm/vec2.hpp>
 
+#include <functional>
 #include <memory>
 
 namespace cathedral::engine
 {
+    class sampler_cache;
     class upload_queue;
 
     constexpr uint32_t calc_texture_size(const uint32_t width, const uint32_t height, const texture_format format)
@@ -35,15 +38,14 @@ namespace cathedral::engine
 
         case texture_format::DXT1_BC1_SRGB:
         case texture_format::DXT1_BC1_LINEAR:
-            CRITICAL_CHECK(ien::is_power_of_2(width), "DXT1/5 textures must have power of 2 dimensions");
-            CRITICAL_CHECK(ien::is_power_of_2(height), "DXT1/5 textures must have power of 2 dimensions");
-            return (width * height) / 2; // ((WxH) / 16) * 8
-
         case texture_format::DXT5_BC3_SRGB:
         case texture_format::DXT5_BC3_LINEAR:
-            CRITICAL_CHECK(ien::is_power_of_2(width), "DXT1/5 textures must have power of 2 dimensions");
-            CRITICAL_CHECK(ien::is_power_of_2(height), "DXT1/5 textures must have power of 2 dimensions");
-            return width * height; // ((WxH) / 16) * 16
+        case texture_format::RGTC1_BC4_LINEAR:
+        case texture_format::RGTC2_BC5_LINEAR:
+        case texture_format::BPTC_BC7_SRGB:
+        case texture_format::BPTC_BC7_LINEAR:
+            // Edge blocks are padded, so any dimensions are valid
+            return calc_compressed_texture_size(width, height, get_format_compression_type(format));
         default:
             CRITICAL_ERROR("Unhandled texture format");
         }
@@ -56,7 +58,7 @@ namespace cathedral::engine
         gfx::sampler_info sampler_info;
         uint32_t request_mipmap_levels = 1;
         vk::ImageAspectFlagBits image_aspect_flags = vk::ImageAspectFlagBits::eColor;
-        ien::resize_filter mipgen_filter = ien::resize_filter::DEFAULT;
+        mip_filter mipgen_filter = mip_filter::BOX;
         texture_format format = texture_format::R8G8B8A8_SRGB;
         std::optional<std::string> path = std::nullopt;
     };
@@ -71,13 +73,35 @@ namespace cathedral::engine
         texture_format format = texture_format::R8G8B8A8_LINEAR;
     };
 
+    // Writes the data of a single mip, as laid out for upload, into 'dst' (sized to fit it exactly)
+    using texture_mip_loader = std::function<void(uint32_t mip_index, std::span<std::byte> dst)>;
+
+    struct texture_args_streamed
+    {
+        std::string name;
+        gfx::sampler_info sampler_info;
+        std::vector<glm::uvec2> mip_sizes;
+        texture_mip_loader mip_loader;
+        uint32_t min_resident_dimension = 64; // Mips up to this size are always resident
+        vk::ImageAspectFlagBits image_aspect_flags = vk::ImageAspectFlagBits::eColor;
+        texture_format format = texture_format::R8G8B8A8_LINEAR;
+    };
+
+    // Old GPU resources of a streamed texture, they have to outlive any command buffer that references them
+    struct texture_residency_change
+    {
+        std::unique_ptr<gfx::image> image;
+        vk::UniqueImageView imageview;
+    };
+
     constexpr auto DEFAULT_TEXTURE_NAME = "__cathedral__default__texture__";
 
     class texture
     {
     public:
-        texture(texture_args_from_path args, upload_queue& queue);
-        texture(texture_args_from_data args, upload_queue& queue);
+        texture(texture_args_from_path args, upload_queue& queue, sampler_cache& samplers);
+        texture(texture_args_from_data args, upload_queue& queue, sampler_cache& samplers);
+        texture(texture_args_streamed args, upload_queue& queue, sampler_cache& samplers);
 
         const gfx::sampler& sampler() const { return *_sampler; }
 
@@ -89,12 +113,40 @@ namespace cathedral::engine
 
         const std::optional<std::string>& path() const { return _path; }
 
+        // Bumped every time the image view changes, descriptors holding an older one must be rewritten
+        uint32_t imageview_generation() const { return _imageview_generation; }
+
+        bool is_streamed() const { return static_cast<bool>(_mip_loader); }
+
+        // Streamed textures only keep mips [resident_base_mip(), mip_count()) in memory
+        uint32_t mip_count() const { return static_cast<uint32_t>(_mip_sizes.size()); }
+
+        uint32_t resident_base_mip() const { return _resident_base_mip; }
+
+        uint32_t min_resident_base_mip() const { return _min_resident_base_mip; }
+
+        const auto& mip_sizes() const { return _mip_sizes; }
+
+        size_t mip_size_bytes(uint32_t mip_index) const;
+
+        size_t resident_size_bytes() const;
+
+        [[nodiscard]] texture_residency_change set_resident_base_mip(uint32_t base_mip, upload_queue& queue);
+
     private:
         std::string _name;
         std::unique_ptr<gfx::image> _image;
         vk::UniqueImageView _imageview;
-        std::unique_ptr<gfx::sampler> _sampler;
+        std::shared_ptr<gfx::sampler> _sampler;
         std::optional<std::string> _path;
+        uint32_t _imageview_generation = 0;
+
+        texture_format _format = texture_format::R8G8B8A8_LINEAR;
+        vk::ImageAspectFlagBits _image_aspect_flags = vk::ImageAspectFlagBits::eColor;
+        std::vector<glm::uvec2> _mip_sizes;
+        texture_mip_loader _mip_loader;
+        uint32_t _resident_base_mip = 0;
+        uint32_t _min_resident_base_mip = 0;
 
         void init_vkimage(
             const gfx::vulkan_context& vkctx,
@@ -102,14 +154,14 @@ namespace cathedral::engine
             uint32_t width,
             uint32_t height,
             texture_format format,
-            uint32_t req_mipmap_levels);
+            uint32_t req_mipmap_levels,
+            bool allow_transfer_src = false);
+
+        void init_resident_image(uint32_t base_mip, const gfx::image* previous, upload_queue& queue);
 
         void init_vkimageview(
             const gfx::vulkan_context& vkctx,
             texture_format format,
             vk::ImageAspectFlagBits image_aspect_flags);
-        
-        void transition_all_mips_to_transferdst(upload_queue& queue) const;
-        void transition_all_mips_to_shader_readonly(upload_queue& queue) const;
     };
 } // namespace cathedral::engine
\ No newline at end of file
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cathedral/core.hpp>
+
 #include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -14,13 +17,100 @@ namespace cathedral::engine
     enum class texture_compression_type : uint8_t
     {
         DXT1_BC1,
-        DXT5_BC3
+        DXT5_BC3,
+        RGTC1_BC4,
+        RGTC2_BC5,
+        BPTC_BC7
+    };
+
+    // How many BC7 modes and partitions the encoder tries per block. Deeper searches are slower but better
+    enum class bc7_search_depth : uint8_t
+    {
+        FAST, // Mode 6 only
+        NORMAL, // Modes 5 and 6, plus the best few partitions of the two-subset modes
+        EXHAUSTIVE // Every mode and partition
     };
 
+    constexpr uint32_t get_texture_compression_block_size(const texture_compression_type type)
+    {
+        switch (type)
+        {
+        case texture_compression_type::DXT1_BC1:
+        case texture_compression_type::RGTC1_BC4:
+            return 8;
+        case texture_compression_type::DXT5_BC3:
+        case texture_compression_type::RGTC2_BC5:
+        case texture_compression_type::BPTC_BC7:
+            return 16;
+        default:
+            CRITICAL_ERROR("Unhandled texture compression type");
+        }
+    }
+
+    // Bytes per pixel of the uncompressed data a compression type consumes and produces
+    // (RGBA for BC1/BC3/BC7, R for BC4, RG for BC5)
+    constexpr uint32_t get_texture_compression_pixel_size(const texture_compression_type type)
+    {
+        switch (type)
+        {
+        case texture_compression_type::DXT1_BC1:
+        case texture_compression_type::DXT5_BC3:
+        case texture_compression_type::BPTC_BC7:
+            return 4;
+        case texture_compression_type::RGTC1_BC4:
+            return 1;
+        case texture_compression_type::RGTC2_BC5:
+            return 2;
+        default:
+            CRITICAL_ERROR("Unhandled texture compression type");
+        }
+    }
+
+    // Blocks needed to cover 'pixels'. The last block of a row or column is padded when it overhangs the image.
+    constexpr uint32_t get_texture_compression_block_count(const uint32_t pixels)
+    {
+        return (pixels + 3) / 4;
+    }
+
+    constexpr uint32_t calc_compressed_texture_size(
+        const uint32_t width,
+        const uint32_t height,
+        const texture_compression_type type)
+    {
+        return get_texture_compression_block_count(width) * get_texture_compression_block_count(height) *
+               get_texture_compression_block_size(type);
+    }
+
     [[nodiscard]] std::vector<std::byte> create_compressed_texture_data(
         const std::string& image_path,
-        texture_compression_type type);
+        texture_compression_type type,
+        bc7_search_depth bc7_depth = bc7_search_depth::NORMAL);
     [[nodiscard]] std::vector<std::byte> create_compressed_texture_data(
         const ien::image& image,
-        texture_compression_type type);
+        texture_compression_type type,
+        bc7_search_depth bc7_depth = bc7_search_depth::NORMAL);
+
+    // Compresses 'image' into 'dst', which must be exactly as large as the compressed texture
+    // (see calc_compressed_texture_size). Any dimensions are accepted, edge blocks replicate the
+    // last row/column. Block rows are encoded in parallel.
+    void create_compressed_texture_data(
+        const ien::image& image,
+        texture_compression_type type,
+        std::span<std::byte> dst,
+        bc7_search_depth bc7_depth = bc7_search_depth::NORMAL);
+
+    // Same as above for raw pixels, e.g. a level of a mip_chain
+    [[nodiscard]] std::vector<std::byte> create_compressed_texture_data(
+        std::span<const std::byte> pixels,
+        uint32_t width,
+        uint32_t height,
+        texture_compression_type type,
+        bc7_search_depth bc7_depth = bc7_search_depth::NORMAL);
+    void create_compressed_texture_data(
+        std::span<const std::byte> pixels,
+        uint32_t width,
+        uint32_t height,
+        texture_compression_type type,
+        std::span<std::byte> dst,
+        bc7_search_depth bc7_depth = bc7_search_depth::NORMAL);
 } // namespace cathedral::engine
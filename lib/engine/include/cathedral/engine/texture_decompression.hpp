@@ -9,13 +9,33 @@ namespace cathedral::engine
 {
     namespace detail
     {
+        enum class texture_decompression_isa : uint8_t
+        {
+            SCALAR,
+            SSE2,
+            AVX2
+        };
+
+        bool is_texture_decompression_isa_supported(texture_decompression_isa isa);
+        texture_decompression_isa get_best_texture_decompression_isa();
+
+        // Decodes using the best instruction set available on the running CPU
         void decompress_texture_data(
             const std::byte* src_data,
             uint32_t image_width,
             uint32_t image_height,
             texture_compression_type type,
             std::byte* dst_data);
-    }
+
+        // SCALAR is the reference implementation, the others must produce identical output
+        void decompress_texture_data(
+            const std::byte* src_data,
+            uint32_t image_width,
+            uint32_t image_height,
+            texture_compression_type type,
+            std::byte* dst_data,
+            texture_decompression_isa isa);
+    } // namespace detail
 
     template <typename TVectorAllocator = std::vector<std::byte>::allocator_type>
     std::vector<std::byte, TVectorAllocator> decompress_texture_data(
@@ -24,7 +44,8 @@ namespace cathedral::engine
         const uint32_t image_height,
         const texture_compression_type type)
     {
-        std::vector<std::byte, TVectorAllocator> result(image_width * image_height * 4);
+        std::vector<std::byte, TVectorAllocator> result(
+            image_width * image_height * get_texture_compression_pixel_size(type));
         detail::decompress_texture_data(data, image_width, image_height, type, result.data());
         return result;
     }
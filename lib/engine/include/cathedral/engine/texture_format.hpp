@@ -21,7 +21,13 @@ namespace cathedral::engine
         DXT5_BC3_SRGB,
 
         DXT1_BC1_LINEAR,
-        DXT5_BC3_LINEAR
+        DXT5_BC3_LINEAR,
+
+        RGTC1_BC4_LINEAR,
+        RGTC2_BC5_LINEAR,
+
+        BPTC_BC7_SRGB,
+        BPTC_BC7_LINEAR
     };
 
     constexpr bool is_compressed_format(const texture_format fmt)
@@ -32,6 +38,10 @@ namespace cathedral::engine
         case texture_format::DXT5_BC3_LINEAR:
         case texture_format::DXT1_BC1_SRGB:
         case texture_format::DXT5_BC3_SRGB:
+        case texture_format::RGTC1_BC4_LINEAR:
+        case texture_format::RGTC2_BC5_LINEAR:
+        case texture_format::BPTC_BC7_SRGB:
+        case texture_format::BPTC_BC7_LINEAR:
             return true;
         default:
             return false;
@@ -48,6 +58,13 @@ namespace cathedral::engine
         case texture_format::DXT5_BC3_SRGB:
         case texture_format::DXT5_BC3_LINEAR:
             return texture_compression_type::DXT5_BC3;
+        case texture_format::RGTC1_BC4_LINEAR:
+            return texture_compression_type::RGTC1_BC4;
+        case texture_format::RGTC2_BC5_LINEAR:
+            return texture_compression_type::RGTC2_BC5;
+        case texture_format::BPTC_BC7_SRGB:
+        case texture_format::BPTC_BC7_LINEAR:
+            return texture_compression_type::BPTC_BC7;
         default:
             CRITICAL_ERROR("Unhandled compressed format");
         }
@@ -64,6 +81,7 @@ namespace cathedral::engine
         case R8_SRGB:
         case DXT1_BC1_SRGB:
         case DXT5_BC3_SRGB:
+        case BPTC_BC7_SRGB:
             return false;
 
         case R8G8B8A8_LINEAR:
@@ -72,6 +90,9 @@ namespace cathedral::engine
         case R8_LINEAR:
         case DXT1_BC1_LINEAR:
         case DXT5_BC3_LINEAR:
+        case RGTC1_BC4_LINEAR:
+        case RGTC2_BC5_LINEAR:
+        case BPTC_BC7_LINEAR:
             return true;
         }
         CRITICAL_ERROR("Unhandled texture format");
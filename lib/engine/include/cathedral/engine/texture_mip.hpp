@@ -1,8 +1,9 @@
 #pragma once
 
-#include <ien/image/resize_filter.hpp>
+#include <cathedral/core.hpp>
 
 #include <cstdint>
+#include <span>
 #include <vector>
 
 namespace ien
@@ -12,9 +13,60 @@ namespace ien
 
 namespace cathedral::engine
 {
-    [[nodiscard]] ien::image create_image_mip(const ien::image& source, ien::resize_filter filter);
-    [[nodiscard]] std::vector<ien::image> create_image_mips(
+    enum class mip_filter : uint8_t
+    {
+        BOX, // 2x2 average, the fastest
+        KAISER, // Kaiser windowed sinc, sharp with little ringing
+        LANCZOS3 // Lanczos windowed sinc, the sharpest
+    };
+
+    struct mip_level
+    {
+        uint32_t width;
+        uint32_t height;
+        size_t offset;
+        size_t size;
+    };
+
+    // Every generated level (mip 1 onwards) of an image, stored back to back in a single allocation
+    class mip_chain
+    {
+    public:
+        mip_chain(uint32_t source_width, uint32_t source_height, uint32_t pixel_size, uint32_t mip_count);
+
+        uint32_t pixel_size() const { return _pixel_size; }
+
+        size_t level_count() const { return _levels.size(); }
+
+        const mip_level& level(const size_t index) const { return _levels[index]; }
+
+        const auto& levels() const { return _levels; }
+
+        std::span<const std::byte> level_data(const size_t index) const
+        {
+            return { _data.data() + _levels[index].offset, _levels[index].size };
+        }
+
+        std::span<std::byte> level_data(const size_t index)
+        {
+            return { _data.data() + _levels[index].offset, _levels[index].size };
+        }
+
+        std::span<const std::byte> data() const { return _data; }
+
+    private:
+        uint32_t _pixel_size;
+        std::vector<mip_level> _levels;
+        aligned_vector<std::byte, 16> _data;
+    };
+
+    // Generates 'mip_count' levels below 'source' (fewer if the chain reaches 1x1 first).
+    // BOX builds every level of a tile in a single pass while it is still in cache; the windowed sinc
+    // filters are separable and build each level from the previous one. Both run in parallel.
+    // With 'srgb' set, color channels are filtered in linear light; alpha is always treated as linear.
+    [[nodiscard]] mip_chain create_image_mips(
         const ien::image& source,
-        ien::resize_filter filter,
-        uint32_t mip_count);
-} // namespace cathedral::engine
\ No newline at end of file
+        mip_filter filter,
+        uint32_t mip_count,
+        bool srgb = false);
+} // namespace cathedral::engine
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cathedral/engine/texture.hpp>
+
+#include <cathedral/gfx/memory_tracker.hpp>
+
+#include <deque>
+#include <limits>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cathedral::engine
+{
+    class upload_queue;
+
+    struct texture_streamer_args
+    {
+        size_t vram_budget = 512ULL * 1024 * 1024;
+        uint32_t eviction_delay_frames = 120; // Unused textures become eviction candidates after this many frames
+        uint32_t max_upgrades_per_frame = 4;
+    };
+
+    // Mip that gives roughly one texel per pixel for a texture covering 'projected_size' pixels on screen
+    uint32_t calc_texture_streaming_mip(glm::uvec2 texture_size, float projected_size, uint32_t mip_count);
+
+    // Streaming budget after a device local heap budget event. While the heap is over budget it is what the heap has
+    // left below the threshold once everything else is counted, capped to the configured budget. Once the heap is back
+    // under budget it is the configured budget again
+    size_t calc_texture_streaming_budget(
+        const gfx::memory_budget_event& event,
+        size_t configured_budget,
+        size_t resident_size);
+
+    // What the streaming policy sees of a streamed texture
+    struct texture_streaming_state
+    {
+        uint32_t resident_base_mip = 0;
+        uint32_t min_resident_base_mip = 0; // Mips from this one on are always resident
+        uint32_t target_mip = 0;
+        uint64_t last_used_frame = 0;
+        std::span<const size_t> mip_bytes;
+    };
+
+    struct texture_streaming_change
+    {
+        size_t texture_index = 0;
+        uint32_t base_mip = 0;
+    };
+
+    // Evictions that bring 'resident_size' within 'budget'. Least recently used textures give back the mips above
+    // their target first
+    std::vector<texture_streaming_change> plan_texture_evictions(
+        std::span<const texture_streaming_state> textures,
+        size_t resident_size,
+        size_t budget);
+
+    // One mip upgrades towards the target mips that fit in 'budget', most recently used and furthest from their target
+    // first
+    std::vector<texture_streaming_change> plan_texture_upgrades(
+        std::span<const texture_streaming_state> textures,
+        size_t resident_size,
+        size_t budget,
+        uint32_t max_upgrades);
+
+    // Keeps the resident mips of streamed textures in line with how large they are on screen. Textures start with
+    // their smallest mips and are upgraded one mip per frame towards the requested one. When resident memory goes over
+    // the budget, the top mips of the least recently used textures are evicted first.
+    class texture_streamer
+    {
+    public:
+        explicit texture_streamer(texture_streamer_args args = {}, uint32_t frames_in_flight = 1);
+
+        void add_texture(const std::shared_ptr<texture>& tex);
+
+        // Called for every use of a texture during a frame, the finest mip requested within a frame wins
+        void request_mip(const texture& tex, uint32_t mip_index);
+
+        // Applies residency changes, replaced images are kept until no frame in flight can reference them
+        void update(upload_queue& queue, uint64_t frame);
+
+        size_t vram_budget() const { return _args.vram_budget; }
+
+        void set_vram_budget(size_t budget) { _args.vram_budget = budget; }
+
+        size_t resident_size_bytes() const { return _resident_size; }
+
+    private:
+        struct entry
+        {
+            std::weak_ptr<texture> tex;
+            uint32_t requested_mip = std::numeric_limits<uint32_t>::max();
+            uint32_t target_mip = std::numeric_limits<uint32_t>::max();
+            uint64_t last_used_frame = 0;
+            std::vector<size_t> mip_bytes;
+        };
+
+        texture_streamer_args _args;
+        uint32_t _frames_in_flight;
+        std::unordered_map<const texture*, entry> _entries;
+        std::deque<std::pair<uint64_t, texture_residency_change>> _retired;
+        size_t _resident_size = 0;
+
+        void change_residency(texture& tex, uint32_t base_mip, upload_queue& queue, uint64_t frame);
+    };
+} // namespace cathedral::engine
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cathedral/gfx/buffers/uniform_buffer.hpp>
+
+#include <cathedral/engine/descriptor_allocator.hpp>
+
+#include <memory>
+#include <span>
+
+namespace cathedral::engine
+{
+    struct uniform_arena_args
+    {
+        uint32_t frame_size = 4 * 1024 * 1024;
+        uint32_t frame_count = 3; // Regions are reused after this many frames, at least the frames in flight
+    };
+
+    // Host visible, persistently mapped uniform memory with one region per frame. Per-frame uniforms are written straight
+    // into it and bound through dynamic offsets, so they never go through the upload queue
+    class uniform_arena
+    {
+    public:
+        // Descriptor range for uniform blocks with no data, bound at offset 0
+        static constexpr uint32_t EMPTY_BLOCK_RANGE = 16;
+
+        uniform_arena(const gfx::vulkan_context& vkctx, uniform_arena_args args = {});
+
+        // Moves on to the next frame's region, the GPU must be done with the frame that used it last
+        void begin_frame();
+
+        // Copies 'data' into the current frame's region and returns the dynamic offset to bind it with
+        uint32_t write(std::span<const std::byte> data);
+
+        template <typename T>
+        uint32_t write(const T& value)
+        {
+            return write(std::span<const std::byte>(reinterpret_cast<const std::byte*>(&value), sizeof(T)));
+        }
+
+        // Queues pointing binding 'binding' of 'set' at the arena, for a uniform block of 'block_size' bytes (0 if none)
+        void write_descriptor(
+            descriptor_write_batch& batch,
+            vk::DescriptorSet set,
+            uint32_t binding,
+            uint32_t block_size) const;
+
+        vk::Buffer buffer() const { return _buffer->buffer(); }
+
+        uint32_t frame_used_bytes() const { return _offset; }
+
+    private:
+        const gfx::vulkan_context& _vkctx;
+        uniform_arena_args _args;
+        uint32_t _alignment = 0;
+        std::unique_ptr<gfx::uniform_buffer> _buffer;
+        uint32_t _frame_index = 0;
+        uint32_t _offset = 0;
+    };
+} // namespace cathedral::engine
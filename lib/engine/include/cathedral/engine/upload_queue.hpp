@@ -2,9 +2,14 @@
 
 #include <cathedral/gfx/buffers.hpp>
 
+#include <cathedral/engine/buffer_copy_list.hpp>
+
 #include <cathedral/core.hpp>
 
+#include <functional>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 FORWARD_CLASS(cathedral::gfx, vulkan_context);
 FORWARD_CLASS(cathedral::gfx, image);
@@ -19,10 +24,26 @@ namespace cathedral::engine
         SUBMITTED
     };
 
+    struct upload_queue_stats
+    {
+        uint64_t overflow_bytes = 0;  // Staged outside of the ring because the frame's region was full
+        uint64_t overflow_blocks = 0; // Overflow staging buffers allocated
+        uint64_t stalls = 0;          // Times recording had to wait for the GPU to release a frame's region
+        uint64_t handoffs = 0;        // Submits in the middle of a frame, made by split uploads that hit the overflow cap
+    };
+
+    struct upload_queue_frame_stats
+    {
+        uint32_t copy_commands = 0; // Buffer and image copy commands
+        uint32_t copy_regions = 0;
+        uint32_t barriers = 0;
+    };
+
     class upload_queue
     {
     public:
-        upload_queue(const gfx::vulkan_context& vkctx, uint32_t staging_buff_size);
+        // The staging ring is split in 'frame_count' regions, one per frame in flight
+        upload_queue(const gfx::vulkan_context& vkctx, uint32_t staging_buff_size, uint32_t frame_count = 1);
 
         void update_buffer(const gfx::index_buffer& target_buffer, uint32_t target_offset, std::span<const std::byte> data);
         void update_buffer(const gfx::uniform_buffer& target_buffer, uint32_t target_offset, std::span<const std::byte> data);
@@ -65,38 +86,132 @@ namespace cathedral::engine
                 std::span<const std::byte>(reinterpret_cast<const std::byte*>(data.data()), data.size_bytes()));
         }
 
+        // Image uploads are bracketed by these. With a dedicated transfer queue they are recorded there, and ownership
+        // of the image moves to the graphics queue when the upload ends
+        void begin_image_upload(const gfx::image& target_image);
+        void end_image_upload(const gfx::image& target_image);
+
         void update_image(const gfx::image& target_image, std::span<const std::byte> data, uint32_t mip_level);
 
+        // Lets 'fill' write the 'size' bytes of the mip straight into staging memory
+        void update_image(
+            const gfx::image& target_image,
+            size_t size,
+            uint32_t mip_level,
+            const std::function<void(std::span<std::byte>)>& fill);
+
         void record(const std::function<void(vk::CommandBuffer)>& fn);
 
+        // Records on the graphics queue once the images uploaded so far are owned by it. Without a dedicated transfer
+        // queue that is right away, otherwise right after the acquire barriers of their transfer submission
+        void record_after_transfers(std::function<void(vk::CommandBuffer)> fn);
+
         void prepare_to_submit();
         void notify_submitted();
         void notify_fence_waited();
 
         const gfx::vulkan_context& vkctx() const { return _vkctx; }
 
-        vk::CommandBuffer get_cmdbuff() const { return *_cmdbuff; }
+        vk::CommandBuffer get_cmdbuff() const { return *current_frame().cmdbuff; }
+
+        vk::Fence get_fence() const { return *current_frame().fence; }
+
+        bool fence_needs_waiting() const { return current_frame().fence_needs_wait; }
+
+        const upload_queue_stats& stats() const { return _stats; }
 
-        vk::Fence get_fence() const { return *_fence; }
+        // Counters of the last submitted frame
+        const upload_queue_frame_stats& last_frame_stats() const { return _last_frame_stats; }
 
-        bool fence_needs_waiting() const { return _fence_needs_wait; }
+        bool uses_transfer_queue() const;
+
+        vk::Semaphore transfer_timeline() const { return *_transfer_timeline; }
+
+        // Value of transfer_timeline() the pending graphics submission has to wait for, 0 when nothing was transferred
+        uint64_t transfer_wait_value() const { return _transfer_wait_value; }
 
     private:
+        struct staging_allocation
+        {
+            vk::Buffer buffer;
+            std::byte* data = nullptr;
+            uint32_t offset = 0;
+        };
+
+        struct frame_data
+        {
+            vk::UniqueCommandBuffer cmdbuff;
+            vk::UniqueFence fence;
+            bool fence_needs_wait = true;
+            std::vector<std::unique_ptr<gfx::staging_buffer>> overflow_blocks;
+            size_t overflow_size = 0;
+
+            vk::UniqueCommandBuffer transfer_cmdbuff;
+            bool transfer_recording = false;
+            std::vector<vk::ImageMemoryBarrier2> acquire_barriers; // Recorded on the graphics queue at submit
+            std::vector<std::function<void(vk::CommandBuffer)>> after_transfers;
+        };
+
         const gfx::vulkan_context& _vkctx;
         std::unique_ptr<gfx::staging_buffer> _staging_buffer;
-        vk::UniqueCommandBuffer _cmdbuff;
-        vk::UniqueFence _fence;
+        std::vector<frame_data> _frames;
+        uint32_t _frame_index = 0;
+        uint32_t _region_size = 0;
         upload_queue_state _state = upload_queue_state::READY_TO_RECORD;
-        bool _fence_needs_wait = true;
+        upload_queue_stats _stats;
+        upload_queue_frame_stats _frame_stats;
+        upload_queue_frame_stats _last_frame_stats;
+
+        // Buffer copies are recorded in one batch per destination when flushed
+        std::unordered_map<VkBuffer, buffer_copy_list> _pending_buffer_copies;
+
+        // Filled mips larger than a region are written here before being split, kept to avoid reallocating per mip
+        std::vector<std::byte> _fill_scratch;
+
+        vk::UniqueSemaphore _transfer_timeline;
+        uint64_t _transfer_timeline_value = 0;
+        uint64_t _transfer_wait_value = 0;
+
+        uint32_t _offset = 0;          // Within the current frame's region of the ring
+        uint32_t _overflow_offset = 0; // Within the last overflow block of the current frame
+
+        frame_data& current_frame() { return _frames[_frame_index]; }
+
+        const frame_data& current_frame() const { return _frames[_frame_index]; }
 
-        uint32_t _offset = 0;
+        vk::CommandBuffer cmdbuff() const { return *current_frame().cmdbuff; }
+
+        // Command buffer image uploads are recorded into, starts recording if needed
+        vk::CommandBuffer image_cmdbuff();
+
+        void submit_transfers();
+
+        void flush_buffer_copies();
 
         void update_generic_buffer(
             const gfx::generic_buffer& target_buffer,
             uint32_t target_offset,
             std::span<const std::byte> data);
 
-        void submit_current();
+        void update_image_chunked(const gfx::image& target_image, std::span<const std::byte> data, uint32_t mip_level);
+
+        // Called before staging each piece of a split upload. Once the frame's overflow blocks add up to a region, the
+        // frame is submitted and recording moves on to the next region instead of allocating more overflow
+        void reserve_chunk(size_t size);
+
+        void submit_handoff();
+
+        void record_image_copy(
+            const gfx::image& target_image,
+            const staging_allocation& src,
+            uint32_t mip_level,
+            uint32_t y_offset,
+            uint32_t height);
+
+        staging_allocation allocate_staging(size_t size, uint32_t alignment);
+
+        // Contiguous bytes that can be staged without allocating a new overflow block
+        size_t staging_space_left() const;
 
         void prepare_to_record();
     };
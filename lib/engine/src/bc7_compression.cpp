@@ -0,0 +1,694 @@
+#include <cathedral/engine/bits/bc7.hpp>
+
+#include <cathedral/engine/texture_compression.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+namespace cathedral::engine::bc7
+{
+    namespace
+    {
+        using fcolor = std::array<float, 4>;
+        using endpoint = std::array<uint32_t, 4>;
+
+        // How many of the best-ranked partitions NORMAL search tries for the partitioned modes
+        constexpr uint32_t NORMAL_PARTITION_CANDIDATES = 8;
+
+        struct pixel_block
+        {
+            std::array<std::array<uint8_t, 4>, BLOCK_PIXELS> pixels;
+            bool opaque;
+        };
+
+        struct encoded_block
+        {
+            uint32_t mode = 0;
+            uint32_t partition = 0;
+            std::array<endpoint, MAX_SUBSETS * 2> endpoints = {}; // Quantized, without the p-bit
+            std::array<uint32_t, MAX_SUBSETS * 2> pbits = {};
+            std::array<uint8_t, BLOCK_PIXELS> indices = {};
+            std::array<uint8_t, BLOCK_PIXELS> indices2 = {};
+            uint64_t error = std::numeric_limits<uint64_t>::max();
+        };
+
+        struct subset_pixels
+        {
+            std::array<uint8_t, BLOCK_PIXELS> pixels;
+            uint32_t count = 0;
+        };
+
+        class bit_writer
+        {
+        public:
+            void write(const uint32_t value, const uint32_t bits)
+            {
+                for (uint32_t i = 0; i < bits; ++i, ++_position)
+                {
+                    _data[_position / 8] |= static_cast<uint8_t>(((value >> i) & 1U) << (_position % 8));
+                }
+            }
+
+            const std::array<uint8_t, 16>& data() const { return _data; }
+
+        private:
+            std::array<uint8_t, 16> _data = {};
+            uint32_t _position = 0;
+        };
+
+        std::array<subset_pixels, MAX_SUBSETS> split_subsets(const mode_info& info, const uint32_t partition)
+        {
+            std::array<subset_pixels, MAX_SUBSETS> result = {};
+            for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+            {
+                auto& subset = result[get_subset(info.subsets, partition, i)];
+                subset.pixels[subset.count++] = static_cast<uint8_t>(i);
+            }
+            return result;
+        }
+
+        struct principal_axis
+        {
+            fcolor mean;
+            fcolor direction;
+            float residual; // Variance not explained by the axis, an estimate of the fitting error
+        };
+
+        principal_axis compute_principal_axis(
+            const pixel_block& block,
+            const subset_pixels& subset,
+            const uint32_t first_channel,
+            const uint32_t last_channel)
+        {
+            principal_axis result = {};
+            for (uint32_t i = 0; i < subset.count; ++i)
+            {
+                for (uint32_t c = first_channel; c < last_channel; ++c)
+                {
+                    result.mean[c] += block.pixels[subset.pixels[i]][c];
+                }
+            }
+            for (uint32_t c = first_channel; c < last_channel; ++c)
+            {
+                result.mean[c] /= static_cast<float>(subset.count);
+            }
+
+            std::array<std::array<float, 4>, 4> covariance = {};
+            for (uint32_t i = 0; i < subset.count; ++i)
+            {
+                fcolor delta = {};
+                for (uint32_t c = first_channel; c < last_channel; ++c)
+                {
+                    delta[c] = block.pixels[subset.pixels[i]][c] - result.mean[c];
+                }
+                for (uint32_t a = first_channel; a < last_channel; ++a)
+                {
+                    for (uint32_t b = first_channel; b < last_channel; ++b)
+                    {
+                        covariance[a][b] += delta[a] * delta[b];
+                    }
+                }
+            }
+
+            float trace = 0.0F;
+            for (uint32_t c = first_channel; c < last_channel; ++c)
+            {
+                trace += covariance[c][c];
+                result.direction[c] = 1.0F;
+            }
+
+            // Power iteration converges quickly for the dominant axis of such small point sets
+            float eigenvalue = 0.0F;
+            for (uint32_t iteration = 0; iteration < 8; ++iteration)
+            {
+                fcolor next = {};
+                for (uint32_t a = first_channel; a < last_channel; ++a)
+                {
+                    for (uint32_t b = first_channel; b < last_channel; ++b)
+                    {
+                        next[a] += covariance[a][b] * result.direction[b];
+                    }
+                }
+                float length = 0.0F;
+                for (uint32_t c = first_channel; c < last_channel; ++c)
+                {
+                    length += next[c] * next[c];
+                }
+                length = std::sqrt(length);
+                if (length < 1e-6F)
+                {
+                    break;
+                }
+                eigenvalue = length;
+                for (uint32_t c = first_channel; c < last_channel; ++c)
+                {
+                    result.direction[c] = next[c] / length;
+                }
+            }
+
+            result.residual = std::max(trace - eigenvalue, 0.0F);
+            return result;
+        }
+
+        std::array<fcolor, 2> fit_endpoints(
+            const pixel_block& block,
+            const subset_pixels& subset,
+            const uint32_t first_channel,
+            const uint32_t last_channel)
+        {
+            const auto axis = compute_principal_axis(block, subset, first_channel, last_channel);
+
+            float min_t = std::numeric_limits<float>::max();
+            float max_t = std::numeric_limits<float>::lowest();
+            for (uint32_t i = 0; i < subset.count; ++i)
+            {
+                float t = 0.0F;
+                for (uint32_t c = first_channel; c < last_channel; ++c)
+                {
+                    t += (block.pixels[subset.pixels[i]][c] - axis.mean[c]) * axis.direction[c];
+                }
+                min_t = std::min(min_t, t);
+                max_t = std::max(max_t, t);
+            }
+
+            std::array<fcolor, 2> result = {};
+            for (uint32_t c = first_channel; c < last_channel; ++c)
+            {
+                result[0][c] = std::clamp(axis.mean[c] + (axis.direction[c] * min_t), 0.0F, 255.0F);
+                result[1][c] = std::clamp(axis.mean[c] + (axis.direction[c] * max_t), 0.0F, 255.0F);
+            }
+            return result;
+        }
+
+        // Returns the quantized value whose expansion is closest to 'value'
+        uint32_t quantize_channel(const float value, const uint32_t bits, const int pbit, uint32_t& error)
+        {
+            const uint32_t total_bits = bits + (pbit >= 0 ? 1 : 0);
+            const auto max_value = static_cast<float>((1U << bits) - 1);
+            const auto guess = static_cast<int>(std::lround(value / 255.0F * max_value));
+
+            uint32_t best = 0;
+            error = std::numeric_limits<uint32_t>::max();
+            for (int candidate = guess - 1; candidate <= guess + 1; ++candidate)
+            {
+                if (candidate < 0 || candidate > static_cast<int>(max_value))
+                {
+                    continue;
+                }
+                const auto q = static_cast<uint32_t>(candidate);
+                const uint32_t encoded = pbit >= 0 ? ((q << 1) | static_cast<uint32_t>(pbit)) : q;
+                const float delta = unquantize(encoded, total_bits) - value;
+                const auto candidate_error = static_cast<uint32_t>(delta * delta);
+                if (candidate_error < error)
+                {
+                    error = candidate_error;
+                    best = q;
+                }
+            }
+            return best;
+        }
+
+        uint32_t quantize_endpoint(
+            const mode_info& info,
+            const fcolor& value,
+            const int pbit,
+            const uint32_t first_channel,
+            const uint32_t last_channel,
+            endpoint& result)
+        {
+            uint32_t total_error = 0;
+            for (uint32_t c = first_channel; c < last_channel; ++c)
+            {
+                const uint32_t bits = c < 3 ? info.color_bits : info.alpha_bits;
+                if (bits == 0)
+                {
+                    result[c] = 0;
+                    continue;
+                }
+                uint32_t error = 0;
+                result[c] = quantize_channel(value[c], bits, pbit, error);
+                total_error += error;
+            }
+            return total_error;
+        }
+
+        // Quantizes both endpoints of 'subset' in channels [first_channel, last_channel), choosing the
+        // p-bits that best preserve the unquantized endpoints
+        void quantize_subset(
+            const mode_info& info,
+            const std::array<fcolor, 2>& values,
+            const uint32_t subset,
+            const uint32_t first_channel,
+            const uint32_t last_channel,
+            encoded_block& block)
+        {
+            auto& e0 = block.endpoints[subset * 2];
+            auto& e1 = block.endpoints[(subset * 2) + 1];
+
+            if (info.endpoint_pbits > 0)
+            {
+                for (uint32_t e = 0; e < 2; ++e)
+                {
+                    auto& dst = block.endpoints[(subset * 2) + e];
+                    endpoint candidates[2] = {}; // NOLINT
+                    const uint32_t error0 = quantize_endpoint(info, values[e], 0, first_channel, last_channel, candidates[0]);
+                    const uint32_t error1 = quantize_endpoint(info, values[e], 1, first_channel, last_channel, candidates[1]);
+                    const uint32_t pbit = error1 < error0 ? 1 : 0;
+                    dst = candidates[pbit];
+                    block.pbits[(subset * 2) + e] = pbit;
+                }
+            }
+            else if (info.shared_pbits > 0)
+            {
+                endpoint candidates[2][2] = {}; // NOLINT
+                uint32_t errors[2] = {}; // NOLINT
+                for (uint32_t pbit = 0; pbit < 2; ++pbit)
+                {
+                    const auto p = static_cast<int>(pbit);
+                    errors[pbit] = quantize_endpoint(info, values[0], p, first_channel, last_channel, candidates[pbit][0]) +
+                                   quantize_endpoint(info, values[1], p, first_channel, last_channel, candidates[pbit][1]);
+                }
+                const uint32_t pbit = errors[1] < errors[0] ? 1 : 0;
+                e0 = candidates[pbit][0];
+                e1 = candidates[pbit][1];
+                block.pbits[subset * 2] = pbit;
+                block.pbits[(subset * 2) + 1] = pbit;
+            }
+            else
+            {
+                endpoint q0 = e0;
+                endpoint q1 = e1;
+                quantize_endpoint(info, values[0], -1, first_channel, last_channel, q0);
+                quantize_endpoint(info, values[1], -1, first_channel, last_channel, q1);
+                for (uint32_t c = first_channel; c < last_channel; ++c)
+                {
+                    e0[c] = q0[c];
+                    e1[c] = q1[c];
+                }
+            }
+        }
+
+        std::array<uint8_t, 4> expand_endpoint(const mode_info& info, const encoded_block& block, const uint32_t index)
+        {
+            const bool has_pbit = info.endpoint_pbits > 0 || info.shared_pbits > 0;
+            const auto& value = block.endpoints[index];
+            const uint32_t pbit = block.pbits[index];
+
+            std::array<uint8_t, 4> result = {};
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                const uint32_t bits = c < 3 ? info.color_bits : info.alpha_bits;
+                if (bits == 0)
+                {
+                    result[c] = 0xFF;
+                }
+                else if (has_pbit)
+                {
+                    result[c] = unquantize((value[c] << 1) | pbit, bits + 1);
+                }
+                else
+                {
+                    result[c] = unquantize(value[c], bits);
+                }
+            }
+            return result;
+        }
+
+        // Picks the best index for every pixel of 'subset' in channels [first_channel, last_channel)
+        uint64_t assign_indices(
+            const pixel_block& pixels,
+            const mode_info& info,
+            const subset_pixels& subset,
+            const uint32_t subset_index,
+            const uint32_t index_bits,
+            const uint32_t first_channel,
+            const uint32_t last_channel,
+            encoded_block& block,
+            std::array<uint8_t, BLOCK_PIXELS>& indices)
+        {
+            const auto e0 = expand_endpoint(info, block, subset_index * 2);
+            const auto e1 = expand_endpoint(info, block, (subset_index * 2) + 1);
+            const uint8_t* weights = get_weights(index_bits);
+            const uint32_t weight_count = 1U << index_bits;
+
+            std::array<std::array<uint8_t, 4>, 16> palette = {};
+            for (uint32_t w = 0; w < weight_count; ++w)
+            {
+                for (uint32_t c = first_channel; c < last_channel; ++c)
+                {
+                    palette[w][c] = interpolate(e0[c], e1[c], weights[w]);
+                }
+            }
+
+            uint64_t total_error = 0;
+            for (uint32_t i = 0; i < subset.count; ++i)
+            {
+                const auto& pixel = pixels.pixels[subset.pixels[i]];
+                uint32_t best_error = std::numeric_limits<uint32_t>::max();
+                uint8_t best_index = 0;
+                for (uint32_t w = 0; w < weight_count; ++w)
+                {
+                    uint32_t error = 0;
+                    for (uint32_t c = first_channel; c < last_channel; ++c)
+                    {
+                        const int delta = static_cast<int>(palette[w][c]) - static_cast<int>(pixel[c]);
+                        error += static_cast<uint32_t>(delta * delta);
+                    }
+                    if (error < best_error)
+                    {
+                        best_error = error;
+                        best_index = static_cast<uint8_t>(w);
+                    }
+                }
+                indices[subset.pixels[i]] = best_index;
+                total_error += best_error;
+            }
+            return total_error;
+        }
+
+        // Least squares endpoints for the current index assignment. Returns false when the system is degenerate.
+        bool refine_endpoints(
+            const pixel_block& pixels,
+            const subset_pixels& subset,
+            const std::array<uint8_t, BLOCK_PIXELS>& indices,
+            const uint32_t index_bits,
+            const uint32_t first_channel,
+            const uint32_t last_channel,
+            std::array<fcolor, 2>& result)
+        {
+            const uint8_t* weights = get_weights(index_bits);
+
+            float a = 0.0F;
+            float b = 0.0F;
+            float c = 0.0F;
+            fcolor d0 = {};
+            fcolor d1 = {};
+            for (uint32_t i = 0; i < subset.count; ++i)
+            {
+                const float w = weights[indices[subset.pixels[i]]] / 64.0F;
+                const float iw = 1.0F - w;
+                a += iw * iw;
+                b += iw * w;
+                c += w * w;
+                for (uint32_t ch = first_channel; ch < last_channel; ++ch)
+                {
+                    const float value = pixels.pixels[subset.pixels[i]][ch];
+                    d0[ch] += iw * value;
+                    d1[ch] += w * value;
+                }
+            }
+
+            const float determinant = (a * c) - (b * b);
+            if (std::abs(determinant) < 1e-6F)
+            {
+                return false;
+            }
+
+            for (uint32_t ch = first_channel; ch < last_channel; ++ch)
+            {
+                result[0][ch] = std::clamp(((c * d0[ch]) - (b * d1[ch])) / determinant, 0.0F, 255.0F);
+                result[1][ch] = std::clamp(((a * d1[ch]) - (b * d0[ch])) / determinant, 0.0F, 255.0F);
+            }
+            return true;
+        }
+
+        // Fits one subset in channels [first_channel, last_channel) with 'refinements' least squares passes
+        uint64_t fit_subset(
+            const pixel_block& pixels,
+            const mode_info& info,
+            const subset_pixels& subset,
+            const uint32_t subset_index,
+            const uint32_t index_bits,
+            const uint32_t first_channel,
+            const uint32_t last_channel,
+            const uint32_t refinements,
+            encoded_block& block,
+            std::array<uint8_t, BLOCK_PIXELS>& indices)
+        {
+            auto values = fit_endpoints(pixels, subset, first_channel, last_channel);
+            quantize_subset(info, values, subset_index, first_channel, last_channel, block);
+            uint64_t error =
+                assign_indices(pixels, info, subset, subset_index, index_bits, first_channel, last_channel, block, indices);
+
+            for (uint32_t r = 0; r < refinements && error > 0; ++r)
+            {
+                if (!refine_endpoints(pixels, subset, indices, index_bits, first_channel, last_channel, values))
+                {
+                    break;
+                }
+
+                encoded_block candidate = block;
+                auto candidate_indices = indices;
+                quantize_subset(info, values, subset_index, first_channel, last_channel, candidate);
+                const uint64_t candidate_error = assign_indices(
+                    pixels,
+                    info,
+                    subset,
+                    subset_index,
+                    index_bits,
+                    first_channel,
+                    last_channel,
+                    candidate,
+                    candidate_indices);
+                if (candidate_error >= error)
+                {
+                    break;
+                }
+                block = candidate;
+                indices = candidate_indices;
+                error = candidate_error;
+            }
+            return error;
+        }
+
+        encoded_block fit_mode(
+            const pixel_block& pixels,
+            const uint32_t mode,
+            const uint32_t partition,
+            const uint32_t refinements)
+        {
+            const auto& info = MODES[mode];
+            encoded_block block;
+            block.mode = mode;
+            block.partition = partition;
+            block.error = 0;
+
+            const auto subsets = split_subsets(info, partition);
+            if (info.index2_bits > 0)
+            {
+                // Modes 4 and 5 fit color and alpha independently, each with their own index set
+                block.error += fit_subset(pixels, info, subsets[0], 0, info.index_bits, 0, 3, refinements, block, block.indices);
+                block.error +=
+                    fit_subset(pixels, info, subsets[0], 0, info.index2_bits, 3, 4, refinements, block, block.indices2);
+                return block;
+            }
+
+            const uint32_t channels = info.alpha_bits > 0 ? 4 : 3;
+            for (uint32_t s = 0; s < info.subsets; ++s)
+            {
+                block.error +=
+                    fit_subset(pixels, info, subsets[s], s, info.index_bits, 0, channels, refinements, block, block.indices);
+            }
+            return block;
+        }
+
+        void invert_indices(
+            const mode_info& info,
+            const uint32_t partition,
+            const uint32_t subset,
+            const uint32_t index_bits,
+            std::array<uint8_t, BLOCK_PIXELS>& indices)
+        {
+            const auto max_index = static_cast<uint8_t>((1U << index_bits) - 1);
+            for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+            {
+                if (get_subset(info.subsets, partition, i) == subset)
+                {
+                    indices[i] = max_index - indices[i];
+                }
+            }
+        }
+
+        // Anchor indices are stored without their most significant bit, which must therefore be zero.
+        // Swapping the endpoints of a subset and inverting its indices clears it without changing the result.
+        void fix_anchors(encoded_block& block)
+        {
+            const auto& info = MODES[block.mode];
+            const uint32_t color_channels = info.index2_bits > 0 ? 3 : 4;
+
+            for (uint32_t s = 0; s < info.subsets; ++s)
+            {
+                const uint32_t anchor = get_anchor(info.subsets, block.partition, s);
+                if ((block.indices[anchor] >> (info.index_bits - 1)) == 0)
+                {
+                    continue;
+                }
+                auto& e0 = block.endpoints[s * 2];
+                auto& e1 = block.endpoints[(s * 2) + 1];
+                for (uint32_t c = 0; c < color_channels; ++c)
+                {
+                    std::swap(e0[c], e1[c]);
+                }
+                std::swap(block.pbits[s * 2], block.pbits[(s * 2) + 1]);
+                invert_indices(info, block.partition, s, info.index_bits, block.indices);
+            }
+
+            if (info.index2_bits > 0 && (block.indices2[0] >> (info.index2_bits - 1)) != 0)
+            {
+                std::swap(block.endpoints[0][3], block.endpoints[1][3]);
+                invert_indices(info, block.partition, 0, info.index2_bits, block.indices2);
+            }
+        }
+
+        void write_block(encoded_block block, uint8_t* dst)
+        {
+            fix_anchors(block);
+
+            const auto& info = MODES[block.mode];
+            const uint32_t endpoint_count = info.subsets * 2U;
+
+            bit_writer writer;
+            writer.write(1U << block.mode, block.mode + 1);
+            writer.write(block.partition, info.partition_bits);
+            writer.write(0, info.rotation_bits);
+            writer.write(0, info.index_selection_bits);
+
+            for (uint32_t c = 0; c < 3; ++c)
+            {
+                for (uint32_t e = 0; e < endpoint_count; ++e)
+                {
+                    writer.write(block.endpoints[e][c], info.color_bits);
+                }
+            }
+            for (uint32_t e = 0; e < endpoint_count && info.alpha_bits > 0; ++e)
+            {
+                writer.write(block.endpoints[e][3], info.alpha_bits);
+            }
+
+            if (info.endpoint_pbits > 0)
+            {
+                for (uint32_t e = 0; e < endpoint_count; ++e)
+                {
+                    writer.write(block.pbits[e], 1);
+                }
+            }
+            else if (info.shared_pbits > 0)
+            {
+                for (uint32_t s = 0; s < info.subsets; ++s)
+                {
+                    writer.write(block.pbits[s * 2], 1);
+                }
+            }
+
+            for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+            {
+                const bool anchor = is_anchor(info.subsets, block.partition, i);
+                writer.write(block.indices[i], info.index_bits - (anchor ? 1 : 0));
+            }
+            for (uint32_t i = 0; i < BLOCK_PIXELS && info.index2_bits > 0; ++i)
+            {
+                writer.write(block.indices2[i], info.index2_bits - (i == 0 ? 1 : 0));
+            }
+
+            std::memcpy(dst, writer.data().data(), writer.data().size());
+        }
+
+        // Ranks the two-subset partitions by how well each subset fits a line
+        std::array<uint32_t, PARTITION_COUNT> rank_partitions(const pixel_block& pixels)
+        {
+            const uint32_t channels = pixels.opaque ? 3 : 4;
+
+            std::array<float, PARTITION_COUNT> estimates = {};
+            for (uint32_t p = 0; p < PARTITION_COUNT; ++p)
+            {
+                const auto subsets = split_subsets(MODES[1], p);
+                estimates[p] = compute_principal_axis(pixels, subsets[0], 0, channels).residual +
+                               compute_principal_axis(pixels, subsets[1], 0, channels).residual;
+            }
+
+            std::array<uint32_t, PARTITION_COUNT> result = {};
+            std::iota(result.begin(), result.end(), 0);
+            std::stable_sort(result.begin(), result.end(), [&](const uint32_t lhs, const uint32_t rhs) {
+                return estimates[lhs] < estimates[rhs];
+            });
+            return result;
+        }
+
+        void try_mode(
+            const pixel_block& pixels,
+            const uint32_t mode,
+            const uint32_t partition,
+            const uint32_t refinements,
+            encoded_block& best)
+        {
+            if (best.error == 0)
+            {
+                return;
+            }
+            auto candidate = fit_mode(pixels, mode, partition, refinements);
+            if (candidate.error < best.error)
+            {
+                best = candidate;
+            }
+        }
+    } // namespace
+
+    void compress_block(const uint8_t* rgba_pixels, uint8_t* dst, const bc7_search_depth depth)
+    {
+        pixel_block pixels = {};
+        pixels.opaque = true;
+        for (uint32_t i = 0; i < BLOCK_PIXELS; ++i)
+        {
+            std::memcpy(pixels.pixels[i].data(), rgba_pixels + (i * 4), 4);
+            pixels.opaque = pixels.opaque && pixels.pixels[i][3] == 0xFF;
+        }
+
+        encoded_block best;
+        switch (depth)
+        {
+        case bc7_search_depth::FAST:
+            try_mode(pixels, 6, 0, 1, best);
+            break;
+        case bc7_search_depth::NORMAL: {
+            try_mode(pixels, 6, 0, 1, best);
+            try_mode(pixels, 5, 0, 1, best);
+            const auto ranking = rank_partitions(pixels);
+            for (uint32_t i = 0; i < NORMAL_PARTITION_CANDIDATES; ++i)
+            {
+                if (pixels.opaque)
+                {
+                    try_mode(pixels, 1, ranking[i], 1, best);
+                    try_mode(pixels, 3, ranking[i], 1, best);
+                }
+                else
+                {
+                    try_mode(pixels, 7, ranking[i], 1, best);
+                }
+            }
+            break;
+        }
+        case bc7_search_depth::EXHAUSTIVE:
+            for (uint32_t mode = 0; mode < MODE_COUNT; ++mode)
+            {
+                const auto& info = MODES[mode];
+                if (info.alpha_bits == 0 && !pixels.opaque)
+                {
+                    continue;
+                }
+                const uint32_t partitions = 1U << info.partition_bits;
+                for (uint32_t p = 0; p < partitions; ++p)
+                {
+                    try_mode(pixels, mode, p, 2, best);
+                }
+            }
+            break;
+        }
+
+        write_block(best, dst);
+    }
+} // namespace cathedral::engine::bc7
@@ -0,0 +1,146 @@
+#include <cathedral/engine/bindless_texture_table.hpp>
+
+#include <cathedral/engine/descriptor_allocator.hpp>
+
+#include <cathedral/gfx/vulkan_context.hpp>
+
+#include <algorithm>
+
+namespace cathedral::engine
+{
+    bindless_texture_index::bindless_texture_index(bindless_texture_table* table, const uint32_t index)
+        : _table(table)
+        , _index(index)
+    {
+    }
+
+    bindless_texture_index::~bindless_texture_index()
+    {
+        release();
+    }
+
+    bindless_texture_index::bindless_texture_index(bindless_texture_index&& other) noexcept
+        : _table(std::exchange(other._table, nullptr))
+        , _index(other._index)
+    {
+    }
+
+    bindless_texture_index& bindless_texture_index::operator=(bindless_texture_index&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            _table = std::exchange(other._table, nullptr);
+            _index = other._index;
+        }
+        return *this;
+    }
+
+    void bindless_texture_index::release()
+    {
+        if (_table != nullptr)
+        {
+            _table->release(_index);
+        }
+        _table = nullptr;
+    }
+
+    bindless_texture_table::bindless_texture_table(const gfx::vulkan_context& vkctx, bindless_texture_table_args args)
+        : _vkctx(vkctx)
+        , _args(args)
+        , _capacity(std::min(args.capacity, vkctx.max_sampled_image_descriptors()))
+    {
+        CRITICAL_CHECK(_vkctx.descriptor_indexing_enabled(), "Bindless textures require descriptor indexing");
+        CRITICAL_CHECK(_capacity > 0, "Invalid bindless texture table capacity");
+        CRITICAL_CHECK(_args.frames_in_flight > 0, "Invalid frames in flight count");
+
+        _layout = descriptor_set_definition().definition.create_descriptor_set_layout(_vkctx);
+
+        const vk::DescriptorPoolSize pool_size = { .type = vk::DescriptorType::eCombinedImageSampler,
+                                                   .descriptorCount = _capacity };
+
+        vk::DescriptorPoolCreateInfo pool_info;
+        pool_info.maxSets = 1;
+        pool_info.poolSizeCount = 1;
+        pool_info.pPoolSizes = &pool_size;
+        _pool = _vkctx.device().createDescriptorPoolUnique(pool_info);
+
+        vk::DescriptorSetAllocateInfo alloc_info;
+        alloc_info.descriptorPool = *_pool;
+        alloc_info.descriptorSetCount = 1;
+        alloc_info.pSetLayouts = &*_layout;
+        _set = _vkctx.device().allocateDescriptorSets(alloc_info)[0];
+    }
+
+    void bindless_texture_table::begin_frame(const uint64_t frame)
+    {
+        _frame = frame;
+
+        while (!_pending_free.empty() && _pending_free.front().first + _args.frames_in_flight <= _frame)
+        {
+            _free_slots.push_back(_pending_free.front().second);
+            _pending_free.pop_front();
+        }
+    }
+
+    bindless_texture_index bindless_texture_table::acquire(
+        const vk::ImageView view,
+        const vk::Sampler sampler,
+        descriptor_write_batch& writes)
+    {
+        if (const auto it = _lookup.find({ view, sampler }); it != _lookup.end())
+        {
+            ++_slots[it->second].references;
+            return { this, it->second };
+        }
+
+        uint32_t index = 0;
+        if (!_free_slots.empty())
+        {
+            index = _free_slots.back();
+            _free_slots.pop_back();
+        }
+        else
+        {
+            CRITICAL_CHECK(_slots.size() < _capacity, "Bindless texture table is full");
+            index = static_cast<uint32_t>(_slots.size());
+            _slots.emplace_back();
+        }
+
+        _slots[index] = { .view = view, .sampler = sampler, .references = 1 };
+        _lookup.emplace(std::pair{ view, sampler }, index);
+
+        vk::DescriptorImageInfo info;
+        info.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+        info.imageView = view;
+        info.sampler = sampler;
+        writes.write_images(_set, 0, { info }, index);
+
+        return { this, index };
+    }
+
+    gfx::pipeline_descriptor_set bindless_texture_table::descriptor_set_definition() const
+    {
+        return { .set_index = BINDLESS_TEXTURE_SET_INDEX,
+                 .definition = { { gfx::descriptor_set_entry(
+                     BINDLESS_TEXTURE_SET_INDEX,
+                     0,
+                     gfx::descriptor_type::SAMPLER,
+                     _capacity,
+                     true) } },
+                 .layout = *_layout };
+    }
+
+    void bindless_texture_table::release(const uint32_t index)
+    {
+        auto& released = _slots[index];
+        if (--released.references > 0)
+        {
+            return;
+        }
+
+        // Frames in flight may still sample the slot, so it is only handed out again once they are done
+        _lookup.erase({ released.view, released.sampler });
+        _pending_free.emplace_back(_frame, index);
+    }
+} // namespace cathedral::engine
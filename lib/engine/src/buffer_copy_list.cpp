@@ -0,0 +1,96 @@
+#include <cathedral/engine/buffer_copy_list.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace cathedral::engine
+{
+    void buffer_copy_list::add(
+        const vk::Buffer src,
+        const vk::DeviceSize src_offset,
+        const vk::DeviceSize dst_offset,
+        const vk::DeviceSize size)
+    {
+        if (size == 0)
+        {
+            return;
+        }
+
+        const vk::DeviceSize begin = dst_offset;
+        const vk::DeviceSize end = dst_offset + size;
+
+        // Trim the parts of earlier copies this one overwrites
+        for (size_t i = 0; i < _copies.size();)
+        {
+            const vk::BufferCopy old = _copies[i].region;
+            const vk::DeviceSize old_begin = old.dstOffset;
+            const vk::DeviceSize old_end = old.dstOffset + old.size;
+
+            if (old_end <= begin || old_begin >= end)
+            {
+                ++i;
+                continue;
+            }
+
+            if (old_begin >= begin && old_end <= end)
+            {
+                _copies.erase(_copies.begin() + static_cast<std::ptrdiff_t>(i));
+                continue;
+            }
+
+            if (old_begin < begin && old_end > end)
+            {
+                buffer_copy tail = _copies[i];
+                tail.region.srcOffset = old.srcOffset + (end - old_begin);
+                tail.region.dstOffset = end;
+                tail.region.size = old_end - end;
+                _copies[i].region.size = begin - old_begin;
+                _copies.push_back(tail);
+            }
+            else if (old_begin < begin)
+            {
+                _copies[i].region.size = begin - old_begin;
+            }
+            else
+            {
+                _copies[i].region.srcOffset = old.srcOffset + (end - old_begin);
+                _copies[i].region.dstOffset = end;
+                _copies[i].region.size = old_end - end;
+            }
+            ++i;
+        }
+
+        if (!_copies.empty())
+        {
+            auto& last = _copies.back();
+            if (last.src == src && last.region.srcOffset + last.region.size == src_offset &&
+                last.region.dstOffset + last.region.size == dst_offset)
+            {
+                last.region.size += size;
+                return;
+            }
+        }
+
+        _copies.push_back({ .src = src, .region = vk::BufferCopy{ src_offset, dst_offset, size } });
+    }
+
+    vk::DeviceSize buffer_copy_list::dst_begin() const
+    {
+        vk::DeviceSize result = std::numeric_limits<vk::DeviceSize>::max();
+        for (const auto& copy : _copies)
+        {
+            result = std::min(result, copy.region.dstOffset);
+        }
+        return result;
+    }
+
+    vk::DeviceSize buffer_copy_list::dst_end() const
+    {
+        vk::DeviceSize result = 0;
+        for (const auto& copy : _copies)
+        {
+            result = std::max(result, copy.region.dstOffset + copy.region.size);
+        }
+        return result;
+    }
+} // namespace cathedral::engine
@@ -0,0 +1,250 @@
+#include <cathedral/engine/descriptor_allocator.hpp>
+
+#include <cathedral/gfx/vulkan_context.hpp>
+
+#include <algorithm>
+#include <array>
+#include <format>
+
+namespace cathedral::engine
+{
+    namespace
+    {
+        // Descriptors of each type per set in a pool, sets average a uniform block and a few textures
+        constexpr std::array<std::pair<vk::DescriptorType, uint32_t>, 4> POOL_DESCRIPTORS_PER_SET = {
+            { { vk::DescriptorType::eUniformBufferDynamic, 1 },
+              { vk::DescriptorType::eCombinedImageSampler, 4 },
+              { vk::DescriptorType::eUniformBuffer, 1 },
+              { vk::DescriptorType::eStorageBuffer, 1 } }
+        };
+    } // namespace
+
+    pooled_descriptor_set::pooled_descriptor_set(
+        descriptor_allocator* allocator,
+        const uint32_t layout_id,
+        const vk::DescriptorSet set)
+        : _allocator(allocator)
+        , _layout_id(layout_id)
+        , _set(set)
+    {
+    }
+
+    pooled_descriptor_set::~pooled_descriptor_set()
+    {
+        release();
+    }
+
+    pooled_descriptor_set::pooled_descriptor_set(pooled_descriptor_set&& other) noexcept
+        : _allocator(std::exchange(other._allocator, nullptr))
+        , _layout_id(other._layout_id)
+        , _set(std::exchange(other._set, vk::DescriptorSet{}))
+    {
+    }
+
+    pooled_descriptor_set& pooled_descriptor_set::operator=(pooled_descriptor_set&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            _allocator = std::exchange(other._allocator, nullptr);
+            _layout_id = other._layout_id;
+            _set = std::exchange(other._set, vk::DescriptorSet{});
+        }
+        return *this;
+    }
+
+    void pooled_descriptor_set::release()
+    {
+        if (_allocator != nullptr && _set)
+        {
+            _allocator->recycle(_layout_id, _set);
+        }
+        _allocator = nullptr;
+        _set = vk::DescriptorSet{};
+    }
+
+    descriptor_allocator::descriptor_allocator(const gfx::vulkan_context& vkctx, descriptor_allocator_args args)
+        : _vkctx(vkctx)
+        , _args(args)
+    {
+        CRITICAL_CHECK(_args.sets_per_pool > 0, "Invalid descriptor pool size");
+        CRITICAL_CHECK(_args.frames_in_flight > 0, "Invalid frames in flight count");
+
+        _pools.next_pool_sets = _args.sets_per_pool;
+    }
+
+    void descriptor_allocator::begin_frame(const uint64_t frame)
+    {
+        _frame = frame;
+
+        while (!_pending_recycle.empty() && std::get<0>(_pending_recycle.front()) + _args.frames_in_flight <= _frame)
+        {
+            const auto [released_frame, id, set] = _pending_recycle.front();
+            _layouts[id].free_sets.push_back(set);
+            _pending_recycle.pop_front();
+        }
+    }
+
+    vk::DescriptorSetLayout descriptor_allocator::layout(const gfx::descriptor_set_definition& definition)
+    {
+        return *_layouts[layout_id(definition)].layout;
+    }
+
+    pooled_descriptor_set descriptor_allocator::allocate(const gfx::descriptor_set_definition& definition)
+    {
+        const uint32_t id = layout_id(definition);
+        auto& entry = _layouts[id];
+
+        if (!entry.free_sets.empty())
+        {
+            const vk::DescriptorSet set = entry.free_sets.back();
+            entry.free_sets.pop_back();
+            ++_recycled_sets;
+            return { this, id, set };
+        }
+
+        ++_allocated_sets;
+        return { this, id, allocate_from(_pools, *entry.layout) };
+    }
+
+    descriptor_allocator_stats descriptor_allocator::stats() const
+    {
+        descriptor_allocator_stats result;
+        result.pool_count = _pools.pools.size();
+        result.allocated_sets = _allocated_sets;
+        result.recycled_sets = _recycled_sets;
+        return result;
+    }
+
+    uint32_t descriptor_allocator::layout_id(const gfx::descriptor_set_definition& definition)
+    {
+        std::vector<uint32_t> key;
+        key.reserve(definition.entries.size() * 4);
+        for (const auto& entry : definition.entries)
+        {
+            key.push_back(entry.binding);
+            key.push_back(static_cast<uint32_t>(entry.type));
+            key.push_back(entry.count);
+            key.push_back(entry.partially_bound ? 1 : 0);
+        }
+
+        if (const auto it = _layout_ids.find(key); it != _layout_ids.end())
+        {
+            return it->second;
+        }
+
+        const auto id = static_cast<uint32_t>(_layouts.size());
+        _layouts.push_back({ .layout = definition.create_descriptor_set_layout(_vkctx), .free_sets = {} });
+        _layout_ids.emplace(std::move(key), id);
+        return id;
+    }
+
+    vk::DescriptorSet descriptor_allocator::allocate_from(pool_chain& chain, const vk::DescriptorSetLayout layout)
+    {
+        vk::DescriptorSetAllocateInfo alloc_info;
+        alloc_info.descriptorSetCount = 1;
+        alloc_info.pSetLayouts = &layout;
+
+        while (true)
+        {
+            const bool new_pool = chain.current == chain.pools.size();
+            if (new_pool)
+            {
+                add_pool(chain);
+            }
+
+            alloc_info.descriptorPool = *chain.pools[chain.current];
+
+            vk::DescriptorSet result;
+            switch (const vk::Result alloc_result = _vkctx.device().allocateDescriptorSets(&alloc_info, &result))
+            {
+            case vk::Result::eSuccess:
+                return result;
+            case vk::Result::eErrorOutOfPoolMemory:
+            case vk::Result::eErrorFragmentedPool:
+                // Pools are never freed from, sets are recycled instead, so a full pool stays full
+                CRITICAL_CHECK(!new_pool, "Descriptor set does not fit in an empty pool");
+                ++chain.current;
+                break;
+            default:
+                CRITICAL_ERROR(std::format("Descriptor set allocation failure: {}", std::to_underlying(alloc_result)));
+            }
+        }
+    }
+
+    void descriptor_allocator::add_pool(pool_chain& chain)
+    {
+        const uint32_t sets = chain.next_pool_sets;
+        chain.next_pool_sets = std::min(sets * 2, std::max(_args.max_sets_per_pool, _args.sets_per_pool));
+
+        std::vector<vk::DescriptorPoolSize> pool_sizes;
+        for (const auto& [type, per_set] : POOL_DESCRIPTORS_PER_SET)
+        {
+            pool_sizes.push_back({ .type = type, .descriptorCount = sets * per_set });
+        }
+
+        vk::DescriptorPoolCreateInfo pool_info;
+        pool_info.maxSets = sets;
+        pool_info.poolSizeCount = static_cast<uint32_t>(pool_sizes.size());
+        pool_info.pPoolSizes = pool_sizes.data();
+
+        chain.pools.push_back(_vkctx.device().createDescriptorPoolUnique(pool_info));
+    }
+
+    void descriptor_allocator::recycle(const uint32_t layout_id, const vk::DescriptorSet set)
+    {
+        _pending_recycle.emplace_back(_frame, layout_id, set);
+    }
+
+    void descriptor_write_batch::write_buffer(
+        const vk::DescriptorSet set,
+        const uint32_t binding,
+        const vk::DescriptorType type,
+        const vk::DescriptorBufferInfo& info)
+    {
+        const auto& buffer_info = _buffer_infos.emplace_back(info);
+
+        vk::WriteDescriptorSet write;
+        write.descriptorCount = 1;
+        write.descriptorType = type;
+        write.pBufferInfo = &buffer_info;
+        write.dstArrayElement = 0;
+        write.dstBinding = binding;
+        write.dstSet = set;
+        _writes.push_back(write);
+    }
+
+    void descriptor_write_batch::write_images(
+        const vk::DescriptorSet set,
+        const uint32_t binding,
+        std::vector<vk::DescriptorImageInfo> infos,
+        const uint32_t first_element)
+    {
+        if (infos.empty())
+        {
+            return;
+        }
+
+        const auto& image_infos = _image_infos.emplace_back(std::move(infos));
+
+        vk::WriteDescriptorSet write;
+        write.descriptorCount = static_cast<uint32_t>(image_infos.size());
+        write.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+        write.pImageInfo = image_infos.data();
+        write.dstArrayElement = first_element;
+        write.dstBinding = binding;
+        write.dstSet = set;
+        _writes.push_back(write);
+    }
+
+    void descriptor_write_batch::flush(const gfx::vulkan_context& vkctx)
+    {
+        if (!_writes.empty())
+        {
+            vkctx.device().updateDescriptorSets(_writes, {});
+        }
+        _writes.clear();
+        _buffer_infos.clear();
+        _image_infos.clear();
+    }
+} // namespace cathedral::engine
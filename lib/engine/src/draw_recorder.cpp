@@ -0,0 +1,270 @@
+#include <cathedral/engine/draw_recorder.hpp>
+
+#include <cathedral/gfx/vulkan_context.hpp>
+
+#include <algorithm>
+
+namespace cathedral::engine
+{
+    void record_draw(const vk::CommandBuffer cmdbuff, const draw_command& draw, const draw_command* previous)
+    {
+        if (previous == nullptr || previous->pipeline != draw.pipeline)
+        {
+            cmdbuff.bindPipeline(vk::PipelineBindPoint::eGraphics, draw.pipeline);
+        }
+
+        // Bindings made with the same pipeline layout stay valid across pipeline changes, so only the range of sets
+        // that differ from the previous draw is bound again
+        const bool same_layout = previous != nullptr && previous->pipeline_layout == draw.pipeline_layout &&
+                                 previous->descriptor_set_count == draw.descriptor_set_count;
+        const auto set_matches = [&](const uint32_t i) {
+            return previous->descriptor_sets[i] == draw.descriptor_sets[i] &&
+                   (i >= draw.dynamic_offsets.size() || previous->dynamic_offsets[i] == draw.dynamic_offsets[i]);
+        };
+
+        uint32_t first_set = 0;
+        uint32_t last_set = draw.descriptor_set_count;
+        if (same_layout)
+        {
+            while (first_set < last_set && set_matches(first_set))
+            {
+                ++first_set;
+            }
+            while (last_set > first_set && set_matches(last_set - 1))
+            {
+                --last_set;
+            }
+        }
+
+        if (first_set < last_set)
+        {
+            const auto offsets_end = std::min(last_set, static_cast<uint32_t>(draw.dynamic_offsets.size()));
+            const auto offsets_begin = std::min(first_set, offsets_end);
+            cmdbuff.bindDescriptorSets(
+                vk::PipelineBindPoint::eGraphics,
+                draw.pipeline_layout,
+                first_set,
+                last_set - first_set,
+                draw.descriptor_sets.data() + first_set,
+                offsets_end - offsets_begin,
+                draw.dynamic_offsets.data() + offsets_begin);
+        }
+
+        if (draw.texture_indices.has_value() && (!same_layout || previous->texture_indices != draw.texture_indices))
+        {
+            cmdbuff.pushConstants(
+                draw.pipeline_layout,
+                vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment,
+                0,
+                BINDLESS_PUSH_CONSTANT_SIZE,
+                draw.texture_indices->data());
+        }
+
+        // Meshes in the same geometry pool block share their buffers
+        if (previous == nullptr || previous->vertex_buffer != draw.vertex_buffer)
+        {
+            cmdbuff.bindVertexBuffers(0, draw.vertex_buffer, { 0 });
+        }
+        if (previous == nullptr || previous->index_buffer != draw.index_buffer)
+        {
+            cmdbuff.bindIndexBuffer(draw.index_buffer, 0, vk::IndexType::eUint32);
+        }
+        cmdbuff.drawIndexed(draw.index_count, 1, draw.first_index, draw.vertex_offset, 0);
+    }
+
+    draw_recorder::draw_recorder(draw_recorder_args args)
+        : _args(args)
+    {
+        CRITICAL_CHECK_NOTNULL(_args.vkctx);
+        CRITICAL_CHECK(_args.thread_count > 0, "Invalid draw recording thread count");
+        CRITICAL_CHECK(_args.frames_in_flight > 0, "Invalid frames in flight count");
+        CRITICAL_CHECK(_args.draws_per_chunk > 0, "Invalid draws per chunk");
+
+        _pools.resize(_args.frames_in_flight);
+        for (auto& frame_pools : _pools)
+        {
+            frame_pools.resize(_args.thread_count);
+            for (auto& pool : frame_pools)
+            {
+                vk::CommandPoolCreateInfo cmdpool_info;
+                cmdpool_info.flags = vk::CommandPoolCreateFlagBits::eTransient;
+                cmdpool_info.queueFamilyIndex = _args.vkctx->graphics_queue_family_index();
+                pool.pool = _args.vkctx->device().createCommandPoolUnique(cmdpool_info);
+            }
+        }
+
+        // Thread 0 is the one calling record()
+        for (uint32_t i = 1; i < _args.thread_count; ++i)
+        {
+            _workers.emplace_back([this, i](const std::stop_token& stop) { worker_main(stop, i); });
+        }
+    }
+
+    draw_recorder::~draw_recorder()
+    {
+        for (auto& worker : _workers)
+        {
+            worker.request_stop();
+        }
+        _work_cv.notify_all();
+        _workers.clear();
+    }
+
+    void draw_recorder::begin_frame(const uint32_t frame_index)
+    {
+        CRITICAL_CHECK(frame_index < _pools.size(), "Invalid frame index");
+        _frame_index = frame_index;
+
+        for (auto& pool : _pools[_frame_index])
+        {
+            _args.vkctx->device().resetCommandPool(*pool.pool);
+            pool.used = 0;
+        }
+    }
+
+    std::vector<std::vector<vk::CommandBuffer>> draw_recorder::record(
+        const std::span<const std::vector<draw_command>> passes,
+        const vk::Viewport& viewport,
+        const vk::Rect2D& scissor)
+    {
+        std::vector<std::vector<vk::CommandBuffer>> result(passes.size());
+
+        {
+            std::unique_lock lock(_mutex);
+            // Workers that woke up late for the previous batch may still be looking at its chunk list
+            _done_cv.wait(lock, [this] { return _active_workers == 0; });
+
+            _chunks.clear();
+            for (size_t i = 0; i < passes.size(); ++i)
+            {
+                const auto& draws = passes[i];
+                const size_t chunk_count = (draws.size() + _args.draws_per_chunk - 1) / _args.draws_per_chunk;
+                result[i].resize(chunk_count);
+
+                for (size_t c = 0; c < chunk_count; ++c)
+                {
+                    const size_t begin = c * _args.draws_per_chunk;
+                    const size_t count = std::min<size_t>(_args.draws_per_chunk, draws.size() - begin);
+                    _chunks.push_back({ .draws = std::span{ draws }.subspan(begin, count), .result = &result[i][c] });
+                }
+            }
+
+            if (_chunks.empty())
+            {
+                return result;
+            }
+
+            _viewport = viewport;
+            _scissor = scissor;
+            _next_chunk = 0;
+            _chunks_done = 0;
+            ++_generation;
+        }
+        _work_cv.notify_all();
+
+        run_chunks(0);
+
+        std::unique_lock lock(_mutex);
+        _done_cv.wait(lock, [this] { return _chunks_done == _chunks.size() && _active_workers == 0; });
+
+        return result;
+    }
+
+    void draw_recorder::worker_main(const std::stop_token& stop, const uint32_t thread_index)
+    {
+        uint64_t seen_generation = 0;
+        while (true)
+        {
+            {
+                std::unique_lock lock(_mutex);
+                if (!_work_cv.wait(lock, stop, [&] { return _generation != seen_generation; }))
+                {
+                    return;
+                }
+                seen_generation = _generation;
+                ++_active_workers;
+            }
+
+            run_chunks(thread_index);
+
+            {
+                const std::scoped_lock lock(_mutex);
+                --_active_workers;
+            }
+            _done_cv.notify_all();
+        }
+    }
+
+    void draw_recorder::run_chunks(const uint32_t thread_index)
+    {
+        while (true)
+        {
+            const size_t index = _next_chunk.fetch_add(1);
+            if (index >= _chunks.size())
+            {
+                return;
+            }
+
+            record_chunk(thread_index, _chunks[index]);
+
+            const std::scoped_lock lock(_mutex);
+            if (++_chunks_done == _chunks.size())
+            {
+                _done_cv.notify_all();
+            }
+        }
+    }
+
+    void draw_recorder::record_chunk(const uint32_t thread_index, const chunk& chk)
+    {
+        const vk::CommandBuffer cmdbuff = next_cmdbuff(thread_index);
+
+        const vk::Format color_format = _args.color_format;
+
+        vk::CommandBufferInheritanceRenderingInfo inheritance_rendering_info;
+        inheritance_rendering_info.colorAttachmentCount = 1;
+        inheritance_rendering_info.pColorAttachmentFormats = &color_format;
+        inheritance_rendering_info.depthAttachmentFormat = _args.depthstencil_format;
+        inheritance_rendering_info.stencilAttachmentFormat = _args.depthstencil_format;
+        inheritance_rendering_info.rasterizationSamples = vk::SampleCountFlagBits::e1;
+
+        vk::CommandBufferInheritanceInfo inheritance_info;
+        inheritance_info.pNext = &inheritance_rendering_info;
+
+        vk::CommandBufferBeginInfo begin_info;
+        begin_info.flags =
+            vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue;
+        begin_info.pInheritanceInfo = &inheritance_info;
+
+        cmdbuff.begin(begin_info);
+
+        // Dynamic state is not inherited from the primary
+        cmdbuff.setViewport(0, _viewport);
+        cmdbuff.setScissor(0, _scissor);
+
+        const draw_command* previous = nullptr;
+        for (const auto& draw : chk.draws)
+        {
+            record_draw(cmdbuff, draw, previous);
+            previous = &draw;
+        }
+
+        cmdbuff.end();
+        *chk.result = cmdbuff;
+    }
+
+    vk::CommandBuffer draw_recorder::next_cmdbuff(const uint32_t thread_index)
+    {
+        auto& pool = _pools[_frame_index][thread_index];
+        if (pool.used == pool.cmdbuffs.size())
+        {
+            vk::CommandBufferAllocateInfo info;
+            info.commandBufferCount = 1;
+            info.commandPool = *pool.pool;
+            info.level = vk::CommandBufferLevel::eSecondary;
+            auto cmdbuffs = _args.vkctx->device().allocateCommandBuffersUnique(info);
+            pool.cmdbuffs.push_back(std::move(cmdbuffs[0]));
+        }
+        return *pool.cmdbuffs[pool.used++];
+    }
+} // namespace cathedral::engine
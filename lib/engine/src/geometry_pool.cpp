@@ -0,0 +1,108 @@
+#include <cathedral/engine/geometry_pool.hpp>
+
+#include <cathedral/engine/upload_queue.hpp>
+
+#include <algorithm>
+
+namespace cathedral::engine
+{
+    geometry_pool::geometry_pool(const gfx::vulkan_context& vkctx, const uint32_t vertex_size, geometry_pool_args args)
+        : _vkctx(vkctx)
+        , _vertex_size(vertex_size)
+        , _args(args)
+    {
+        CRITICAL_CHECK(_vertex_size > 0 && _vertex_size % sizeof(float) == 0, "Invalid vertex size");
+        CRITICAL_CHECK(_args.block_vertex_count > 0 && _args.block_index_count > 0, "Invalid geometry block size");
+    }
+
+    geometry_range geometry_pool::allocate(
+        const std::span<const float> vertex_data,
+        const std::span<const uint32_t> indices,
+        upload_queue& queue)
+    {
+        const auto vertex_count = static_cast<uint32_t>(vertex_data.size_bytes() / _vertex_size);
+        const auto index_count = static_cast<uint32_t>(indices.size());
+        CRITICAL_CHECK(vertex_count > 0 && index_count > 0, "Attempt to allocate empty geometry");
+
+        geometry_range result;
+        result.vertex_count = vertex_count;
+        result.index_count = index_count;
+
+        const auto try_allocate = [&](block& blk) {
+            const auto vertex_offset = blk.vertex_alloc.allocate(vertex_count);
+            if (!vertex_offset.has_value())
+            {
+                return false;
+            }
+
+            const auto first_index = blk.index_alloc.allocate(index_count);
+            if (!first_index.has_value())
+            {
+                blk.vertex_alloc.free(*vertex_offset, vertex_count);
+                return false;
+            }
+
+            result.vertex_offset = *vertex_offset;
+            result.first_index = *first_index;
+            return true;
+        };
+
+        const auto it = std::ranges::find_if(_blocks, [&](const auto& blk) { return try_allocate(*blk); });
+        if (it != _blocks.end())
+        {
+            result.block = static_cast<uint32_t>(std::distance(_blocks.begin(), it));
+        }
+        else
+        {
+            result.block = add_block(
+                std::max(vertex_count, _args.block_vertex_count),
+                std::max(index_count, _args.block_index_count));
+            CRITICAL_CHECK(try_allocate(*_blocks[result.block]), "Geometry allocation failure in a new block");
+        }
+
+        const auto& blk = *_blocks[result.block];
+        queue.update_buffer(blk.vertex_buffer, result.vertex_offset * _vertex_size, vertex_data);
+        queue.update_buffer(blk.index_buffer, result.first_index * static_cast<uint32_t>(sizeof(uint32_t)), indices);
+
+        return result;
+    }
+
+    void geometry_pool::free(const geometry_range& range)
+    {
+        CRITICAL_CHECK(range.block < _blocks.size(), "Invalid geometry block");
+
+        auto& blk = *_blocks[range.block];
+        blk.vertex_alloc.free(range.vertex_offset, range.vertex_count);
+        blk.index_alloc.free(range.first_index, range.index_count);
+    }
+
+    geometry_pool_stats geometry_pool::stats() const
+    {
+        geometry_pool_stats result;
+        result.block_count = _blocks.size();
+        for (const auto& blk : _blocks)
+        {
+            result.used_vertices += blk->vertex_alloc.used();
+            result.used_indices += blk->index_alloc.used();
+        }
+        return result;
+    }
+
+    uint32_t geometry_pool::add_block(const uint32_t vertex_count, const uint32_t index_count)
+    {
+        gfx::vertex_buffer_args vxbuff_args;
+        vxbuff_args.vertex_size = _vertex_size;
+        vxbuff_args.size = static_cast<size_t>(vertex_count) * _vertex_size;
+        vxbuff_args.vkctx = &_vkctx;
+
+        gfx::index_buffer_args ixbuff_args;
+        ixbuff_args.size = static_cast<size_t>(index_count) * sizeof(uint32_t);
+        ixbuff_args.vkctx = &_vkctx;
+
+        _blocks.push_back(std::make_unique<block>(block{ .vertex_buffer = gfx::vertex_buffer(vxbuff_args),
+                                                         .index_buffer = gfx::index_buffer(ixbuff_args),
+                                                         .vertex_alloc = range_allocator(vertex_count),
+                                                         .index_alloc = range_allocator(index_count) }));
+        return static_cast<uint32_t>(_blocks.size() - 1);
+    }
+} // namespace cathedral::engine
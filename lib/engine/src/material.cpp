@@ -37,30 +37,24 @@ namespace cathedral::engine
         CRITICAL_CHECK(!_args.vertex_shader_source.empty(), "Empty vertex shader source");
         CRITICAL_CHECK(!_args.fragment_shader_source.empty(), "Empty fragment shader source");
 
-        init_shaders_and_data();
+        auto sources = init_shaders_and_data();
 
-        if (_material_uniform_block_size > 0)
-        {
-            gfx::uniform_buffer_args buff_args;
-            buff_args.size = _material_uniform_block_size;
-            buff_args.vkctx = &_renderer->vkctx();
-
-            _material_uniform = std::make_unique<gfx::uniform_buffer>(buff_args);
-        }
-
-        init_pipeline();
+        init_descriptor_set_infos();
         init_descriptor_set_layouts();
         init_descriptor_set();
         init_default_textures();
+        write_texture_descriptors();
 
         _uniform_data.resize(_material_uniform_block_size);
+
+        compile_pipeline(std::move(sources));
     }
 
-    void material::init_pipeline()
+    void material::init_descriptor_set_infos()
     {
         _material_descriptor_set_info = { .set_index = 1,
                                           .definition = {
-                                              { gfx::descriptor_set_entry(1, 0, gfx::descriptor_type::UNIFORM, 1) } } };
+                                              { gfx::descriptor_set_entry(1, 0, gfx::descriptor_type::UNIFORM_DYNAMIC, 1) } } };
 
         // Clear sampler entries
         {
@@ -78,23 +72,27 @@ namespace cathedral::engine
             _node_descriptor_set_info.definition.entries.erase(removed_range.begin(), removed_range.end());
         }
 
-        if (const auto mat_tex_slots = material_texture_slots(); mat_tex_slots > 0)
+        const bool bindless = _renderer->bindless_textures();
+        if (const auto mat_tex_slots = material_texture_slots(); mat_tex_slots > 0 && !bindless)
         {
             _material_descriptor_set_info.definition.entries.emplace_back(1, 1, gfx::descriptor_type::SAMPLER, mat_tex_slots);
         }
 
         _node_descriptor_set_info = { .set_index = 2,
                                       .definition = {
-                                          { gfx::descriptor_set_entry(2, 0, gfx::descriptor_type::UNIFORM, 1) } } };
+                                          { gfx::descriptor_set_entry(2, 0, gfx::descriptor_type::UNIFORM_DYNAMIC, 1) } } };
 
-        if (const auto node_tex_slots = node_texture_slots(); node_tex_slots > 0)
+        if (const auto node_tex_slots = node_texture_slots(); node_tex_slots > 0 && !bindless)
         {
             _node_descriptor_set_info.definition.entries.emplace_back(2, 1, gfx::descriptor_type::SAMPLER, node_tex_slots);
         }
+    }
+
+    gfx::pipeline_args material::make_pipeline_args() const
+    {
+        const bool bindless = _renderer->bindless_textures();
 
         gfx::pipeline_args args;
-        args.vertex_shader = &_vertex_shader->gfx_shader();
-        args.fragment_shader = &_fragment_shader->gfx_shader();
         args.color_attachment_formats = { _renderer->swapchain().swapchain_image_format() };
         args.color_blend_enable = true;
         args.depth_stencil_format = gfx::depthstencil_attachment::format();
@@ -104,13 +102,59 @@ namespace cathedral::engine
         args.descriptor_sets = { scene::descriptor_set_definition(),
                                  _material_descriptor_set_info,
                                  _node_descriptor_set_info };
+        if (bindless)
+        {
+            args.descriptor_sets.push_back(_renderer->get_bindless_texture_table().descriptor_set_definition());
+            args.push_constant_size = BINDLESS_PUSH_CONSTANT_SIZE;
+        }
         args.input_topology = vk::PrimitiveTopology::eTriangleList;
         args.line_width = 1.0F;
         args.polygon_mode = vk::PolygonMode::eFill;
         args.vertex_input = standard_vertex_input_description();
         args.vkctx = &_renderer->vkctx();
 
-        _pipeline = std::make_unique<gfx::pipeline>(args);
+        // Resolved here, worker threads can only look pipelines up once every layout exists
+        _renderer->get_pipeline_cache().resolve_layouts(args);
+        return args;
+    }
+
+    void material::compile_pipeline(shader_sources sources)
+    {
+        // Everything the job needs is moved into it, so it never touches the material, which may be gone by the time
+        // the job runs
+        auto job = [sources = std::move(sources),
+                    args = make_pipeline_args(),
+                    &cache = _renderer->get_pipeline_cache()]() mutable {
+            auto vertex_shader = std::make_shared<gfx::shader>(sources.vertex);
+            auto fragment_shader = std::make_shared<gfx::shader>(sources.fragment);
+            vertex_shader->compile();
+            fragment_shader->compile();
+
+            args.vertex_shader = vertex_shader.get();
+            args.fragment_shader = fragment_shader.get();
+
+            compiled_pipeline result;
+            result.pipeline = cache.get(std::move(args));
+            result.vertex_shader = std::make_shared<shader>(std::move(vertex_shader), std::move(sources.vertex_pp_data));
+            result.fragment_shader =
+                std::make_shared<shader>(std::move(fragment_shader), std::move(sources.fragment_pp_data));
+            return result;
+        };
+
+        _pending_pipeline = _renderer->get_pipeline_compiler().submit(std::move(job));
+
+        // Without worker threads the job has already run, the material is ready as soon as it is created
+        if (!_renderer->compiles_pipelines_on_threads())
+        {
+            install_pipeline(_pending_pipeline.get());
+        }
+    }
+
+    void material::install_pipeline(compiled_pipeline compiled)
+    {
+        _vertex_shader = std::move(compiled.vertex_shader);
+        _fragment_shader = std::move(compiled.fragment_shader);
+        _pipeline = std::move(compiled.pipeline);
     }
 
     void material::bind_material_texture_slot(const std::shared_ptr<texture>& tex, uint32_t slot)
@@ -119,24 +163,11 @@ namespace cathedral::engine
         if (slot >= _texture_slots.size())
         {
             _texture_slots.resize(slot + 1);
+            _texture_slot_generations.resize(slot + 1);
         }
         _texture_slots[slot] = tex;
-
-        vk::DescriptorImageInfo info;
-        info.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-        info.imageView = tex->imageview();
-        info.sampler = tex->sampler().get_sampler();
-
-        vk::WriteDescriptorSet write;
-        write.pImageInfo = &info;
-        write.descriptorCount = 1;
-        write.descriptorType = vk::DescriptorType::eCombinedImageSampler;
-        write.dstArrayElement = slot;
-        write.dstBinding = 1;
-        write.dstSet = *_descriptor_set;
-        write.pTexelBufferView = nullptr;
-
-        _renderer->vkctx().device().updateDescriptorSets(write, {});
+        _texture_slot_generations[slot] = tex->imageview_generation();
+        _textures_need_write = true;
     }
 
     void material::update_uniform(const std::function<void(std::span<std::byte>&)>& func)
@@ -146,29 +177,73 @@ namespace cathedral::engine
             return;
         }
 
-        const auto previous_data = _uniform_data;
         auto span = std::span{ _uniform_data.data(), _uniform_data.size() };
         func(span);
-        if (previous_data != _uniform_data)
-        {
-            _uniform_needs_update = true;
-        }
     }
 
     void material::update()
     {
-        if (_needs_pipeline_update)
+        // Pipelines compiled on worker threads are swapped in here, at the start of a frame before any node draws
+        if (_pending_pipeline.valid() &&
+            _pending_pipeline.wait_for(std::chrono::seconds::zero()) == std::future_status::ready)
         {
-            init_pipeline();
+            install_pipeline(_pending_pipeline.get());
+        }
+
+        // Deferred while the initial compilation is pending, it needs the compiled shaders
+        if (_needs_pipeline_update && pipeline_ready())
+        {
+            _renderer->retire(std::move(_pipeline));
+            init_descriptor_set_infos();
+            init_descriptor_set_layouts();
+            if (_renderer->bindless_textures())
+            {
+                init_descriptor_set();
+            }
+
+            auto args = make_pipeline_args();
+            args.vertex_shader = &_vertex_shader->gfx_shader();
+            args.fragment_shader = &_fragment_shader->gfx_shader();
+            _pipeline = _renderer->get_pipeline_cache().get(std::move(args));
+
             force_rebind_textures();
             _needs_pipeline_update = false;
         }
+        else
+        {
+            // Streamed textures swap their image view when their resident mips change
+            for (size_t i = 0; i < _texture_slots.size(); ++i)
+            {
+                if (_texture_slots[i] && _texture_slots[i]->imageview_generation() != _texture_slot_generations[i])
+                {
+                    bind_material_texture_slot(_texture_slots[i], static_cast<uint32_t>(i));
+                }
+            }
+        }
 
-        if (_material_uniform && _uniform_needs_update)
+        if (_textures_need_write)
         {
-            _renderer->get_upload_queue().update_buffer(*_material_uniform, 0, _uniform_data);
-            _uniform_needs_update = false;
+            // Frames in flight may still use the current set, so texture changes go into a fresh one. The old set is
+            // only recycled once those frames are done. Bindless textures only change the pushed indices
+            if (!_renderer->bindless_textures())
+            {
+                init_descriptor_set();
+            }
+            write_texture_descriptors();
         }
+
+        frame_uniform_offset();
+    }
+
+    uint32_t material::frame_uniform_offset()
+    {
+        // Arena memory only lasts a frame, so the uniform data is written again every frame
+        if (!_uniform_data.empty() && _uniform_frame != _renderer->current_frame())
+        {
+            _uniform_offset = _renderer->get_uniform_arena().write(std::span<const std::byte>{ _uniform_data });
+            _uniform_frame = _renderer->current_frame();
+        }
+        return _uniform_offset;
     }
 
     void material::force_pipeline_update()
@@ -246,55 +321,81 @@ namespace cathedral::engine
 
     void material::init_descriptor_set_layouts()
     {
-        _material_descriptor_set_layout =
-            _material_descriptor_set_info.definition.create_descriptor_set_layout(_renderer->vkctx());
-
-        _node_descriptor_set_layout = _node_descriptor_set_info.definition.create_descriptor_set_layout(_renderer->vkctx());
+        auto& allocator = _renderer->get_descriptor_allocator();
+        _material_descriptor_set_layout = allocator.layout(_material_descriptor_set_info.definition);
+        _node_descriptor_set_layout = allocator.layout(_node_descriptor_set_info.definition);
     }
 
     void material::init_descriptor_set()
     {
-        vk::DescriptorSetAllocateInfo alloc_info;
-        alloc_info.descriptorPool = _renderer->vkctx().descriptor_pool();
-        alloc_info.descriptorSetCount = 1;
-        alloc_info.pSetLayouts = &*_material_descriptor_set_layout;
-
-        _descriptor_set = std::move(_renderer->vkctx().device().allocateDescriptorSetsUnique(alloc_info)[0]);
-
-        const auto& buffer = _material_uniform ? _material_uniform : _renderer->empty_uniform_buffer();
-
-        vk::DescriptorBufferInfo buffer_info;
-        buffer_info.buffer = buffer->buffer();
-        buffer_info.offset = 0;
-        buffer_info.range = buffer->size();
-
-        vk::WriteDescriptorSet write;
-        write.descriptorCount = 1;
-        write.descriptorType = vk::DescriptorType::eUniformBuffer;
-        write.pBufferInfo = &buffer_info;
-        write.dstArrayElement = 0;
-        write.dstBinding = 0;
-        write.dstSet = *_descriptor_set;
-        _renderer->vkctx().device().updateDescriptorSets(write, {});
+        _descriptor_set = _renderer->get_descriptor_allocator().allocate(_material_descriptor_set_info.definition);
+
+        _renderer->get_uniform_arena().write_descriptor(
+            _renderer->descriptor_writes(),
+            *_descriptor_set,
+            0,
+            _material_uniform_block_size);
+
+        if (_renderer->bindless_textures())
+        {
+            _shared_node_descriptor_set =
+                _renderer->get_descriptor_allocator().allocate(_node_descriptor_set_info.definition);
+
+            _renderer->get_uniform_arena().write_descriptor(
+                _renderer->descriptor_writes(),
+                *_shared_node_descriptor_set,
+                0,
+                _node_uniform_block_size);
+        }
     }
 
-    void material::init_default_textures()
+    void material::write_texture_descriptors()
     {
-        const auto it = std::ranges::find_if(
-            _material_descriptor_set_info.definition.entries,
-            [](const gfx::descriptor_set_entry& entry) { return entry.set == 1 && entry.binding == 1; });
-
-        if (it != _material_descriptor_set_info.definition.entries.end())
+        if (_renderer->bindless_textures())
         {
-            const auto& textures_binding = *it;
-            for (uint32_t i = 0; i < textures_binding.count; ++i)
+            auto& table = _renderer->get_bindless_texture_table();
+
+            // Acquired before the old indices are released, so unchanged textures keep their table slots
+            std::vector<bindless_texture_index> indices;
+            indices.reserve(_texture_slots.size());
+            for (size_t i = 0; i < _texture_slots.size(); ++i)
             {
-                bind_material_texture_slot(_renderer->default_texture(), i);
+                const auto& tex = _texture_slots[i] ? _texture_slots[i] : _renderer->default_texture();
+                indices.push_back(
+                    table.acquire(tex->imageview(), tex->sampler().get_sampler(), _renderer->descriptor_writes()));
+                _bindless_texture_indices[i] = indices.back().get();
             }
+            _bindless_texture_slots = std::move(indices);
+            _textures_need_write = false;
+            return;
+        }
+
+        std::vector<vk::DescriptorImageInfo> infos;
+        infos.reserve(_texture_slots.size());
+        for (const auto& slot_tex : _texture_slots)
+        {
+            const auto& tex = slot_tex ? slot_tex : _renderer->default_texture();
+
+            vk::DescriptorImageInfo info;
+            info.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+            info.imageView = tex->imageview();
+            info.sampler = tex->sampler().get_sampler();
+            infos.push_back(info);
+        }
+
+        _renderer->descriptor_writes().write_images(*_descriptor_set, 1, std::move(infos));
+        _textures_need_write = false;
+    }
+
+    void material::init_default_textures()
+    {
+        for (uint32_t i = 0; i < material_texture_slots(); ++i)
+        {
+            bind_material_texture_slot(_renderer->default_texture(), i);
         }
     }
 
-    void material::init_shaders_and_data()
+    material::shader_sources material::init_shaders_and_data()
     {
         auto vx_pp_data = get_shader_preprocess_data(_args.vertex_shader_source);
         auto fg_pp_data = get_shader_preprocess_data(_args.fragment_shader_source);
@@ -305,31 +406,21 @@ namespace cathedral::engine
         _merged_pp_data = vx_pp_data->merge(*fg_pp_data);
         _merged_pp_data.clean_source = {};
 
-        const auto vx_pp_source = preprocess_shader(gfx::shader_type::VERTEX, *vx_pp_data);
-        const auto fg_pp_source = preprocess_shader(gfx::shader_type::FRAGMENT, *fg_pp_data);
+        const bool bindless = _renderer->bindless_textures();
+        const auto vx_pp_source = preprocess_shader(gfx::shader_type::VERTEX, *vx_pp_data, bindless);
+        const auto fg_pp_source = preprocess_shader(gfx::shader_type::FRAGMENT, *fg_pp_data, bindless);
 
         CRITICAL_CHECK(vx_pp_source.has_value(), "Vertex shader code generation failed");
         CRITICAL_CHECK(fg_pp_source.has_value(), "Fragment shader code generation failed");
 
-        gfx::shader_args vx_gfx_shader_args;
-        vx_gfx_shader_args.source = *vx_pp_source;
-        vx_gfx_shader_args.type = gfx::shader_type::VERTEX;
-
-        gfx::shader_args fg_gfx_shader_args;
-        fg_gfx_shader_args.source = *fg_pp_source;
-        fg_gfx_shader_args.type = gfx::shader_type::FRAGMENT;
-
-        auto vx_gfx_shader = std::make_shared<gfx::shader>(std::move(vx_gfx_shader_args));
-        auto fg_gfx_shader = std::make_shared<gfx::shader>(std::move(fg_gfx_shader_args));
-
-        vx_gfx_shader->compile();
-        fg_gfx_shader->compile();
-
-        _vertex_shader = std::make_shared<engine::shader>(std::move(vx_gfx_shader), *vx_pp_data);
-        _fragment_shader = std::make_shared<engine::shader>(std::move(fg_gfx_shader), *fg_pp_data);
+        shader_sources result;
+        result.vertex.source = *vx_pp_source;
+        result.vertex.type = gfx::shader_type::VERTEX;
+        result.fragment.source = *fg_pp_source;
+        result.fragment.type = gfx::shader_type::FRAGMENT;
 
         uint32_t current_offset = 0;
-        for (const auto& var : _vertex_shader->preprocess_data().material_vars)
+        for (const auto& var : vx_pp_data->material_vars)
         {
             _mat_var_offsets[var.name] = current_offset;
             current_offset += gfx::shader_data_type_offset(var.type, var.count, current_offset);
@@ -337,11 +428,15 @@ namespace cathedral::engine
         _material_uniform_block_size = current_offset;
 
         current_offset = 0;
-        for (const auto& var : _vertex_shader->preprocess_data().node_vars)
+        for (const auto& var : vx_pp_data->node_vars)
         {
             _node_var_offsets[var.name] = current_offset;
             current_offset += gfx::shader_data_type_offset(var.type, var.count, current_offset);
         }
         _node_uniform_block_size = current_offset;
+
+        result.vertex_pp_data = *std::move(vx_pp_data);
+        result.fragment_pp_data = *std::move(fg_pp_data);
+        return result;
     }
 } // namespace cathedral::engine
\ No newline at end of file
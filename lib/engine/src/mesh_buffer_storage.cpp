@@ -5,6 +5,27 @@
 
 namespace cathedral::engine
 {
+    mesh_buffer::mesh_buffer(renderer& rend, geometry_range range)
+        : _renderer(rend)
+        , _range(range)
+    {
+    }
+
+    mesh_buffer::~mesh_buffer()
+    {
+        _renderer.defer([&pool = _renderer.get_geometry_pool(), range = _range] { pool.free(range); });
+    }
+
+    vk::Buffer mesh_buffer::vertex_buffer() const
+    {
+        return _renderer.get_geometry_pool().vertex_buffer(_range.block).buffer();
+    }
+
+    vk::Buffer mesh_buffer::index_buffer() const
+    {
+        return _renderer.get_geometry_pool().index_buffer(_range.block).buffer();
+    }
+
     mesh_buffer_storage::mesh_buffer_storage(renderer* rend)
         : _renderer(rend)
     {
@@ -16,27 +37,14 @@ namespace cathedral::engine
         const auto generate_vxbuff = [&]() {
             const auto vertex_data = mesh_ref.get_packed_data();
 
-            gfx::vertex_buffer_args vxbuff_args;
-            vxbuff_args.vertex_size = static_cast<uint32_t>(mesh::vertex_size_bytes());
-            vxbuff_args.size = vertex_data.size() * sizeof(float);
-            vxbuff_args.vkctx = &_renderer->vkctx();
-
-            gfx::vertex_buffer vxbuff(vxbuff_args);
-
-            gfx::index_buffer_args ixbuff_args;
-            ixbuff_args.size = mesh_ref.indices().size() * sizeof(unsigned int);
-            ixbuff_args.vkctx = &_renderer->vkctx();
-
-            gfx::index_buffer ixbuff(ixbuff_args);
-
-            auto& upload_queue = _renderer->get_upload_queue();
-            upload_queue.update_buffer(vxbuff, 0, std::span{ vertex_data });
-            upload_queue.update_buffer(ixbuff, 0, std::span{ mesh_ref.indices() });
+            const geometry_range range = _renderer->get_geometry_pool().allocate(
+                std::span{ vertex_data },
+                std::span{ mesh_ref.indices() },
+                _renderer->get_upload_queue());
 
-            auto shptr = std::make_shared<mesh_buffer>(
-                mesh_buffer{ .vertex_buffer = std::move(vxbuff), .index_buffer = std::move(ixbuff) });
+            auto shptr = std::make_shared<mesh_buffer>(*_renderer, range);
 
-            _buffers.try_emplace(mesh_path, shptr);
+            _buffers.insert_or_assign(mesh_path, shptr);
             return shptr;
         };
 
@@ -2,14 +2,47 @@
 
 #include <cathedral/engine/scene.hpp>
 
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <limits>
+
 namespace cathedral::engine
 {
+    namespace
+    {
+        std::optional<sphere> calc_bounding_sphere(const std::vector<glm::vec3>& positions)
+        {
+            if (positions.empty())
+            {
+                return std::nullopt;
+            }
+
+            glm::vec3 min = positions[0];
+            glm::vec3 max = positions[0];
+            for (const auto& pos : positions)
+            {
+                min = glm::min(min, pos);
+                max = glm::max(max, pos);
+            }
+
+            const glm::vec3 center = (min + max) * 0.5F;
+            float radius = 0.0F;
+            for (const auto& pos : positions)
+            {
+                radius = std::max(radius, glm::distance(center, pos));
+            }
+            return sphere(center, radius);
+        }
+    } // namespace
+
     void mesh3d_node::set_mesh(std::optional<std::string> name)
     {
         if ((_mesh_name.has_value() != name.has_value()) || (name.has_value() && (_mesh_name.value() != name.value())))
         {
             _mesh_name = std::move(name);
             _mesh_buffers = {};
+            _local_bounds = std::nullopt;
             _needs_update_mesh = true;
         }
     }
@@ -18,6 +51,7 @@ namespace cathedral::engine
     {
         _mesh_buffers = std::move(mesh_buffer);
         _mesh_name = std::nullopt;
+        _local_bounds = std::nullopt;
         _needs_update_mesh = false;
     }
 
@@ -45,34 +79,77 @@ namespace cathedral::engine
         _needs_update_textures = true;
     }
 
-    void mesh3d_node::bind_node_texture_slot(const renderer& rend, std::shared_ptr<texture> tex, const uint32_t slot)
+    void mesh3d_node::bind_node_texture_slot(std::shared_ptr<texture> tex, const uint32_t slot)
     {
         if (_material.expired())
         {
             return;
         }
 
-        vk::DescriptorImageInfo info;
-        info.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-        info.imageView = tex->imageview();
-        info.sampler = tex->sampler().get_sampler();
-
-        vk::WriteDescriptorSet write;
-        write.pImageInfo = &info;
-        write.descriptorCount = 1;
-        write.descriptorType = vk::DescriptorType::eCombinedImageSampler;
-        write.dstArrayElement = slot;
-        write.dstBinding = 1;
-        write.dstSet = *_descriptor_set;
-        write.pTexelBufferView = nullptr;
-
-        rend.vkctx().device().updateDescriptorSets(write, {});
-
         if (slot >= _texture_slots.size())
         {
             _texture_slots.resize(slot + 1);
+            _texture_slot_generations.resize(slot + 1);
         }
+        _texture_slot_generations[slot] = tex->imageview_generation();
         _texture_slots[slot] = std::move(tex);
+        _descriptor_set_needs_rebuild = true;
+    }
+
+    void mesh3d_node::rebuild_descriptor_set(renderer& rend)
+    {
+        if (rend.bindless_textures())
+        {
+            rebuild_bindless_texture_indices(rend);
+            return;
+        }
+
+        // Frames in flight may still use the current set, so changes always go into a fresh one. The old set is only
+        // recycled once those frames are done
+        const auto& definition = _material.lock()->node_descriptor_set_definition().definition;
+        _descriptor_set = rend.get_descriptor_allocator().allocate(definition);
+
+        auto& writes = rend.descriptor_writes();
+        rend.get_uniform_arena().write_descriptor(writes, *_descriptor_set, 0, static_cast<uint32_t>(_uniform_data.size()));
+
+        _descriptor_set_needs_rebuild = false;
+        if (_texture_slots.empty())
+        {
+            return;
+        }
+
+        std::vector<vk::DescriptorImageInfo> infos;
+        infos.reserve(_texture_slots.size());
+        for (const auto& slot_tex : _texture_slots)
+        {
+            const auto& tex = slot_tex ? slot_tex : rend.default_texture();
+
+            vk::DescriptorImageInfo info;
+            info.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+            info.imageView = tex->imageview();
+            info.sampler = tex->sampler().get_sampler();
+            infos.push_back(info);
+        }
+
+        writes.write_images(*_descriptor_set, 1, std::move(infos));
+    }
+
+    void mesh3d_node::rebuild_bindless_texture_indices(renderer& rend)
+    {
+        // The node uniform binding lives in the material's shared node set, only the pushed indices are per node
+        auto& table = rend.get_bindless_texture_table();
+        CRITICAL_CHECK(_texture_slots.size() <= MAX_BINDLESS_NODE_TEXTURES, "Too many node textures for bindless mode");
+
+        std::vector<bindless_texture_index> indices;
+        indices.reserve(_texture_slots.size());
+        for (size_t i = 0; i < _texture_slots.size(); ++i)
+        {
+            const auto& tex = _texture_slots[i] ? _texture_slots[i] : rend.default_texture();
+            indices.push_back(table.acquire(tex->imageview(), tex->sampler().get_sampler(), rend.descriptor_writes()));
+            _bindless_texture_indices[i] = indices.back().get();
+        }
+        _bindless_texture_slots = std::move(indices);
+        _descriptor_set_needs_rebuild = false;
     }
 
     void mesh3d_node::tick_setup(scene& scene)
@@ -88,6 +165,20 @@ namespace cathedral::engine
         {
             update_textures(scene);
         }
+
+        // Streamed textures swap their image view when their resident mips change
+        for (uint32_t i = 0; i < _texture_slots.size(); ++i)
+        {
+            if (_texture_slots[i] && _texture_slots[i]->imageview_generation() != _texture_slot_generations[i])
+            {
+                bind_node_texture_slot(_texture_slots[i], i);
+            }
+        }
+
+        if (_descriptor_set_needs_rebuild && !_material.expired())
+        {
+            rebuild_descriptor_set(scene.get_renderer());
+        }
     }
 
     void mesh3d_node::tick(scene& scene, const double deltatime)
@@ -125,6 +216,7 @@ namespace cathedral::engine
             {
                 _mesh = scene.load_mesh(*_mesh_name);
                 _mesh_buffers = scene.get_mesh_buffers(*_mesh_name, *_mesh);
+                _local_bounds = calc_bounding_sphere(_mesh->positions());
             }
             else
             {
@@ -139,15 +231,19 @@ namespace cathedral::engine
 
         const auto material = _material.lock();
 
-        update_bindings();
-
-        if (_uniform_needs_update)
+        // Skipped until the material's pipeline, compiled on a worker thread, is swapped in at a frame boundary
+        if (!material->pipeline_ready())
         {
-            scene.get_renderer().get_upload_queue().update_buffer(*_mesh3d_uniform_buffer, 0, _uniform_data);
-            _uniform_needs_update = false;
+            return;
         }
 
-        auto& [vxbuff, ixbuff] = *_mesh_buffers;
+        update_bindings();
+        request_streamed_mips(scene, *material);
+
+        // Arena memory only lasts a frame, so the uniform data is written again every frame
+        auto& uniform_arena = scene.get_renderer().get_uniform_arena();
+        const uint32_t uniform_offset =
+            _uniform_data.empty() ? 0 : uniform_arena.write(std::span<const std::byte>{ _uniform_data });
 
         const auto cmdbuff_type = [&] {
             switch (material->domain())
@@ -163,17 +259,35 @@ namespace cathedral::engine
             }
         }();
 
-        const vk::CommandBuffer cmdbuff = scene.get_renderer().render_cmdbuff(cmdbuff_type);
-        cmdbuff.bindPipeline(vk::PipelineBindPoint::eGraphics, material->pipeline().get());
-        cmdbuff.bindDescriptorSets(
-            vk::PipelineBindPoint::eGraphics,
-            material->pipeline().pipeline_layout(),
-            0,
-            { scene.descriptor_set(), material->descriptor_set(), *_descriptor_set },
-            {});
-        cmdbuff.bindVertexBuffers(0, vxbuff.buffer(), { 0 });
-        cmdbuff.bindIndexBuffer(ixbuff.buffer(), 0, vk::IndexType::eUint32);
-        cmdbuff.drawIndexed(ixbuff.index_count(), 1, 0, 0, 0);
+        auto& renderer = scene.get_renderer();
+
+        draw_command command;
+        command.pipeline = material->pipeline().get();
+        command.pipeline_layout = material->pipeline().pipeline_layout();
+        if (renderer.bindless_textures())
+        {
+            command.descriptor_sets = { scene.descriptor_set(),
+                                        material->descriptor_set(),
+                                        material->shared_node_descriptor_set(),
+                                        renderer.get_bindless_texture_table().descriptor_set() };
+            command.descriptor_set_count = 4;
+
+            auto& indices = command.texture_indices.emplace();
+            std::ranges::copy(material->bindless_texture_indices(), indices.begin());
+            std::ranges::copy(_bindless_texture_indices, indices.begin() + MAX_BINDLESS_MATERIAL_TEXTURES);
+        }
+        else
+        {
+            command.descriptor_sets = { scene.descriptor_set(), material->descriptor_set(), *_descriptor_set };
+        }
+        command.dynamic_offsets = { scene.uniform_offset(), material->frame_uniform_offset(), uniform_offset };
+        command.vertex_buffer = _mesh_buffers->vertex_buffer();
+        command.index_buffer = _mesh_buffers->index_buffer();
+        command.vertex_offset = static_cast<int32_t>(_mesh_buffers->range().vertex_offset);
+        command.first_index = _mesh_buffers->range().first_index;
+        command.index_count = _mesh_buffers->range().index_count;
+
+        renderer.draw(cmdbuff_type, command);
     }
 
     std::shared_ptr<scene_node> mesh3d_node::copy(const std::string& name, bool copy_children) const
@@ -203,10 +317,10 @@ namespace cathedral::engine
 
     void mesh3d_node::init_default_textures(const renderer& rend)
     {
-        const auto defs = _material.lock()->node_descriptor_set_definition();
-        if (defs.definition.entries.size() > 1)
+        const auto node_texture_slots = _material.lock()->node_texture_slots();
+        if (node_texture_slots > 0)
         {
-            for (uint32_t i = 0; i < defs.definition.entries[1].count; ++i)
+            for (uint32_t i = 0; i < node_texture_slots; ++i)
             {
                 if (i < _texture_names.size())
                 {
@@ -214,10 +328,10 @@ namespace cathedral::engine
                 }
                 else
                 {
-                    bind_node_texture_slot(rend, rend.default_texture(), i);
+                    bind_node_texture_slot(rend.default_texture(), i);
                 }
             }
-            _texture_names.resize(defs.definition.entries[1].count, DEFAULT_TEXTURE_NAME);
+            _texture_names.resize(node_texture_slots, DEFAULT_TEXTURE_NAME);
         }
     }
 
@@ -249,41 +363,9 @@ namespace cathedral::engine
                 (node_uniform_size != 0U) && _uniform_data.size() != node_uniform_size)
             {
                 _uniform_data.resize(node_uniform_size);
-                _mesh3d_uniform_buffer.reset();
-
-                if (node_uniform_size > 0)
-                {
-                    gfx::uniform_buffer_args buff_args;
-                    buff_args.size = material->node_uniform_block_size();
-                    buff_args.vkctx = &renderer.vkctx();
-
-                    _mesh3d_uniform_buffer = std::make_unique<gfx::uniform_buffer>(buff_args);
-                }
             }
 
-            const auto layout = material->node_descriptor_set_layout();
-            vk::DescriptorSetAllocateInfo alloc_info;
-            alloc_info.descriptorPool = renderer.vkctx().descriptor_pool();
-            alloc_info.descriptorSetCount = 1;
-            alloc_info.pSetLayouts = &layout;
-            _descriptor_set = std::move(renderer.vkctx().device().allocateDescriptorSetsUnique(alloc_info)[0]);
-
-            const auto& buffer = _mesh3d_uniform_buffer ? _mesh3d_uniform_buffer : renderer.empty_uniform_buffer();
-
-            vk::DescriptorBufferInfo buffer_info;
-            buffer_info.buffer = buffer->buffer();
-            buffer_info.offset = 0;
-            buffer_info.range = buffer->size();
-
-            vk::WriteDescriptorSet write;
-            write.descriptorCount = 1;
-            write.descriptorType = vk::DescriptorType::eUniformBuffer;
-            write.pBufferInfo = &buffer_info;
-            write.dstArrayElement = 0;
-            write.dstBinding = 0;
-            write.dstSet = *_descriptor_set;
-            renderer.vkctx().device().updateDescriptorSets(write, {});
-
+            _descriptor_set_needs_rebuild = true;
             init_default_textures(renderer);
         }
         _needs_update_material = false;
@@ -301,12 +383,61 @@ namespace cathedral::engine
 
             if (auto texture = scene.load_texture(tex_name); texture != nullptr)
             {
-                bind_node_texture_slot(scene.get_renderer(), std::move(texture), i);
+                bind_node_texture_slot(std::move(texture), i);
             }
         }
         _needs_update_textures = false;
     }
 
+    float mesh3d_node::projected_screen_size(const scene& scene) const
+    {
+        // Without bounds there is no way to tell, so ask for full detail
+        if (!_local_bounds.has_value())
+        {
+            return std::numeric_limits<float>::infinity();
+        }
+
+        const auto& model = get_world_model_matrix();
+        const float scale = std::max({ glm::length(glm::vec3(model[0])),
+                                       glm::length(glm::vec3(model[1])),
+                                       glm::length(glm::vec3(model[2])) });
+        const float radius = _local_bounds->radius * scale;
+
+        const auto& uniform = scene.uniform_data();
+        const glm::vec4 view_center = uniform.view3d * model * glm::vec4(_local_bounds->center, 1.0F);
+        const float distance = glm::length(glm::vec3(view_center)) - radius;
+        if (distance <= std::numeric_limits<float>::epsilon())
+        {
+            return std::numeric_limits<float>::infinity();
+        }
+
+        // Diameter in NDC units (2 per surface height) scaled to pixels
+        const auto surface_height = static_cast<float>(scene.get_renderer().vkctx().get_surface_size().y);
+        return radius * std::abs(uniform.projection3d[1][1]) * surface_height / distance;
+    }
+
+    void mesh3d_node::request_streamed_mips(scene& scene, const material& mat) const
+    {
+        auto& streamer = scene.get_renderer().get_texture_streamer();
+        const float projected_size = projected_screen_size(scene);
+
+        const auto request = [&](const std::shared_ptr<texture>& tex) {
+            if (tex && tex->is_streamed())
+            {
+                streamer.request_mip(*tex, calc_texture_streaming_mip(tex->mip_sizes()[0], projected_size, tex->mip_count()));
+            }
+        };
+
+        for (const auto& tex : _texture_slots)
+        {
+            request(tex);
+        }
+        for (const auto& tex : mat.bound_textures())
+        {
+            request(tex);
+        }
+    }
+
     void mesh3d_node::update_bindings()
     {
         if (_material.expired())
@@ -323,11 +454,7 @@ namespace cathedral::engine
 
             const auto& model = get_world_model_matrix();
             CRITICAL_CHECK(_uniform_data.size() >= offset + sizeof(model), "Attempt to write beyond bounds of uniform data");
-            if (auto* ptr = reinterpret_cast<glm::mat4*>(_uniform_data.data() + offset); *ptr != model)
-            {
-                *ptr = model;
-                _uniform_needs_update = true;
-            }
+            *reinterpret_cast<glm::mat4*>(_uniform_data.data() + offset) = model;
         }
 
         if (material->node_bindings().contains(shader_node_uniform_binding::NODE_ID))
@@ -336,12 +463,7 @@ namespace cathedral::engine
             const auto offset = material->get_node_binding_var_offset(var_name);
 
             CRITICAL_CHECK(_uniform_data.size() >= offset + sizeof(_uid), "Attempt to write beyond bounds of uniform data");
-            if (auto* ptr = reinterpret_cast<std::remove_const_t<decltype(_uid)>*>(_uniform_data.data() + offset);
-                *ptr != _uid)
-            {
-                *ptr = _uid;
-                _uniform_needs_update = true;
-            }
+            *reinterpret_cast<std::remove_const_t<decltype(_uid)>*>(_uniform_data.data() + offset) = _uid;
         }
     }
 } // namespace cathedral::engine
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include <cathedral/engine/pipeline_cache.hpp>
+
+#include <cathedral/engine/descriptor_allocator.hpp>
+
+#include <cathedral/gfx/vulkan_context.hpp>
+
+#include <bit>
+#include <utility>
+
+namespace cathedral::engine
+{
+    namespace
+    {
+        void append_spirv(std::vector<uint64_t>& key, const std::vector<uint32_t>& spirv)
+        {
+            key.push_back(spirv.size());
+            key.insert(key.end(), spirv.begin(), spirv.end());
+        }
+
+        std::vector<uint64_t> get_layout_key(const gfx::pipeline_args& args)
+        {
+            std::vector<uint64_t> key;
+            key.push_back(args.push_constant_size);
+            for (const auto& [set_index, definition, layout] : args.descriptor_sets)
+            {
+                key.push_back(set_index);
+                key.push_back(definition.entries.size());
+                for (const auto& entry : definition.entries)
+                {
+                    key.push_back(entry.binding);
+                    key.push_back(std::to_underlying(entry.type));
+                    key.push_back(entry.count);
+                    key.push_back(entry.partially_bound ? 1 : 0);
+                }
+            }
+            return key;
+        }
+
+        std::vector<uint64_t> get_pipeline_key(const gfx::pipeline_args& args, const vk::PipelineLayout layout)
+        {
+            std::vector<uint64_t> key;
+            key.push_back(std::bit_cast<uint64_t>(static_cast<VkPipelineLayout>(layout)));
+            key.push_back(args.color_blend_enable ? 1 : 0);
+            key.push_back(args.enable_depth ? 1 : 0);
+            key.push_back(args.enable_stencil ? 1 : 0);
+            key.push_back(std::to_underlying(args.input_topology));
+            key.push_back(std::to_underlying(args.polygon_mode));
+            key.push_back(args.cull_backfaces ? 1 : 0);
+            key.push_back(std::bit_cast<uint32_t>(args.line_width));
+            key.push_back(args.vertex_input.vertex_size);
+            for (const auto& [location, offset, type] : args.vertex_input.attributes)
+            {
+                key.push_back(location);
+                key.push_back(offset);
+                key.push_back(std::to_underlying(type));
+            }
+            key.push_back(args.color_attachment_formats.size());
+            for (const auto format : args.color_attachment_formats)
+            {
+                key.push_back(std::to_underlying(format));
+            }
+            key.push_back(std::to_underlying(args.depth_stencil_format));
+
+            // The whole SPIR-V rather than a hash of it, so distinct shaders can never share a pipeline. It goes last,
+            // keys differing in state compare unequal before reaching it
+            append_spirv(key, args.vertex_shader->spirv());
+            append_spirv(key, args.fragment_shader->spirv());
+            return key;
+        }
+    } // namespace
+
+    pipeline_cache::pipeline_cache(const gfx::vulkan_context& vkctx, descriptor_allocator& allocator)
+        : _vkctx(vkctx)
+        , _allocator(allocator)
+    {
+    }
+
+    void pipeline_cache::resolve_layouts(gfx::pipeline_args& args)
+    {
+        for (auto& set : args.descriptor_sets)
+        {
+            if (!set.layout)
+            {
+                set.layout = _allocator.layout(set.definition);
+            }
+        }
+        if (!args.layout)
+        {
+            args.layout = pipeline_layout(args);
+        }
+    }
+
+    std::shared_ptr<gfx::pipeline> pipeline_cache::get(gfx::pipeline_args args)
+    {
+        CRITICAL_CHECK_NOTNULL(args.vertex_shader);
+        CRITICAL_CHECK_NOTNULL(args.fragment_shader);
+
+        if (!args.layout)
+        {
+            resolve_layouts(args);
+        }
+
+        auto key = get_pipeline_key(args, args.layout);
+        {
+            const std::scoped_lock lock(_pipelines_mutex);
+            if (const auto it = _pipelines.find(key); it != _pipelines.end())
+            {
+                if (auto pipeline = it->second.lock())
+                {
+                    ++_hits;
+                    return pipeline;
+                }
+            }
+            ++_misses;
+        }
+
+        // Created outside the lock so other threads keep getting hits meanwhile
+        auto result = std::make_shared<gfx::pipeline>(std::move(args));
+
+        const std::scoped_lock lock(_pipelines_mutex);
+        std::erase_if(_pipelines, [](const auto& entry) { return entry.second.expired(); });
+
+        auto& entry = _pipelines[std::move(key)];
+        if (auto existing = entry.lock()) // Another thread created the same pipeline first
+        {
+            return existing;
+        }
+        entry = result;
+        return result;
+    }
+
+    pipeline_cache_stats pipeline_cache::stats() const
+    {
+        const std::scoped_lock lock(_pipelines_mutex);
+        return { .hits = _hits, .misses = _misses, .pipeline_count = _pipelines.size(), .layout_count = _layouts.size() };
+    }
+
+    vk::PipelineLayout pipeline_cache::pipeline_layout(const gfx::pipeline_args& args)
+    {
+        auto key = get_layout_key(args);
+        if (const auto it = _layouts.find(key); it != _layouts.end())
+        {
+            return *it->second;
+        }
+
+        std::vector<vk::DescriptorSetLayout> set_layouts;
+        set_layouts.reserve(args.descriptor_sets.size());
+        for (const auto& set : args.descriptor_sets)
+        {
+            set_layouts.push_back(set.layout);
+        }
+
+        vk::PushConstantRange push_constant_range;
+        push_constant_range.offset = 0;
+        push_constant_range.size = args.push_constant_size;
+        push_constant_range.stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+
+        vk::PipelineLayoutCreateInfo layout_info;
+        layout_info.pushConstantRangeCount = args.push_constant_size > 0 ? 1 : 0;
+        layout_info.pPushConstantRanges = &push_constant_range;
+        layout_info.pSetLayouts = set_layouts.data();
+        layout_info.setLayoutCount = static_cast<uint32_t>(set_layouts.size());
+
+        auto [it, added] = _layouts.emplace(std::move(key), _vkctx.device().createPipelineLayoutUnique(layout_info));
+        return *it->second;
+    }
+} // namespace cathedral::engine
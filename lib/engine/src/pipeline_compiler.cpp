@@ -0,0 +1,86 @@
+#include <cathedral/engine/pipeline_compiler.hpp>
+
+namespace cathedral::engine
+{
+    pipeline_compiler::pipeline_compiler(const pipeline_compiler_args args)
+        : _args(args)
+    {
+        for (uint32_t i = 0; i < _args.thread_count; ++i)
+        {
+            _workers.emplace_back([this](const std::stop_token& stop) { worker_main(stop); });
+        }
+    }
+
+    pipeline_compiler::~pipeline_compiler()
+    {
+        shutdown();
+    }
+
+    size_t pipeline_compiler::pending_jobs() const
+    {
+        const std::scoped_lock lock(_mutex);
+        return _jobs.size();
+    }
+
+    void pipeline_compiler::wait_idle()
+    {
+        std::unique_lock lock(_mutex);
+        _idle_cv.wait(lock, [this] { return _jobs.empty() && _running_jobs == 0; });
+    }
+
+    void pipeline_compiler::shutdown()
+    {
+        // Destroyed outside the lock, which breaks their promises
+        std::deque<std::move_only_function<void()>> dropped_jobs;
+        {
+            const std::scoped_lock lock(_mutex);
+            for (auto& worker : _workers)
+            {
+                worker.request_stop();
+            }
+            dropped_jobs.swap(_jobs);
+        }
+        _work_cv.notify_all();
+        _idle_cv.notify_all();
+        _workers.clear();
+    }
+
+    void pipeline_compiler::push(std::move_only_function<void()> job)
+    {
+        {
+            const std::scoped_lock lock(_mutex);
+            _jobs.push_back(std::move(job));
+        }
+        _work_cv.notify_one();
+    }
+
+    void pipeline_compiler::worker_main(const std::stop_token& stop)
+    {
+        while (true)
+        {
+            std::move_only_function<void()> job;
+            {
+                std::unique_lock lock(_mutex);
+                if (!_work_cv.wait(lock, stop, [this] { return !_jobs.empty(); }))
+                {
+                    return;
+                }
+                job = std::move(_jobs.front());
+                _jobs.pop_front();
+                ++_running_jobs;
+            }
+            job();
+
+            bool idle = false;
+            {
+                const std::scoped_lock lock(_mutex);
+                --_running_jobs;
+                idle = _jobs.empty() && _running_jobs == 0;
+            }
+            if (idle)
+            {
+                _idle_cv.notify_all();
+            }
+        }
+    }
+} // namespace cathedral::engine
@@ -0,0 +1,81 @@
+#include <cathedral/engine/range_allocator.hpp>
+
+#include <cathedral/core.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace cathedral::engine
+{
+    range_allocator::range_allocator(const uint32_t capacity)
+        : _capacity(capacity)
+    {
+        if (_capacity > 0)
+        {
+            _free_ranges.emplace(0, _capacity);
+        }
+    }
+
+    std::optional<uint32_t> range_allocator::allocate(const uint32_t size)
+    {
+        CRITICAL_CHECK(size > 0, "Attempt to allocate an empty range");
+
+        const auto it = std::ranges::find_if(_free_ranges, [size](const auto& range) { return range.second >= size; });
+        if (it == _free_ranges.end())
+        {
+            return std::nullopt;
+        }
+
+        const auto [offset, free_size] = *it;
+        _free_ranges.erase(it);
+        if (free_size > size)
+        {
+            _free_ranges.emplace(offset + size, free_size - size);
+        }
+
+        _used += size;
+        return offset;
+    }
+
+    void range_allocator::free(const uint32_t offset, const uint32_t size)
+    {
+        CRITICAL_CHECK(size > 0 && offset + size <= _capacity, "Attempt to free a range out of bounds");
+        CRITICAL_CHECK(size <= _used, "Attempt to free more than was allocated");
+
+        uint32_t begin = offset;
+        uint32_t end = offset + size;
+
+        auto next = _free_ranges.lower_bound(offset);
+        CRITICAL_CHECK(next == _free_ranges.end() || next->first >= end, "Attempt to free a range that is already free");
+
+        if (next != _free_ranges.begin())
+        {
+            const auto prev = std::prev(next);
+            CRITICAL_CHECK(prev->first + prev->second <= begin, "Attempt to free a range that is already free");
+            if (prev->first + prev->second == begin)
+            {
+                begin = prev->first;
+                _free_ranges.erase(prev);
+            }
+        }
+
+        if (next != _free_ranges.end() && next->first == end)
+        {
+            end += next->second;
+            _free_ranges.erase(next);
+        }
+
+        _free_ranges.emplace(begin, end - begin);
+        _used -= size;
+    }
+
+    uint32_t range_allocator::largest_free_range() const
+    {
+        uint32_t result = 0;
+        for (const auto& range : _free_ranges)
+        {
+            result = std::max(result, range.second);
+        }
+        return result;
+    }
+} // namespace cathedral::engine
@@ -1,6 +1,7 @@
 #include <cathedral/engine/renderer.hpp>
 
 #include <cathedral/engine/default_resources.hpp>
+#include <cathedral/engine/mesh.hpp>
 #include <cathedral/engine/shader_preprocess.hpp>
 
 #include <cathedral/gfx/shader_reflection.hpp>
@@ -9,6 +10,8 @@
 #include <ien/math_utils.hpp>
 
 #include <magic_enum.hpp>
+
+#include <algorithm>
 #include <utility>
 
 namespace cathedral::engine
@@ -21,7 +24,26 @@ namespace cathedral::engine
     renderer::renderer(renderer_args args)
         : _args(std::move(args))
         , _uid(uid_counter++)
+        , _geometry_pool(_args.swapchain->vkctx(), static_cast<uint32_t>(mesh::vertex_size_bytes()), _args.geometry_pool)
+        , _descriptor_allocator(
+              _args.swapchain->vkctx(),
+              [this] {
+                  auto allocator_args = _args.descriptor_allocator;
+                  allocator_args.frames_in_flight = _args.frames_in_flight;
+                  return allocator_args;
+              }())
+        , _pipeline_cache(_args.swapchain->vkctx(), _descriptor_allocator)
+        , _texture_streamer(_args.texture_streaming, _args.frames_in_flight)
+        , _sampler_cache(_args.swapchain->vkctx())
+        , _uniform_arena(_args.swapchain->vkctx(), _args.uniform_arena)
     {
+        CRITICAL_CHECK(
+            _args.frames_in_flight > 0 && _args.frames_in_flight <= MAX_FRAMES_IN_FLIGHT,
+            "Invalid frames in flight count");
+        CRITICAL_CHECK(
+            _args.uniform_arena.frame_count >= _args.frames_in_flight,
+            "Uniform arena regions would be reused by a frame in flight");
+
         const auto surf_size = vkctx().get_surface_size();
 
         gfx::depthstencil_attachment_args depth_attachment_args;
@@ -31,38 +53,90 @@ namespace cathedral::engine
 
         _depth_attachment = std::make_unique<gfx::depthstencil_attachment>(depth_attachment_args);
 
-        _upload_queue = std::make_unique<upload_queue>(vkctx(), 128 * 1024 * 1024);
+        _upload_queue = std::make_unique<upload_queue>(vkctx(), _args.staging_buffer_size, _args.frames_in_flight);
 
-        _frame_fence = vkctx().create_signaled_fence();
-        _render_opaque_ready_semaphore = vkctx().create_default_semaphore();
-        _render_transparent_ready_semaphore = vkctx().create_default_semaphore();
-        _render_overlay_ready_semaphore = vkctx().create_default_semaphore();
-        _present_ready_semaphore = vkctx().create_default_semaphore();
+        pipeline_compiler_args compiler_args;
+        compiler_args.thread_count = _args.pipeline_compile_threads;
+        _pipeline_compiler = std::make_unique<pipeline_compiler>(compiler_args);
 
-        _render_cmdbuff_opaque = vkctx().create_primary_commandbuffer();
-        _render_cmdbuff_transparent = vkctx().create_primary_commandbuffer();
-        _render_cmdbuff_overlay = vkctx().create_primary_commandbuffer();
+        if (_args.bindless_textures)
+        {
+            auto table_args = _args.bindless_texture_table;
+            table_args.frames_in_flight = _args.frames_in_flight;
+            _bindless_textures = std::make_unique<bindless_texture_table>(vkctx(), table_args);
+        }
+
+        // Streamed textures give way first when device local memory runs low. Events come every frame while a heap is
+        // over budget, so their budget follows the usage until the pressure ends
+        _memory_budget_subscription = vkctx().memory().subscribe([this](const gfx::memory_budget_event& event) {
+            if (!event.device_local)
+            {
+                return;
+            }
+            _texture_streamer.set_vram_budget(calc_texture_streaming_budget(
+                event,
+                _args.texture_streaming.vram_budget,
+                _texture_streamer.resident_size_bytes()));
+        });
 
+        init_frame_resources();
         init_default_texture();
-        init_empty_uniform_buffer();
+
+        if (_args.recording_threads > 0)
+        {
+            draw_recorder_args recorder_args;
+            recorder_args.vkctx = &vkctx();
+            recorder_args.thread_count = _args.recording_threads;
+            recorder_args.frames_in_flight = _args.frames_in_flight;
+            recorder_args.draws_per_chunk = _args.draws_per_chunk;
+            recorder_args.color_format = _args.swapchain->swapchain_image_format();
+            recorder_args.depthstencil_format = gfx::depthstencil_attachment::format();
+            _draw_recorder = std::make_unique<draw_recorder>(recorder_args);
+        }
+    }
+
+    renderer::~renderer()
+    {
+        vkctx().device().waitIdle();
+    }
+
+    void renderer::wait_pipeline_compiles()
+    {
+        _pipeline_compiler->wait_idle();
     }
 
     void renderer::begin_frame()
     {
-        std::vector<vk::Fence> wait_fences = { *_frame_fence };
+        // Only the frame that last used this frame's resources has to be done, newer ones may still be in flight
+        std::vector<vk::Fence> wait_fences = { *current_frame_resources().frame_fence };
         if (_upload_queue->fence_needs_waiting())
         {
             wait_fences.push_back(_upload_queue->get_fence());
             _upload_queue->notify_fence_waited();
         }
 
+        const auto wait_start = std::chrono::steady_clock::now();
         if (const vk::Result wait_fence_result = vkctx().device().waitForFences(wait_fences, vk::True, UINT64_MAX);
             wait_fence_result != vk::Result::eSuccess)
         {
             CRITICAL_ERROR("Unable to wait for frame fence!");
         }
+        _last_frame_fence_wait = std::chrono::steady_clock::now() - wait_start;
         vkctx().device().resetFences(wait_fences);
 
+        release_retired_resources();
+        vkctx().memory().check_budgets();
+        _descriptor_allocator.begin_frame(_frame_count);
+        if (_bindless_textures)
+        {
+            _bindless_textures->begin_frame(_frame_count);
+        }
+        _uniform_arena.begin_frame();
+        if (_draw_recorder)
+        {
+            _draw_recorder->begin_frame(static_cast<uint32_t>(_frame_count % _frames.size()));
+        }
+
         auto surf_size = vkctx().get_surface_size();
         while (std::cmp_not_equal(surf_size.x, _args.swapchain->extent().width) ||
                std::cmp_not_equal(surf_size.y, _args.swapchain->extent().height))
@@ -85,6 +159,26 @@ namespace cathedral::engine
         ++_frame_count;
     }
 
+    void renderer::draw(const render_cmdbuff_type type, const draw_command& command)
+    {
+        // Sets must be written before a command buffer binds them
+        if (!_descriptor_writes.empty())
+        {
+            _descriptor_writes.flush(vkctx());
+        }
+
+        if (_draw_recorder)
+        {
+            _pending_draws[std::to_underlying(type)].push_back(command);
+        }
+        else
+        {
+            auto& last_draw = _last_inline_draws[std::to_underlying(type)];
+            record_draw(render_cmdbuff(type), command, last_draw.has_value() ? &*last_draw : nullptr);
+            last_draw = command;
+        }
+    }
+
     void renderer::recreate_swapchain_dependent_resources() const
     {
         const auto surf_size = vkctx().get_surface_size();
@@ -103,7 +197,7 @@ namespace cathedral::engine
         const uint32_t mip_levels,
         const vk::Filter min_filter,
         const vk::Filter mag_filter,
-        const ien::resize_filter mipgen_filter,
+        const mip_filter mipgen_filter,
         const vk::SamplerAddressMode address_mode,
         const uint32_t anisotropy)
     {
@@ -121,7 +215,7 @@ namespace cathedral::engine
         args.sampler_info.anisotropy_level = anisotropy;
         args.sampler_info.address_mode = address_mode;
 
-        auto result = std::make_shared<texture>(args, *_upload_queue);
+        auto result = std::make_shared<texture>(args, *_upload_queue, _sampler_cache);
         _textures.emplace(std::move(name), result);
         return result;
     }
@@ -132,7 +226,7 @@ namespace cathedral::engine
         const uint32_t mip_levels,
         const vk::Filter min_filter,
         const vk::Filter mag_filter,
-        const ien::resize_filter mipgen_filter,
+        const mip_filter mipgen_filter,
         const vk::SamplerAddressMode address_mode,
         const uint32_t anisotropy)
     {
@@ -154,18 +248,29 @@ namespace cathedral::engine
         args.format = texture_format::DXT5_BC3_SRGB;
         args.path = image_path;
 
-        auto result = std::make_shared<texture>(args, *_upload_queue);
+        auto result = std::make_shared<texture>(args, *_upload_queue, _sampler_cache);
         _textures.emplace(std::move(name), result);
         return result;
     }
 
     std::shared_ptr<texture> renderer::create_color_texture_from_data(const texture_args_from_data& args)
     {
-        auto result = std::make_shared<texture>(args, *_upload_queue);
+        auto result = std::make_shared<texture>(args, *_upload_queue, _sampler_cache);
         _textures.emplace(args.name, result);
         return result;
     }
 
+    std::shared_ptr<texture> renderer::create_streamed_texture(texture_args_streamed args)
+    {
+        CRITICAL_CHECK(!_textures.contains(args.name), "Attempt to create texture with existing name");
+
+        auto name = args.name;
+        auto result = std::make_shared<texture>(std::move(args), *_upload_queue, _sampler_cache);
+        _texture_streamer.add_texture(result);
+        _textures.emplace(std::move(name), result);
+        return result;
+    }
+
     std::weak_ptr<material> renderer::create_material(material_args args)
     {
         CRITICAL_CHECK(!_materials.contains(args.name), "Attempt to create material with existing name");
@@ -196,6 +301,7 @@ namespace cathedral::engine
         target_image_args.tiling = vk::ImageTiling::eLinear;
         target_image_args.usage_flags = vk::ImageUsageFlagBits::eTransferDst;
         target_image_args.allow_host_memory_mapping = true;
+        target_image_args.category = gfx::memory_category::STAGING;
         const gfx::image target_image(target_image_args);
 
         vk::ImageSubresource target_image_subresource;
@@ -213,7 +319,7 @@ namespace cathedral::engine
         {
             vk::ImageMemoryBarrier2 barrier;
             barrier.image = swapchain_image;
-            barrier.oldLayout = vk::ImageLayout::ePresentSrcKHR;
+            barrier.oldLayout = swapchain->present_layout();
             barrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
             barrier.srcAccessMask = vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite;
             barrier.srcStageMask = vk::PipelineStageFlagBits2::eAllCommands;
@@ -277,7 +383,7 @@ namespace cathedral::engine
             vk::ImageMemoryBarrier2 barrier;
             barrier.image = swapchain_image;
             barrier.oldLayout = vk::ImageLayout::eTransferSrcOptimal;
-            barrier.newLayout = vk::ImageLayout::ePresentSrcKHR;
+            barrier.newLayout = swapchain->present_layout();
             barrier.srcAccessMask = vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite;
             barrier.srcStageMask = vk::PipelineStageFlagBits2::eAllCommands;
             barrier.srcQueueFamilyIndex = vkctx.graphics_queue_family_index();
@@ -322,6 +428,35 @@ namespace cathedral::engine
         return result;
     }
 
+    void renderer::init_frame_resources()
+    {
+        _args.swapchain->set_frames_in_flight(_args.frames_in_flight);
+
+        _frames.resize(_args.frames_in_flight);
+        for (auto& frame : _frames)
+        {
+            frame.frame_fence = vkctx().create_signaled_fence();
+            frame.render_opaque_ready_semaphore = vkctx().create_default_semaphore();
+            frame.render_transparent_ready_semaphore = vkctx().create_default_semaphore();
+            frame.render_overlay_ready_semaphore = vkctx().create_default_semaphore();
+            frame.present_ready_semaphore = vkctx().create_default_semaphore();
+
+            frame.render_cmdbuff_opaque = vkctx().create_primary_commandbuffer();
+            frame.render_cmdbuff_transparent = vkctx().create_primary_commandbuffer();
+            frame.render_cmdbuff_overlay = vkctx().create_primary_commandbuffer();
+        }
+    }
+
+    void renderer::release_retired_resources()
+    {
+        // Frames up to (current - frames in flight) are done once the current frame's fence has been waited
+        while (!_retired_resources.empty() &&
+               _retired_resources.front().first + _args.frames_in_flight <= _frame_count)
+        {
+            _retired_resources.pop_front();
+        }
+    }
+
     void renderer::reload_depthstencil_attachment() const
     {
         const auto surf_size = vkctx().get_surface_size();
@@ -340,44 +475,96 @@ namespace cathedral::engine
         begin_transparent_pass(surf_size);
         begin_overlay_pass(surf_size);
 
-        vk::Viewport viewport;
-        viewport.x = 0;
-        viewport.y = 0;
-        viewport.width = static_cast<float>(surf_size.x);
-        viewport.height = static_cast<float>(surf_size.y);
-        viewport.minDepth = 0.0F;
-        viewport.maxDepth = 1.0F;
-
-        _render_cmdbuff_opaque->setViewport(0, viewport);
-        _render_cmdbuff_transparent->setViewport(0, viewport);
-        _render_cmdbuff_overlay->setViewport(0, viewport);
-
-        vk::Rect2D scissor;
-        scissor.offset = vk::Offset2D(0, 0);
-        scissor.extent = vk::Extent2D(surf_size.x, surf_size.y);
-
-        _render_cmdbuff_opaque->setScissor(0, scissor);
-        _render_cmdbuff_transparent->setScissor(0, scissor);
-        _render_cmdbuff_overlay->setScissor(0, scissor);
+        _viewport.x = 0;
+        _viewport.y = 0;
+        _viewport.width = static_cast<float>(surf_size.x);
+        _viewport.height = static_cast<float>(surf_size.y);
+        _viewport.minDepth = 0.0F;
+        _viewport.maxDepth = 1.0F;
+
+        _scissor.offset = vk::Offset2D(0, 0);
+        _scissor.extent = vk::Extent2D(surf_size.x, surf_size.y);
+
+        // Passes that only execute secondaries take no other commands, the secondaries set their own state
+        if (_draw_recorder)
+        {
+            return;
+        }
+
+        for (auto& last_draw : _last_inline_draws)
+        {
+            last_draw.reset();
+        }
+
+        const auto& frame = current_frame_resources();
+        frame.render_cmdbuff_opaque->setViewport(0, _viewport);
+        frame.render_cmdbuff_transparent->setViewport(0, _viewport);
+        frame.render_cmdbuff_overlay->setViewport(0, _viewport);
+
+        frame.render_cmdbuff_opaque->setScissor(0, _scissor);
+        frame.render_cmdbuff_transparent->setScissor(0, _scissor);
+        frame.render_cmdbuff_overlay->setScissor(0, _scissor);
+    }
+
+    void renderer::record_pending_draws()
+    {
+        const auto secondaries = _draw_recorder->record(_pending_draws, _viewport, _scissor);
+
+        using enum render_cmdbuff_type;
+        for (const auto type : { OPAQUE, TRANSPARENT, OVERLAY })
+        {
+            if (const auto& pass_secondaries = secondaries[std::to_underlying(type)]; !pass_secondaries.empty())
+            {
+                render_cmdbuff(type).executeCommands(pass_secondaries);
+            }
+        }
+
+        for (auto& draws : _pending_draws)
+        {
+            draws.clear();
+        }
     }
 
     void renderer::submit_prerender_cmdbuffs()
     {
         _upload_queue->prepare_to_submit();
 
-        const auto image_ready_semaphore = _args.swapchain->image_ready_semaphore();
-        constexpr vk::PipelineStageFlags WAIT_STAGE_FLAGS = vk::PipelineStageFlagBits::eAllCommands;
+        std::vector<vk::Semaphore> wait_semaphores;
+        std::vector<vk::PipelineStageFlags> wait_stages;
+        std::vector<uint64_t> wait_values;
+
+        // Offscreen targets have nothing to wait for before rendering
+        if (const vk::Semaphore image_ready = _args.swapchain->image_ready_semaphore())
+        {
+            wait_semaphores.push_back(image_ready);
+            wait_stages.push_back(vk::PipelineStageFlagBits::eAllCommands);
+            wait_values.push_back(0);
+        }
+
+        // Uploads done on the transfer queue are acquired by this submission
+        const uint64_t transfer_wait_value = _upload_queue->transfer_wait_value();
+        if (transfer_wait_value != 0)
+        {
+            wait_semaphores.push_back(_upload_queue->transfer_timeline());
+            wait_stages.push_back(vk::PipelineStageFlagBits::eAllCommands);
+            wait_values.push_back(transfer_wait_value);
+        }
 
         const std::vector<vk::CommandBuffer> cmdbuffs = { _upload_queue->get_cmdbuff() };
 
+        vk::TimelineSemaphoreSubmitInfo timeline_info;
+        timeline_info.waitSemaphoreValueCount = static_cast<uint32_t>(wait_values.size());
+        timeline_info.pWaitSemaphoreValues = wait_values.data();
+
         vk::SubmitInfo submit_info;
+        submit_info.pNext = transfer_wait_value != 0 ? &timeline_info : nullptr;
         submit_info.commandBufferCount = static_cast<uint32_t>(cmdbuffs.size());
         submit_info.pCommandBuffers = cmdbuffs.data();
         submit_info.signalSemaphoreCount = 1;
-        submit_info.waitSemaphoreCount = 1;
-        submit_info.pSignalSemaphores = &*_render_opaque_ready_semaphore;
-        submit_info.pWaitSemaphores = &image_ready_semaphore;
-        submit_info.pWaitDstStageMask = &WAIT_STAGE_FLAGS;
+        submit_info.waitSemaphoreCount = static_cast<uint32_t>(wait_semaphores.size());
+        submit_info.pSignalSemaphores = &*current_frame_resources().render_opaque_ready_semaphore;
+        submit_info.pWaitSemaphores = wait_semaphores.data();
+        submit_info.pWaitDstStageMask = wait_stages.data();
 
         vkctx().graphics_queue().submit(submit_info, _upload_queue->get_fence());
 
@@ -386,58 +573,76 @@ namespace cathedral::engine
 
     void renderer::submit_render_cmdbuff()
     {
-        _render_cmdbuff_opaque->endRendering();
-        _render_cmdbuff_transparent->endRendering();
-        _render_cmdbuff_overlay->endRendering();
+        // Writes queued after the last draw, for sets first bound next frame
+        if (!_descriptor_writes.empty())
+        {
+            _descriptor_writes.flush(vkctx());
+        }
+
+        if (_draw_recorder)
+        {
+            record_pending_draws();
+        }
 
-        _args.swapchain->transition_color_present(_swapchain_image_index, *_render_cmdbuff_overlay);
+        const auto& frame = current_frame_resources();
 
-        _render_cmdbuff_opaque->end();
-        _render_cmdbuff_transparent->end();
-        _render_cmdbuff_overlay->end();
+        frame.render_cmdbuff_opaque->endRendering();
+        frame.render_cmdbuff_transparent->endRendering();
+        frame.render_cmdbuff_overlay->endRendering();
+
+        _args.swapchain->transition_color_present(_swapchain_image_index, *frame.render_cmdbuff_overlay);
+
+        frame.render_cmdbuff_opaque->end();
+        frame.render_cmdbuff_transparent->end();
+        frame.render_cmdbuff_overlay->end();
 
         constexpr vk::PipelineStageFlags WAIT_STAGE_FLAGS = vk::PipelineStageFlagBits::eAllCommands;
 
         vk::SubmitInfo submit_opaque_info;
         submit_opaque_info.commandBufferCount = 1;
-        submit_opaque_info.pCommandBuffers = &*_render_cmdbuff_opaque;
+        submit_opaque_info.pCommandBuffers = &*frame.render_cmdbuff_opaque;
         submit_opaque_info.signalSemaphoreCount = 1;
         submit_opaque_info.waitSemaphoreCount = 1;
-        submit_opaque_info.pSignalSemaphores = &*_render_transparent_ready_semaphore;
-        submit_opaque_info.pWaitSemaphores = &*_render_opaque_ready_semaphore;
+        submit_opaque_info.pSignalSemaphores = &*frame.render_transparent_ready_semaphore;
+        submit_opaque_info.pWaitSemaphores = &*frame.render_opaque_ready_semaphore;
         submit_opaque_info.pWaitDstStageMask = &WAIT_STAGE_FLAGS;
 
         vk::SubmitInfo submit_transparent_info;
         submit_transparent_info.commandBufferCount = 1;
-        submit_transparent_info.pCommandBuffers = &*_render_cmdbuff_transparent;
+        submit_transparent_info.pCommandBuffers = &*frame.render_cmdbuff_transparent;
         submit_transparent_info.signalSemaphoreCount = 1;
         submit_transparent_info.waitSemaphoreCount = 1;
-        submit_transparent_info.pSignalSemaphores = &*_render_overlay_ready_semaphore;
-        submit_transparent_info.pWaitSemaphores = &*_render_transparent_ready_semaphore;
+        submit_transparent_info.pSignalSemaphores = &*frame.render_overlay_ready_semaphore;
+        submit_transparent_info.pWaitSemaphores = &*frame.render_transparent_ready_semaphore;
         submit_transparent_info.pWaitDstStageMask = &WAIT_STAGE_FLAGS;
 
         vk::SubmitInfo submit_overlay_info;
         submit_overlay_info.commandBufferCount = 1;
-        submit_overlay_info.pCommandBuffers = &*_render_cmdbuff_overlay;
-        submit_overlay_info.signalSemaphoreCount = 1;
+        submit_overlay_info.pCommandBuffers = &*frame.render_cmdbuff_overlay;
+        // Nothing waits on the present semaphore without a swapchain, and a binary semaphore can't be signalled twice
+        submit_overlay_info.signalSemaphoreCount = _args.swapchain->get() ? 1 : 0;
         submit_overlay_info.waitSemaphoreCount = 1;
-        submit_overlay_info.pSignalSemaphores = &*_present_ready_semaphore;
-        submit_overlay_info.pWaitSemaphores = &*_render_overlay_ready_semaphore;
+        submit_overlay_info.pSignalSemaphores = &*frame.present_ready_semaphore;
+        submit_overlay_info.pWaitSemaphores = &*frame.render_overlay_ready_semaphore;
         submit_overlay_info.pWaitDstStageMask = &WAIT_STAGE_FLAGS;
 
-        vkctx().graphics_queue().submit({ submit_opaque_info, submit_transparent_info, submit_overlay_info }, *_frame_fence);
+        vkctx().graphics_queue().submit({ submit_opaque_info, submit_transparent_info, submit_overlay_info }, *frame.frame_fence);
     }
 
     void renderer::submit_present()
     {
         const vk::SwapchainKHR swapchain = _args.swapchain->get();
+        if (!swapchain)
+        {
+            return;
+        }
 
         vk::PresentInfoKHR present_info;
         present_info.pImageIndices = &_swapchain_image_index;
         present_info.pSwapchains = &swapchain;
         present_info.swapchainCount = 1;
         present_info.waitSemaphoreCount = 1;
-        present_info.pWaitSemaphores = &*_present_ready_semaphore;
+        present_info.pWaitSemaphores = &*current_frame_resources().present_ready_semaphore;
         present_info.pResults = nullptr;
 
         try
@@ -469,21 +674,29 @@ namespace cathedral::engine
             create_color_texture(DEFAULT_TEXTURE_NAME, default_texture_image, 8, vk::Filter::eNearest, vk::Filter::eNearest);
     }
 
-    void renderer::init_empty_uniform_buffer()
-    {
-        gfx::uniform_buffer_args args;
-        args.size = 4;
-        args.vkctx = &vkctx();
-
-        _empty_uniform_buffer = std::make_unique<gfx::uniform_buffer>(args);
-    }
-
     void renderer::begin_opaque_pass(glm::ivec2 surf_size)
     {
-        _render_cmdbuff_opaque->reset();
-        _render_cmdbuff_opaque->begin(vk::CommandBufferBeginInfo{});
+        const auto& cmdbuff = current_frame_resources().render_cmdbuff_opaque;
+        cmdbuff->reset();
+        cmdbuff->begin(vk::CommandBufferBeginInfo{});
+
+        _args.swapchain->transition_undefined_color(_swapchain_image_index, *cmdbuff);
 
-        _args.swapchain->transition_undefined_color(_swapchain_image_index, *_render_cmdbuff_opaque);
+        // The depth attachment is shared by every frame, the previous frame may still be using it
+        {
+            vk::MemoryBarrier2 depth_barrier;
+            depth_barrier.srcStageMask =
+                vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests;
+            depth_barrier.srcAccessMask = vk::AccessFlagBits2::eDepthStencilAttachmentWrite;
+            depth_barrier.dstStageMask = vk::PipelineStageFlagBits2::eEarlyFragmentTests;
+            depth_barrier.dstAccessMask = vk::AccessFlagBits2::eDepthStencilAttachmentRead |
+                                          vk::AccessFlagBits2::eDepthStencilAttachmentWrite;
+
+            vk::DependencyInfo dependency_info;
+            dependency_info.memoryBarrierCount = 1;
+            dependency_info.pMemoryBarriers = &depth_barrier;
+            cmdbuff->pipelineBarrier2(dependency_info);
+        }
 
         vk::RenderingAttachmentInfo opaque_pass_color_attachment_info;
         opaque_pass_color_attachment_info.clearValue.color.float32 = std::array<float, 4>{ 0.0F, 0.0F, 0.0F, 1.0F };
@@ -518,14 +731,19 @@ namespace cathedral::engine
         opaque_pass_rendering_info.renderArea.offset = vk::Offset2D(0, 0);
         opaque_pass_rendering_info.renderArea.extent = vk::Extent2D(surf_size.x, surf_size.y);
         opaque_pass_rendering_info.viewMask = 0;
+        if (_draw_recorder)
+        {
+            opaque_pass_rendering_info.flags = vk::RenderingFlagBits::eContentsSecondaryCommandBuffers;
+        }
 
-        _render_cmdbuff_opaque->beginRendering(opaque_pass_rendering_info);
+        cmdbuff->beginRendering(opaque_pass_rendering_info);
     }
 
     void renderer::begin_transparent_pass(glm::ivec2 surf_size)
     {
-        _render_cmdbuff_transparent->reset();
-        _render_cmdbuff_transparent->begin(vk::CommandBufferBeginInfo{});
+        const auto& cmdbuff = current_frame_resources().render_cmdbuff_transparent;
+        cmdbuff->reset();
+        cmdbuff->begin(vk::CommandBufferBeginInfo{});
 
         vk::RenderingAttachmentInfo transparent_pass_color_attachment_info;
         transparent_pass_color_attachment_info.clearValue.color.float32 = std::array<float, 4>{ 0.0F, 0.0F, 0.0F, 1.0F };
@@ -560,14 +778,19 @@ namespace cathedral::engine
         transparent_pass_rendering_info.renderArea.offset = vk::Offset2D(0, 0);
         transparent_pass_rendering_info.renderArea.extent = vk::Extent2D(surf_size.x, surf_size.y);
         transparent_pass_rendering_info.viewMask = 0;
+        if (_draw_recorder)
+        {
+            transparent_pass_rendering_info.flags = vk::RenderingFlagBits::eContentsSecondaryCommandBuffers;
+        }
 
-        _render_cmdbuff_transparent->beginRendering(transparent_pass_rendering_info);
+        cmdbuff->beginRendering(transparent_pass_rendering_info);
     }
 
     void renderer::begin_overlay_pass(glm::ivec2 surf_size)
     {
-        _render_cmdbuff_overlay->reset();
-        _render_cmdbuff_overlay->begin(vk::CommandBufferBeginInfo{});
+        const auto& cmdbuff = current_frame_resources().render_cmdbuff_overlay;
+        cmdbuff->reset();
+        cmdbuff->begin(vk::CommandBufferBeginInfo{});
 
         vk::RenderingAttachmentInfo overlay_pass_color_attachment_info;
         overlay_pass_color_attachment_info.clearValue.color.float32 = std::array<float, 4>{ 0.0F, 0.0F, 0.0F, 1.0F };
@@ -602,7 +825,11 @@ namespace cathedral::engine
         overlay_pass_rendering_info.renderArea.offset = vk::Offset2D(0, 0);
         overlay_pass_rendering_info.renderArea.extent = vk::Extent2D(surf_size.x, surf_size.y);
         overlay_pass_rendering_info.viewMask = 0;
+        if (_draw_recorder)
+        {
+            overlay_pass_rendering_info.flags = vk::RenderingFlagBits::eContentsSecondaryCommandBuffers;
+        }
 
-        _render_cmdbuff_overlay->beginRendering(overlay_pass_rendering_info);
+        cmdbuff->beginRendering(overlay_pass_rendering_info);
     }
 } // namespace cathedral::engine
@@ -0,0 +1,45 @@
+#include <cathedral/engine/sampler_cache.hpp>
+
+#include <functional>
+
+namespace cathedral::engine
+{
+    sampler_cache::sampler_cache(const gfx::vulkan_context& vkctx)
+        : _vkctx(vkctx)
+    {
+    }
+
+    std::shared_ptr<gfx::sampler> sampler_cache::get(const gfx::sampler_info& info)
+    {
+        if (const auto it = _samplers.find(info); it != _samplers.end())
+        {
+            ++_hits;
+            return it->second;
+        }
+
+        ++_misses;
+        auto result = std::make_shared<gfx::sampler>(&_vkctx, info);
+        _samplers.emplace(info, result);
+        return result;
+    }
+
+    sampler_cache_stats sampler_cache::stats() const
+    {
+        return { .hits = _hits, .misses = _misses, .sampler_count = _samplers.size() };
+    }
+
+    size_t sampler_cache::info_hash::operator()(const gfx::sampler_info& info) const
+    {
+        size_t result = 0;
+        const auto combine = [&result](const size_t value) {
+            result ^= value + 0x9E3779B97F4A7C15ULL + (result << 6) + (result >> 2);
+        };
+
+        combine(std::hash<uint32_t>{}(static_cast<uint32_t>(info.address_mode)));
+        combine(std::hash<uint32_t>{}(static_cast<uint32_t>(info.mipmap_mode)));
+        combine(std::hash<uint32_t>{}(static_cast<uint32_t>(info.mag_filter)));
+        combine(std::hash<uint32_t>{}(static_cast<uint32_t>(info.min_filter)));
+        combine(std::hash<uint32_t>{}(info.anisotropy_level));
+        return result;
+    }
+} // namespace cathedral::engine
@@ -38,13 +38,6 @@ namespace cathedral::engine
         CRITICAL_CHECK_NOTNULL(_args.loaders.mesh_loader);
         CRITICAL_CHECK_NOTNULL(_args.loaders.texture_loader);
 
-        gfx::uniform_buffer_args uniform_buffer_args;
-        uniform_buffer_args.size = sizeof(scene_uniform_data);
-        uniform_buffer_args.vkctx = &get_renderer().vkctx();
-
-        _uniform_buffer = std::make_unique<gfx::uniform_buffer>(uniform_buffer_args);
-
-        init_descriptor_set_layout();
         init_descriptor_set();
 
         _previous_frame_timepoint = scene_clock::now();
@@ -81,15 +74,15 @@ namespace cathedral::engine
 
         get_renderer().begin_frame();
 
+        // Residency changes replace image views, so they go before any descriptor gets written this frame
+        get_renderer().get_texture_streamer().update(get_renderer().get_upload_queue(), get_renderer().current_frame());
+
         func(deltatime_s);
         _last_deltatime = deltatime_s;
 
         _scene_uniform_data.deltatime = static_cast<float>(deltatime_s);
         _scene_uniform_data.frame_index = static_cast<uint32_t>(get_renderer().current_frame());
-        get_renderer().get_upload_queue().update_buffer(
-            *_uniform_buffer,
-            0,
-            std::span<const scene_uniform_data>{ &_scene_uniform_data, 1 });
+        _uniform_offset = get_renderer().get_uniform_arena().write(_scene_uniform_data);
 
         for (const auto& mat : get_renderer().materials() | std::views::values)
         {
@@ -199,7 +192,7 @@ namespace cathedral::engine
         gfx::pipeline_descriptor_set result;
         result.set_index = 0;
         result.definition.entries = {
-            gfx::descriptor_set_entry(result.set_index, 0, gfx::descriptor_type::UNIFORM, 1) // scene uniform data
+            gfx::descriptor_set_entry(result.set_index, 0, gfx::descriptor_type::UNIFORM_DYNAMIC, 1) // scene uniform data
         };
 
         return result;
@@ -282,33 +275,15 @@ namespace cathedral::engine
         }
     }
 
-    void scene::init_descriptor_set_layout()
-    {
-        const auto& [set_index, definition] = descriptor_set_definition();
-        _scene_descriptor_set_layout = definition.create_descriptor_set_layout(get_renderer().vkctx());
-    }
-
     void scene::init_descriptor_set()
     {
-        vk::DescriptorSetAllocateInfo alloc_info;
-        alloc_info.descriptorPool = get_renderer().vkctx().descriptor_pool();
-        alloc_info.descriptorSetCount = 1;
-        alloc_info.pSetLayouts = &*_scene_descriptor_set_layout;
-
-        _scene_descriptor_set = std::move(get_renderer().vkctx().device().allocateDescriptorSetsUnique(alloc_info)[0]);
-
-        vk::DescriptorBufferInfo buffer_info;
-        buffer_info.buffer = _uniform_buffer->buffer();
-        buffer_info.offset = 0;
-        buffer_info.range = _uniform_buffer->size();
-
-        vk::WriteDescriptorSet write;
-        write.descriptorCount = 1;
-        write.descriptorType = vk::DescriptorType::eUniformBuffer;
-        write.pBufferInfo = &buffer_info;
-        write.dstArrayElement = 0;
-        write.dstBinding = 0;
-        write.dstSet = *_scene_descriptor_set;
-        get_renderer().vkctx().device().updateDescriptorSets(write, {});
+        auto& renderer = get_renderer();
+        _scene_descriptor_set = renderer.get_descriptor_allocator().allocate(descriptor_set_definition().definition);
+
+        renderer.get_uniform_arena().write_descriptor(
+            renderer.descriptor_writes(),
+            *_scene_descriptor_set,
+            0,
+            sizeof(scene_uniform_data));
     }
-} // namespace cathedral::engine
\ No newline at end of file
+} // namespace cathedral::engine
@@ -1,5 +1,6 @@
 #include <cathedral/engine/shader_preprocess.hpp>
 
+#include <cathedral/engine/bindless_texture_table.hpp>
 #include <cathedral/engine/scene.hpp>
 
 #include <cathedral/core.hpp>
@@ -36,6 +37,9 @@ layout (location = 3) in vec4 VERTEX_COLOR;
 
     constexpr auto SHADER_VERSION = "#version 450";
 
+    constexpr auto BINDLESS_TEXTURES_TABLE_NAME = "cathedral_textures";
+    constexpr auto BINDLESS_TEXTURE_INDICES_NAME = "cathedral_texture_indices";
+
     namespace
     {
         bool is_valid_variable_name(std::string_view name)
@@ -282,6 +286,57 @@ layout (location = 3) in vec4 VERTEX_COLOR;
 
             return result;
         }
+
+        std::string generate_bindless_texture_table()
+        {
+            return std::format(
+                "#extension GL_EXT_nonuniform_qualifier : require\n"
+                "layout (set = {}, binding = 0) uniform sampler2D {}[];\n"
+                "layout (push_constant) uniform _{}_ {{\n"
+                "    uint material[{}];\n"
+                "    uint node[{}];\n"
+                "}} {};\n",
+                BINDLESS_TEXTURE_SET_INDEX,
+                BINDLESS_TEXTURES_TABLE_NAME,
+                BINDLESS_TEXTURE_INDICES_NAME,
+                MAX_BINDLESS_MATERIAL_TEXTURES,
+                MAX_BINDLESS_NODE_TEXTURES,
+                BINDLESS_TEXTURE_INDICES_NAME);
+        }
+
+        // Texture names resolve to table lookups through the per-draw indices, which are uniform within a draw
+        std::expected<std::string, std::string> generate_bindless_texture_defines(
+            const std::vector<std::string>& texture_names,
+            const std::string& indices_member,
+            const uint32_t max_textures,
+            inout_param<std::unordered_set<std::string>> used_names)
+        {
+            if (texture_names.size() > max_textures)
+            {
+                return std::unexpected(
+                    std::format("Too many {} textures for bindless mode, the limit is {}", indices_member, max_textures));
+            }
+
+            std::string result;
+            for (size_t i = 0; i < texture_names.size(); ++i)
+            {
+                const auto& name = texture_names[i];
+                if (used_names->contains(name))
+                {
+                    return std::unexpected(name);
+                }
+                used_names->emplace(name);
+                result += std::format(
+                    "#define {} {}[{}.{}[{}]]\n",
+                    name,
+                    BINDLESS_TEXTURES_TABLE_NAME,
+                    BINDLESS_TEXTURE_INDICES_NAME,
+                    indices_member,
+                    i);
+            }
+
+            return result;
+        }
     } // namespace
 
     std::expected<shader_preprocess_data, std::string> get_shader_preprocess_data(std::string_view source)
@@ -312,7 +367,9 @@ layout (location = 3) in vec4 VERTEX_COLOR;
     }
 
     std::expected<std::string, std::string> preprocess_shader(
-        const gfx::shader_type type, const shader_preprocess_data& pp_data)
+        const gfx::shader_type type,
+        const shader_preprocess_data& pp_data,
+        const bool bindless_textures)
     {
         std::unordered_set<std::string> used_names;
 
@@ -327,23 +384,49 @@ layout (location = 3) in vec4 VERTEX_COLOR;
             generate_uniform_block(pp_data.node_vars, "cathedral_node_uniform", NODE_SET_INDEX, inout_param{ used_names });
         FORWARD_UNEXPECTED(node_uniform_block);
 
-        const auto material_texture_block = generate_texture_block(
-            pp_data.material_textures,
-            "cathedral_material_textures",
-            MATERIAL_SET_INDEX,
-            inout_param{ used_names });
-        FORWARD_UNEXPECTED(material_texture_block);
-
-        const auto node_texture_block = generate_texture_block(
-            pp_data.node_textures,
-            "cathedral_node_textures",
-            NODE_SET_INDEX,
-            inout_param{ used_names });
-        FORWARD_UNEXPECTED(node_texture_block);
+        std::expected<std::string, std::string> material_texture_block;
+        std::expected<std::string, std::string> node_texture_block;
+        if (bindless_textures)
+        {
+            material_texture_block = generate_bindless_texture_defines(
+                pp_data.material_textures,
+                "material",
+                MAX_BINDLESS_MATERIAL_TEXTURES,
+                inout_param{ used_names });
+            FORWARD_UNEXPECTED(material_texture_block);
+
+            node_texture_block = generate_bindless_texture_defines(
+                pp_data.node_textures,
+                "node",
+                MAX_BINDLESS_NODE_TEXTURES,
+                inout_param{ used_names });
+            FORWARD_UNEXPECTED(node_texture_block);
+        }
+        else
+        {
+            material_texture_block = generate_texture_block(
+                pp_data.material_textures,
+                "cathedral_material_textures",
+                MATERIAL_SET_INDEX,
+                inout_param{ used_names });
+            FORWARD_UNEXPECTED(material_texture_block);
+
+            node_texture_block = generate_texture_block(
+                pp_data.node_textures,
+                "cathedral_node_textures",
+                NODE_SET_INDEX,
+                inout_param{ used_names });
+            FORWARD_UNEXPECTED(node_texture_block);
+        }
 
         std::string result_source;
         result_source += std::string{ SHADER_VERSION } + '\n';
 
+        if (bindless_textures && (!pp_data.material_textures.empty() || !pp_data.node_textures.empty()))
+        {
+            result_source += generate_bindless_texture_table();
+        }
+
         if (type == gfx::shader_type::VERTEX)
         {
             result_source += std::string{ VERTEX_INPUTS };
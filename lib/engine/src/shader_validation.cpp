@@ -1,5 +1,7 @@
 #include <cathedral/engine/shader_validation.hpp>
 
+#include <cathedral/engine/bindless_texture_table.hpp>
+
 #include <cathedral/gfx/shader.hpp>
 #include <cathedral/gfx/shader_reflection.hpp>
 
@@ -46,6 +48,11 @@ namespace cathedral::engine
         {
             for (const auto& dset : refl.descriptor_sets)
             {
+                if (dset.set == BINDLESS_TEXTURE_SET_INDEX && dset.binding == 0 &&
+                    dset.desc_type == gfx::descriptor_type::SAMPLER)
+                {
+                    continue; // Bindless texture table
+                }
                 if (dset.set > 2)
                 {
                     return "Illegal descriptor set set-index";
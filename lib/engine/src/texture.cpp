@@ -1,11 +1,13 @@
 #include <cathedral/engine/texture.hpp>
 
+#include <cathedral/engine/sampler_cache.hpp>
 #include <cathedral/engine/texture_compression.hpp>
 #include <cathedral/engine/texture_mip.hpp>
 #include <cathedral/engine/upload_queue.hpp>
 
 #include <ien/initializers.hpp>
 
+#include <algorithm>
 #include <cmath>
 
 namespace cathedral::engine
@@ -26,6 +28,16 @@ namespace cathedral::engine
             case texture_format::DXT5_BC3_LINEAR:
                 return vk::Format::eBc3UnormBlock;
 
+            case texture_format::RGTC1_BC4_LINEAR:
+                return vk::Format::eBc4UnormBlock;
+            case texture_format::RGTC2_BC5_LINEAR:
+                return vk::Format::eBc5UnormBlock;
+
+            case texture_format::BPTC_BC7_SRGB:
+                return vk::Format::eBc7SrgbBlock;
+            case texture_format::BPTC_BC7_LINEAR:
+                return vk::Format::eBc7UnormBlock;
+
             case texture_format::R8_SRGB:
                 return vk::Format::eR8Srgb;
             case texture_format::R8G8_SRGB:
@@ -77,21 +89,28 @@ namespace cathedral::engine
                 return eR8G8B8Srgb;
             case eBc1RgbaSrgbBlock:
             case eBc3SrgbBlock:
+            case eBc7SrgbBlock:
                 return eR8G8B8A8Srgb;
 
             case eBc1RgbUnormBlock:
                 return eR8G8B8Unorm;
             case eBc1RgbaUnormBlock:
             case eBc3UnormBlock:
+            case eBc7UnormBlock:
                 return eR8G8B8A8Unorm;
 
+            case eBc4UnormBlock:
+                return eR8Unorm;
+            case eBc5UnormBlock:
+                return eR8G8Unorm;
+
             default:
                 return format;
             }
         }
     } // namespace
 
-    texture::texture(texture_args_from_path args, upload_queue& queue)
+    texture::texture(texture_args_from_path args, upload_queue& queue, sampler_cache& samplers)
         : _path(std::move(args.path))
     {
         CRITICAL_CHECK(args.request_mipmap_levels > 0, "Minimum mipmap levels must be 1 (no mipmaps)");
@@ -104,11 +123,11 @@ namespace cathedral::engine
             args.format,
             args.request_mipmap_levels);
 
-        _sampler = std::make_unique<gfx::sampler>(&queue.vkctx(), args.sampler_info);
+        _sampler = samplers.get(args.sampler_info);
 
         init_vkimageview(queue.vkctx(), args.format, args.image_aspect_flags);
 
-        transition_all_mips_to_transferdst(queue);
+        queue.begin_image_upload(*_image);
 
         // Mip0 data
         const auto mip0_data = ien::conditional_init<std::vector<std::byte>>(
@@ -123,50 +142,51 @@ namespace cathedral::engine
             });
 
         // Mip1..n data
-        std::vector<std::vector<std::byte>> mipmaps_data;
-        if (_image->mip_levels() > 1)
-        {
-            for (const auto& mip : create_image_mips(*args.pimage, args.mipgen_filter, _image->mip_levels() - 1))
-            {
-                if (is_compressed_format(args.format))
-                {
-                    mipmaps_data.push_back(create_compressed_texture_data(mip, get_format_compression_type(args.format)));
-                }
-                else
-                {
-                    auto& vec = mipmaps_data.emplace_back();
-                    vec.resize(mip.size());
-                    std::memcpy(vec.data(), mip.data(), vec.size());
-                }
-            }
-        }
+        const auto mips = create_image_mips(
+            *args.pimage,
+            args.mipgen_filter,
+            _image->mip_levels() - 1,
+            !is_texture_format_linear(args.format));
 
         // Upload mip0
         queue.update_image(*_image, mip0_data, 0);
 
-        // Upload mip1..n
-        for (size_t i = 0; i < mipmaps_data.size(); ++i)
+        // Upload mip1..n, uncompressed levels go straight from the mip chain
+        for (size_t i = 0; i < mips.level_count(); ++i)
         {
-            queue.update_image(*_image, mipmaps_data[i], static_cast<uint32_t>(i + 1));
+            const auto& level = mips.level(i);
+            if (is_compressed_format(args.format))
+            {
+                const auto compressed = create_compressed_texture_data(
+                    mips.level_data(i),
+                    level.width,
+                    level.height,
+                    get_format_compression_type(args.format));
+                queue.update_image(*_image, compressed, static_cast<uint32_t>(i + 1));
+            }
+            else
+            {
+                queue.update_image(*_image, mips.level_data(i), static_cast<uint32_t>(i + 1));
+            }
         }
 
-        transition_all_mips_to_shader_readonly(queue);
+        queue.end_image_upload(*_image);
 
         _name = std::move(args.name);
     }
 
-    texture::texture(texture_args_from_data args, upload_queue& queue)
+    texture::texture(texture_args_from_data args, upload_queue& queue, sampler_cache& samplers)
         : _path(std::nullopt)
     {
         CRITICAL_CHECK(!args.mips.empty(), "No mips for texture");
 
         init_vkimage(queue.vkctx(), args.image_aspect_flags, args.size.x, args.size.y, args.format, static_cast<uint32_t>(args.mips.size()));
 
-        _sampler = std::make_unique<gfx::sampler>(&queue.vkctx(), args.sampler_info);
+        _sampler = samplers.get(args.sampler_info);
 
         init_vkimageview(queue.vkctx(), args.format, args.image_aspect_flags);
 
-        transition_all_mips_to_transferdst(queue);
+        queue.begin_image_upload(*_image);
 
         // Upload mips
         for (size_t i = 0; i < args.mips.size(); ++i)
@@ -174,18 +194,169 @@ namespace cathedral::engine
             queue.update_image(*_image, args.mips[i], static_cast<uint32_t>(i));
         }
 
-        transition_all_mips_to_shader_readonly(queue);
+        queue.end_image_upload(*_image);
 
         _name = std::move(args.name);
     }
 
+    texture::texture(texture_args_streamed args, upload_queue& queue, sampler_cache& samplers)
+        : _path(std::nullopt)
+        , _format(args.format)
+        , _image_aspect_flags(args.image_aspect_flags)
+        , _mip_sizes(std::move(args.mip_sizes))
+        , _mip_loader(std::move(args.mip_loader))
+    {
+        CRITICAL_CHECK(!_mip_sizes.empty(), "No mips for texture");
+        CRITICAL_CHECK(static_cast<bool>(_mip_loader), "Streamed texture requires a mip loader");
+
+        // Only the smallest mips are loaded up front, the texture streamer brings in the rest on demand
+        _min_resident_base_mip = mip_count() - 1;
+        while (_min_resident_base_mip > 0)
+        {
+            const auto& size = _mip_sizes[_min_resident_base_mip - 1];
+            if (std::max(size.x, size.y) > args.min_resident_dimension)
+            {
+                break;
+            }
+            --_min_resident_base_mip;
+        }
+
+        _sampler = samplers.get(args.sampler_info);
+
+        init_resident_image(_min_resident_base_mip, nullptr, queue);
+
+        _name = std::move(args.name);
+    }
+
+    size_t texture::mip_size_bytes(const uint32_t mip_index) const
+    {
+        const auto& size = _mip_sizes[mip_index];
+        return calc_texture_size(size.x, size.y, _format);
+    }
+
+    size_t texture::resident_size_bytes() const
+    {
+        size_t result = 0;
+        for (uint32_t mip = _resident_base_mip; mip < mip_count(); ++mip)
+        {
+            result += mip_size_bytes(mip);
+        }
+        return result;
+    }
+
+    texture_residency_change texture::set_resident_base_mip(uint32_t base_mip, upload_queue& queue)
+    {
+        CRITICAL_CHECK(is_streamed(), "Attempt to change residency of a non streamed texture");
+
+        base_mip = std::min(base_mip, _min_resident_base_mip);
+        if (base_mip == _resident_base_mip)
+        {
+            return {};
+        }
+
+        texture_residency_change result{ .image = std::move(_image), .imageview = std::move(_imageview) };
+        init_resident_image(base_mip, result.image.get(), queue);
+        return result;
+    }
+
+    void texture::init_resident_image(const uint32_t base_mip, const gfx::image* previous, upload_queue& queue)
+    {
+        const uint32_t previous_base_mip = _resident_base_mip;
+        const auto& base_size = _mip_sizes[base_mip];
+
+        init_vkimage(queue.vkctx(), _image_aspect_flags, base_size.x, base_size.y, _format, mip_count() - base_mip, true);
+        CRITICAL_CHECK(_image->mip_levels() == mip_count() - base_mip, "Streamed texture mip chain does not match its image");
+        init_vkimageview(queue.vkctx(), _format, _image_aspect_flags);
+
+        queue.begin_image_upload(*_image);
+
+        // Only the mips that were not resident yet are loaded, written straight into staging memory
+        const uint32_t load_end = previous != nullptr ? previous_base_mip : mip_count();
+        for (uint32_t mip = base_mip; mip < load_end; ++mip)
+        {
+            queue.update_image(*_image, mip_size_bytes(mip), mip - base_mip, [this, mip](const std::span<std::byte> dst) {
+                _mip_loader(mip, dst);
+            });
+        }
+
+        queue.end_image_upload(*_image);
+
+        // The rest are copied over on the GPU. The previous image is owned by the graphics queue, so the copy goes there
+        // once the new image has been acquired from the transfer queue
+        if (previous != nullptr)
+        {
+            const uint32_t first_copied = std::max(base_mip, previous_base_mip);
+
+            std::vector<vk::ImageCopy> regions;
+            for (uint32_t mip = first_copied; mip < mip_count(); ++mip)
+            {
+                vk::ImageCopy region;
+                region.srcSubresource = vk::ImageSubresourceLayers(previous->aspect_flags(), mip - previous_base_mip, 0, 1);
+                region.dstSubresource = vk::ImageSubresourceLayers(_image->aspect_flags(), mip - base_mip, 0, 1);
+                region.extent = vk::Extent3D{ .width = _mip_sizes[mip].x, .height = _mip_sizes[mip].y, .depth = 1U };
+                regions.push_back(region);
+            }
+
+            // Captured by handle, by then only the texture streamer keeps the previous image alive
+            queue.record_after_transfers([&vkctx = queue.vkctx(),
+                                          src = previous->get_image(),
+                                          src_aspect = previous->aspect_flags(),
+                                          src_first_mip = first_copied - previous_base_mip,
+                                          dst = _image->get_image(),
+                                          dst_aspect = _image->aspect_flags(),
+                                          dst_first_mip = first_copied - base_mip,
+                                          copied_mips = mip_count() - first_copied,
+                                          regions = std::move(regions)](const vk::CommandBuffer cmdbuff) {
+                gfx::transition_image_layout_suboptimal(
+                    src,
+                    vk::ImageLayout::eShaderReadOnlyOptimal,
+                    vk::ImageLayout::eTransferSrcOptimal,
+                    src_aspect,
+                    src_first_mip,
+                    copied_mips,
+                    cmdbuff,
+                    vkctx);
+                gfx::transition_image_layout_suboptimal(
+                    dst,
+                    vk::ImageLayout::eShaderReadOnlyOptimal,
+                    vk::ImageLayout::eTransferDstOptimal,
+                    dst_aspect,
+                    dst_first_mip,
+                    copied_mips,
+                    cmdbuff,
+                    vkctx);
+
+                cmdbuff.copyImage(
+                    src,
+                    vk::ImageLayout::eTransferSrcOptimal,
+                    dst,
+                    vk::ImageLayout::eTransferDstOptimal,
+                    regions);
+
+                gfx::transition_image_layout_suboptimal(
+                    dst,
+                    vk::ImageLayout::eTransferDstOptimal,
+                    vk::ImageLayout::eShaderReadOnlyOptimal,
+                    dst_aspect,
+                    dst_first_mip,
+                    copied_mips,
+                    cmdbuff,
+                    vkctx);
+            });
+        }
+
+        _resident_base_mip = base_mip;
+        ++_imageview_generation;
+    }
+
     void texture::init_vkimage(
         const gfx::vulkan_context& vkctx,
         const vk::ImageAspectFlagBits image_aspect_flags,
         const uint32_t width,
         const uint32_t height,
         const texture_format format,
-        const uint32_t req_mipmap_levels)
+        const uint32_t req_mipmap_levels,
+        const bool allow_transfer_src)
     {
         gfx::image_args image_args;
         image_args.vkctx = &vkctx;
@@ -195,6 +366,10 @@ namespace cathedral::engine
         image_args.format = tex_fmt_to_vk_fmt(format);
         image_args.mipmap_levels = req_mipmap_levels;
         image_args.compressed = is_compressed_format(format);
+        if (allow_transfer_src)
+        {
+            image_args.usage_flags |= vk::ImageUsageFlagBits::eTransferSrc;
+        }
 
         _image = std::make_unique<gfx::image>(image_args);
     }
@@ -220,30 +395,4 @@ namespace cathedral::engine
 
         _imageview = vkctx.device().createImageViewUnique(imageview_info);
     }
-
-    void texture::transition_all_mips_to_transferdst(upload_queue& queue) const
-    {
-        queue.record([this](const vk::CommandBuffer cmdbuff) {
-            _image->transition_layout_suboptimal(
-                vk::ImageLayout::eUndefined,
-                vk::ImageLayout::eTransferDstOptimal,
-                cmdbuff,
-                _image->aspect_flags(),
-                0,
-                _image->mip_levels());
-        });
-    }
-
-    void texture::transition_all_mips_to_shader_readonly(upload_queue& queue) const
-    {
-        queue.record([this](const vk::CommandBuffer cmdbuff) {
-            _image->transition_layout_suboptimal(
-                vk::ImageLayout::eTransferDstOptimal,
-                vk::ImageLayout::eShaderReadOnlyOptimal,
-                cmdbuff,
-                _image->aspect_flags(),
-                0,
-                _image->mip_levels());
-        });
-    }
 } // namespace cathedral::engine
\ No newline at end of file
@@ -1,79 +1,201 @@
 #include <cathedral/engine/texture_compression.hpp>
 
 #include <cathedral/core.hpp>
+#include <cathedral/engine/bits/bc7.hpp>
 
-#include <ien/arithmetic.hpp>
 #include <ien/image/image.hpp>
 
 #include <stb_dxt.h>
 
 #include <algorithm>
+#include <array>
+#include <cstring>
 
 namespace cathedral::engine
 {
     namespace
     {
-        std::vector<std::byte> compress_dxt1(const ien::image& img)
+        constexpr uint32_t BLOCK_DIM = 4;
+
+        struct source_pixels
+        {
+            const uint8_t* data;
+            size_t width;
+            size_t height;
+        };
+
+        // Gathers the 4x4 block at (block_x, block_y) straight from the source rows.
+        // Blocks that overhang the image edge replicate the last row/column.
+        template <uint32_t PixelSize>
+        void gather_block(
+            const source_pixels& img,
+            const size_t block_x,
+            const size_t block_y,
+            uint8_t* CATHEDRAL_RESTRICT_PTR dst_block)
         {
-            std::vector<std::byte> result;
-            for (size_t y = 0; y < img.height(); y += 4)
+            const uint8_t* src = img.data;
+            const size_t src_row_bytes = img.width * PixelSize;
+            const size_t x0 = block_x * BLOCK_DIM;
+            const size_t y0 = block_y * BLOCK_DIM;
+
+            if (x0 + BLOCK_DIM <= img.width && y0 + BLOCK_DIM <= img.height)
+            {
+                const uint8_t* row = src + (y0 * src_row_bytes) + (x0 * PixelSize);
+                for (uint32_t y = 0; y < BLOCK_DIM; ++y)
+                {
+                    std::memcpy(dst_block + (y * BLOCK_DIM * PixelSize), row, BLOCK_DIM * PixelSize);
+                    row += src_row_bytes;
+                }
+                return;
+            }
+
+            for (uint32_t y = 0; y < BLOCK_DIM; ++y)
             {
-                for (size_t x = 0; x < img.width(); x += 4)
+                const size_t src_y = std::min<size_t>(y0 + y, img.height - 1);
+                for (uint32_t x = 0; x < BLOCK_DIM; ++x)
                 {
-                    std::array<std::byte, 8> block_data;
-                    std::ranges::fill(block_data, static_cast<std::byte>(0));
-                    const auto image_block = img.copy_rect(x, y, 4, 4);
-                    stb_compress_dxt_block(
-                        reinterpret_cast<unsigned char*>(block_data.data()),
-                        image_block.data(),
-                        0,
-                        STB_DXT_HIGHQUAL);
-                    std::ranges::copy(block_data, std::back_inserter(result));
+                    const size_t src_x = std::min<size_t>(x0 + x, img.width - 1);
+                    std::memcpy(
+                        dst_block + (((y * BLOCK_DIM) + x) * PixelSize),
+                        src + (src_y * src_row_bytes) + (src_x * PixelSize),
+                        PixelSize);
                 }
             }
-            return result;
         }
 
-        std::vector<std::byte> compress_dxt5(const ien::image& img)
+        template <texture_compression_type Type>
+        void compress_block(unsigned char* dst, const uint8_t* block_pixels, [[maybe_unused]] bc7_search_depth bc7_depth)
         {
-            std::vector<std::byte> result;
-            for (size_t y = 0; y < img.height(); y += 4)
+            if constexpr (Type == texture_compression_type::DXT1_BC1)
+            {
+                stb_compress_dxt_block(dst, block_pixels, 0, STB_DXT_HIGHQUAL);
+            }
+            else if constexpr (Type == texture_compression_type::DXT5_BC3)
+            {
+                stb_compress_dxt_block(dst, block_pixels, 1, STB_DXT_HIGHQUAL);
+            }
+            else if constexpr (Type == texture_compression_type::RGTC1_BC4)
+            {
+                stb_compress_bc4_block(dst, block_pixels);
+            }
+            else if constexpr (Type == texture_compression_type::RGTC2_BC5)
+            {
+                stb_compress_bc5_block(dst, block_pixels);
+            }
+            else if constexpr (Type == texture_compression_type::BPTC_BC7)
             {
-                for (size_t x = 0; x < img.width(); x += 4)
+                bc7::compress_block(block_pixels, dst, bc7_depth);
+            }
+        }
+
+        template <texture_compression_type Type>
+        void compress_blocks(const source_pixels& img, std::span<std::byte> dst, const bc7_search_depth bc7_depth)
+        {
+            constexpr auto pixel_size = get_texture_compression_pixel_size(Type);
+            constexpr auto block_size = get_texture_compression_block_size(Type);
+
+            const size_t hblocks = get_texture_compression_block_count(static_cast<uint32_t>(img.width));
+            const auto vblocks = static_cast<int>(get_texture_compression_block_count(static_cast<uint32_t>(img.height)));
+            auto* dst_data = reinterpret_cast<unsigned char*>(dst.data());
+
+#pragma omp parallel for schedule(static)
+            for (int block_y = 0; block_y < vblocks; ++block_y)
+            {
+                std::array<uint8_t, BLOCK_DIM * BLOCK_DIM * pixel_size> block_pixels;
+                auto* dst_row = dst_data + (static_cast<size_t>(block_y) * hblocks * block_size);
+                for (size_t block_x = 0; block_x < hblocks; ++block_x)
                 {
-                    std::array<std::byte, 16> block_data;
-                    std::ranges::fill(block_data, static_cast<std::byte>(0));
-                    const auto image_block = img.copy_rect(x, y, 4, 4);
-                    stb_compress_dxt_block(
-                        reinterpret_cast<unsigned char*>(block_data.data()),
-                        image_block.data(),
-                        1,
-                        STB_DXT_HIGHQUAL);
-                    std::ranges::copy(block_data, std::back_inserter(result));
+                    gather_block<pixel_size>(img, block_x, static_cast<size_t>(block_y), block_pixels.data());
+                    compress_block<Type>(dst_row + (block_x * block_size), block_pixels.data(), bc7_depth);
                 }
             }
-            return result;
         }
     } // namespace
 
-    std::vector<std::byte> create_compressed_texture_data(const std::string& image_path, texture_compression_type type)
+    std::vector<std::byte> create_compressed_texture_data(
+        const std::string& image_path,
+        texture_compression_type type,
+        bc7_search_depth bc7_depth)
     {
         const ien::image source_image(image_path);
-        return create_compressed_texture_data(source_image, type);
+        return create_compressed_texture_data(source_image, type, bc7_depth);
+    }
+
+    std::vector<std::byte> create_compressed_texture_data(
+        const ien::image& image,
+        texture_compression_type type,
+        bc7_search_depth bc7_depth)
+    {
+        return create_compressed_texture_data(
+            std::as_bytes(std::span{ image.data(), image.size() }),
+            static_cast<uint32_t>(image.width()),
+            static_cast<uint32_t>(image.height()),
+            type,
+            bc7_depth);
+    }
+
+    void create_compressed_texture_data(
+        const ien::image& image,
+        const texture_compression_type type,
+        const std::span<std::byte> dst,
+        const bc7_search_depth bc7_depth)
+    {
+        create_compressed_texture_data(
+            std::as_bytes(std::span{ image.data(), image.size() }),
+            static_cast<uint32_t>(image.width()),
+            static_cast<uint32_t>(image.height()),
+            type,
+            dst,
+            bc7_depth);
+    }
+
+    std::vector<std::byte> create_compressed_texture_data(
+        const std::span<const std::byte> pixels,
+        const uint32_t width,
+        const uint32_t height,
+        const texture_compression_type type,
+        const bc7_search_depth bc7_depth)
+    {
+        std::vector<std::byte> result(calc_compressed_texture_size(width, height, type));
+        create_compressed_texture_data(pixels, width, height, type, result, bc7_depth);
+        return result;
     }
 
-    std::vector<std::byte> create_compressed_texture_data(const ien::image& image, texture_compression_type type)
+    void create_compressed_texture_data(
+        const std::span<const std::byte> pixels,
+        const uint32_t width,
+        const uint32_t height,
+        const texture_compression_type type,
+        const std::span<std::byte> dst,
+        const bc7_search_depth bc7_depth)
     {
-        CRITICAL_CHECK(ien::is_power_of_2(image.width()), "Only textures with power of 2 dimensions can be compressed");
-        CRITICAL_CHECK(ien::is_power_of_2(image.height()), "Only textures with power of 2 dimensions can be compressed");
+        CRITICAL_CHECK(width > 0 && height > 0, "Can't compress an empty image");
+        CRITICAL_CHECK(
+            pixels.size() == static_cast<size_t>(width) * height * get_texture_compression_pixel_size(type),
+            "Source image channel count does not match the compression type");
+        CRITICAL_CHECK(
+            dst.size() == calc_compressed_texture_size(width, height, type),
+            "Compressed texture destination size mismatch");
 
+        const source_pixels source = { reinterpret_cast<const uint8_t*>(pixels.data()), width, height };
         switch (type)
         {
         case texture_compression_type::DXT1_BC1:
-            return compress_dxt1(image);
+            compress_blocks<texture_compression_type::DXT1_BC1>(source, dst, bc7_depth);
+            return;
         case texture_compression_type::DXT5_BC3:
-            return compress_dxt5(image);
+            compress_blocks<texture_compression_type::DXT5_BC3>(source, dst, bc7_depth);
+            return;
+        case texture_compression_type::RGTC1_BC4:
+            compress_blocks<texture_compression_type::RGTC1_BC4>(source, dst, bc7_depth);
+            return;
+        case texture_compression_type::RGTC2_BC5:
+            compress_blocks<texture_compression_type::RGTC2_BC5>(source, dst, bc7_depth);
+            return;
+        case texture_compression_type::BPTC_BC7:
+            compress_blocks<texture_compression_type::BPTC_BC7>(source, dst, bc7_depth);
+            return;
         }
         CRITICAL_ERROR("Unhandled texture compression type");
     }
-} // namespace cathedral::engine
\ No newline at end of file
+} // namespace cathedral::engine
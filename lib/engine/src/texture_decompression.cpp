@@ -1,10 +1,20 @@
 #include <cathedral/engine/texture_decompression.hpp>
 
+#include <cathedral/engine/bits/bc7.hpp>
+
 #include <cathedral/core.hpp>
+#include <cathedral/cpu_features.hpp>
 
 #include <ien/arithmetic.hpp>
 
+#ifdef CATHEDRAL_ARCH_X86_64
+    #include <immintrin.h>
+#endif
+
+#include <algorithm>
 #include <array>
+#include <cstring>
+#include <utility>
 
 namespace cathedral::engine
 {
@@ -145,16 +155,163 @@ namespace cathedral::engine
             decompress_bc_alpha_block(compressed_block, decompressed_block + 3, image_width_bytes, 4);
         }
 
-        constexpr uint32_t get_texture_compression_block_size(texture_compression_type tctype)
+        inline void decompress_bc4_block(
+            const std::byte* compressed_block,
+            std::byte* decompressed_block,
+            const uint32_t image_width_bytes)
         {
-            switch (tctype)
+            decompress_bc_alpha_block(compressed_block, decompressed_block, image_width_bytes, 1);
+        }
+
+        inline void decompress_bc5_block(
+            const std::byte* compressed_block,
+            std::byte* decompressed_block,
+            const uint32_t image_width_bytes)
+        {
+            decompress_bc_alpha_block(compressed_block, decompressed_block, image_width_bytes, 2);
+            decompress_bc_alpha_block(compressed_block + 8, decompressed_block + 1, image_width_bytes, 2);
+        }
+
+        class bc7_bit_reader
+        {
+        public:
+            explicit bc7_bit_reader(const std::byte* block) { std::memcpy(_data.data(), block, _data.size()); }
+
+            uint32_t read(const uint32_t bits)
             {
-            case texture_compression_type::DXT1_BC1:
-                return 8;
-            case texture_compression_type::DXT5_BC3:
-                return 16;
-            default:
-                CRITICAL_ERROR("Unhandled texture compression type");
+                uint32_t result = 0;
+                for (uint32_t i = 0; i < bits; ++i, ++_position)
+                {
+                    const uint32_t bit = (_data[_position / 8] >> (_position % 8)) & 1U;
+                    result |= bit << i;
+                }
+                return result;
+            }
+
+        private:
+            std::array<uint8_t, 16> _data = {};
+            uint32_t _position = 0;
+        };
+
+        void decompress_bc7_block(
+            const std::byte* compressed_block,
+            std::byte* decompressed_block,
+            const uint32_t image_width_bytes)
+        {
+            bc7_bit_reader reader(compressed_block);
+
+            uint32_t mode = 0;
+            while (mode < bc7::MODE_COUNT && reader.read(1) == 0)
+            {
+                ++mode;
+            }
+
+            auto* dst = reinterpret_cast<uint8_t*>(decompressed_block);
+            if (mode == bc7::MODE_COUNT) // Reserved mode, decodes to transparent black
+            {
+                for (uint32_t y = 0; y < 4; ++y)
+                {
+                    std::memset(dst + (static_cast<size_t>(y) * image_width_bytes), 0, 16);
+                }
+                return;
+            }
+
+            const auto& info = bc7::MODES[mode];
+            const uint32_t partition = reader.read(info.partition_bits);
+            const uint32_t rotation = reader.read(info.rotation_bits);
+            const uint32_t index_selection = reader.read(info.index_selection_bits);
+
+            const uint32_t endpoint_count = info.subsets * 2U;
+            std::array<std::array<uint32_t, 4>, bc7::MAX_SUBSETS * 2> endpoints = {};
+            for (uint32_t c = 0; c < 3; ++c)
+            {
+                for (uint32_t e = 0; e < endpoint_count; ++e)
+                {
+                    endpoints[e][c] = reader.read(info.color_bits);
+                }
+            }
+            for (uint32_t e = 0; e < endpoint_count && info.alpha_bits > 0; ++e)
+            {
+                endpoints[e][3] = reader.read(info.alpha_bits);
+            }
+
+            uint32_t color_bits = info.color_bits;
+            uint32_t alpha_bits = info.alpha_bits;
+            if (info.endpoint_pbits > 0 || info.shared_pbits > 0)
+            {
+                std::array<uint32_t, bc7::MAX_SUBSETS * 2> pbits = {};
+                for (uint32_t e = 0; e < endpoint_count; ++e)
+                {
+                    pbits[e] = (info.endpoint_pbits > 0 || e % 2 == 0) ? reader.read(1) : pbits[e - 1];
+                }
+                for (uint32_t e = 0; e < endpoint_count; ++e)
+                {
+                    for (auto& channel : endpoints[e])
+                    {
+                        channel = (channel << 1) | pbits[e];
+                    }
+                }
+                ++color_bits;
+                alpha_bits += (alpha_bits > 0) ? 1 : 0;
+            }
+
+            for (uint32_t e = 0; e < endpoint_count; ++e)
+            {
+                for (uint32_t c = 0; c < 3; ++c)
+                {
+                    endpoints[e][c] = bc7::unquantize(endpoints[e][c], color_bits);
+                }
+                endpoints[e][3] = (alpha_bits > 0) ? bc7::unquantize(endpoints[e][3], alpha_bits) : 0xFF;
+            }
+
+            std::array<uint32_t, bc7::BLOCK_PIXELS> indices = {};
+            std::array<uint32_t, bc7::BLOCK_PIXELS> indices2 = {};
+            for (uint32_t i = 0; i < bc7::BLOCK_PIXELS; ++i)
+            {
+                const bool anchor = bc7::is_anchor(info.subsets, partition, i);
+                indices[i] = reader.read(info.index_bits - (anchor ? 1 : 0));
+            }
+            for (uint32_t i = 0; i < bc7::BLOCK_PIXELS && info.index2_bits > 0; ++i)
+            {
+                indices2[i] = reader.read(info.index2_bits - (i == 0 ? 1 : 0));
+            }
+
+            const uint8_t* color_weights = bc7::get_weights(info.index_bits);
+            const uint8_t* alpha_weights = color_weights;
+            const auto* color_indices = &indices;
+            const auto* alpha_indices = &indices;
+            if (info.index2_bits > 0)
+            {
+                alpha_weights = bc7::get_weights(info.index2_bits);
+                alpha_indices = &indices2;
+                if (index_selection != 0)
+                {
+                    std::swap(color_weights, alpha_weights);
+                    std::swap(color_indices, alpha_indices);
+                }
+            }
+
+            for (uint32_t i = 0; i < bc7::BLOCK_PIXELS; ++i)
+            {
+                const uint32_t subset = bc7::get_subset(info.subsets, partition, i);
+                const auto& e0 = endpoints[subset * 2];
+                const auto& e1 = endpoints[(subset * 2) + 1];
+
+                std::array<uint8_t, 4> pixel = {};
+                const uint32_t color_weight = color_weights[(*color_indices)[i]];
+                const uint32_t alpha_weight = alpha_weights[(*alpha_indices)[i]];
+                for (uint32_t c = 0; c < 3; ++c)
+                {
+                    pixel[c] = bc7::interpolate(e0[c], e1[c], color_weight);
+                }
+                pixel[3] = bc7::interpolate(e0[3], e1[3], alpha_weight);
+
+                if (rotation != 0)
+                {
+                    std::swap(pixel[3], pixel[rotation - 1]);
+                }
+
+                std::memcpy(dst + (static_cast<size_t>(i / 4) * image_width_bytes) + ((i % 4) * 4), pixel.data(), 4);
             }
         }
 
@@ -169,6 +326,448 @@ namespace cathedral::engine
                 return &decompress_bc1_block;
             case texture_compression_type::DXT5_BC3:
                 return &decompress_bc3_block;
+            case texture_compression_type::RGTC1_BC4:
+                return &decompress_bc4_block;
+            case texture_compression_type::RGTC2_BC5:
+                return &decompress_bc5_block;
+            case texture_compression_type::BPTC_BC7:
+                return &decompress_bc7_block;
+            default:
+                CRITICAL_ERROR("Unhandled texture compression type");
+            }
+        }
+
+        using block_row_decode_func = void (*)(
+            const std::byte* src_row,
+            uint32_t hblocks,
+            std::byte* dst_row,
+            uint32_t image_width_bytes);
+
+        constexpr uint32_t BLOCK_DIM = 4;
+
+        constexpr uint32_t get_decompressed_block_row_bytes(const texture_compression_type type)
+        {
+            return BLOCK_DIM * get_texture_compression_pixel_size(type);
+        }
+
+        // Decodes a block that overhangs the image edge into scratch space, then copies the visible pixels
+        void decompress_edge_block(
+            const texture_compression_func decode_block_func,
+            const texture_compression_type type,
+            const std::byte* src_block,
+            std::byte* dst,
+            const uint32_t image_width_bytes,
+            const uint32_t visible_width,
+            const uint32_t visible_height)
+        {
+            const auto block_row_bytes = get_decompressed_block_row_bytes(type);
+            const auto visible_row_bytes = visible_width * get_texture_compression_pixel_size(type);
+
+            std::array<std::byte, BLOCK_DIM * BLOCK_DIM * 4> scratch;
+            decode_block_func(src_block, scratch.data(), block_row_bytes);
+            for (uint32_t y = 0; y < visible_height; ++y)
+            {
+                std::memcpy(
+                    dst + (static_cast<size_t>(y) * image_width_bytes),
+                    scratch.data() + (y * block_row_bytes),
+                    visible_row_bytes);
+            }
+        }
+
+        // Only spread block rows across threads when there is enough work to amortize the fork
+        constexpr uint32_t PARALLEL_DECODE_MIN_BLOCKS = 64 * 64;
+
+        template <texture_compression_type Type>
+        void decompress_block_row_scalar(
+            const std::byte* src_row,
+            const uint32_t hblocks,
+            std::byte* dst_row,
+            const uint32_t image_width_bytes)
+        {
+            constexpr auto block_size = get_texture_compression_block_size(Type);
+            constexpr auto decompress_func = get_texture_compression_block_func(Type);
+            constexpr auto decompressed_block_row_bytes = get_decompressed_block_row_bytes(Type);
+            for (uint32_t block_x = 0; block_x < hblocks; ++block_x)
+            {
+                decompress_func(
+                    src_row + (block_x * block_size),
+                    dst_row + (block_x * decompressed_block_row_bytes),
+                    image_width_bytes);
+            }
+        }
+
+#ifdef CATHEDRAL_ARCH_X86_64
+        struct bc_color_block_header
+        {
+            uint16_t c0;
+            uint16_t c1;
+            uint32_t indices;
+        };
+
+        inline bc_color_block_header read_bc_color_block_header(const std::byte* color_block)
+        {
+            bc_color_block_header result;
+            std::memcpy(&result, color_block, sizeof(result));
+            return result;
+        }
+
+        /* All the endpoint math is done in 32 bit lanes, one block per lane.
+         * Operands are below 2^15, so the 16x16->32 bit madd works as a plain multiply on SSE2 */
+        inline __m128i mul_small_sse2(const __m128i v, const int32_t c)
+        {
+            return _mm_madd_epi16(v, _mm_set1_epi32(c));
+        }
+
+        template <int Shift>
+        inline __m128i expand_sse2(const __m128i v, const int32_t mul, const int32_t add)
+        {
+            return _mm_srli_epi32(_mm_add_epi32(mul_small_sse2(v, mul), _mm_set1_epi32(add)), Shift);
+        }
+
+        inline __m128i pack_rgba_sse2(const __m128i r, const __m128i g, const __m128i b)
+        {
+            const __m128i rg = _mm_or_si128(r, _mm_slli_epi32(g, 8));
+            const __m128i ba = _mm_or_si128(_mm_slli_epi32(b, 16), _mm_set1_epi32(static_cast<int32_t>(0xFF000000)));
+            return _mm_or_si128(rg, ba);
+        }
+
+        inline __m128i select_sse2(const __m128i mask, const __m128i a, const __m128i b)
+        {
+            return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+        }
+
+        // Expands the 565 endpoints of 4 blocks into their 4-entry palettes, returned one block per vector
+        void expand_bc_color_palettes_sse2(
+            const std::array<bc_color_block_header, 4>& headers,
+            const bool only_opaque_mode,
+            __m128i* palettes)
+        {
+            const __m128i c0 = _mm_setr_epi32(headers[0].c0, headers[1].c0, headers[2].c0, headers[3].c0);
+            const __m128i c1 = _mm_setr_epi32(headers[0].c1, headers[1].c1, headers[2].c1, headers[3].c1);
+
+            const __m128i mask5 = _mm_set1_epi32(0x1F);
+            const __m128i mask6 = _mm_set1_epi32(0x3F);
+
+            const __m128i r0 = _mm_and_si128(_mm_srli_epi32(c0, 11), mask5);
+            const __m128i g0 = _mm_and_si128(_mm_srli_epi32(c0, 5), mask6);
+            const __m128i b0 = _mm_and_si128(c0, mask5);
+            const __m128i r1 = _mm_and_si128(_mm_srli_epi32(c1, 11), mask5);
+            const __m128i g1 = _mm_and_si128(_mm_srli_epi32(c1, 5), mask6);
+            const __m128i b1 = _mm_and_si128(c1, mask5);
+
+            const __m128i p0 =
+                pack_rgba_sse2(expand_sse2<6>(r0, 527, 23), expand_sse2<6>(g0, 259, 33), expand_sse2<6>(b0, 527, 23));
+            const __m128i p1 =
+                pack_rgba_sse2(expand_sse2<6>(r1, 527, 23), expand_sse2<6>(g1, 259, 33), expand_sse2<6>(b1, 527, 23));
+
+            // BC1 (opaque, 2 interpolated colors)
+            const auto twice_plus = [](const __m128i a, const __m128i b) { return _mm_add_epi32(_mm_add_epi32(a, a), b); };
+            const __m128i p2_opaque = pack_rgba_sse2(
+                expand_sse2<7>(twice_plus(r0, r1), 351, 61),
+                expand_sse2<11>(twice_plus(g0, g1), 2763, 1039),
+                expand_sse2<7>(twice_plus(b0, b1), 351, 61));
+            const __m128i p3_opaque = pack_rgba_sse2(
+                expand_sse2<7>(twice_plus(r1, r0), 351, 61),
+                expand_sse2<11>(twice_plus(g1, g0), 2763, 1039),
+                expand_sse2<7>(twice_plus(b1, b0), 351, 61));
+
+            // BC1A (1 interpolated color, 1 transparent)
+            const __m128i p2_alpha = pack_rgba_sse2(
+                expand_sse2<8>(_mm_add_epi32(r0, r1), 1053, 125),
+                expand_sse2<11>(_mm_add_epi32(g0, g1), 4145, 1019),
+                expand_sse2<8>(_mm_add_epi32(b0, b1), 1053, 125));
+
+            const __m128i opaque_mask = only_opaque_mode ? _mm_set1_epi32(-1) : _mm_cmpgt_epi32(c0, c1);
+            const __m128i p2 = select_sse2(opaque_mask, p2_opaque, p2_alpha);
+            const __m128i p3 = _mm_and_si128(opaque_mask, p3_opaque);
+
+            // Transpose from one palette entry per vector to one block per vector
+            const __m128i t0 = _mm_unpacklo_epi32(p0, p1);
+            const __m128i t1 = _mm_unpacklo_epi32(p2, p3);
+            const __m128i t2 = _mm_unpackhi_epi32(p0, p1);
+            const __m128i t3 = _mm_unpackhi_epi32(p2, p3);
+            palettes[0] = _mm_unpacklo_epi64(t0, t1);
+            palettes[1] = _mm_unpackhi_epi64(t0, t1);
+            palettes[2] = _mm_unpacklo_epi64(t2, t3);
+            palettes[3] = _mm_unpackhi_epi64(t2, t3);
+        }
+
+        void lookup_bc_color_block_sse2(
+            const __m128i palette,
+            uint32_t indices,
+            std::byte* decompressed_block,
+            const uint32_t image_width_bytes)
+        {
+            const __m128i pal0 = _mm_shuffle_epi32(palette, 0x00);
+            const __m128i pal1 = _mm_shuffle_epi32(palette, 0x55);
+            const __m128i pal2 = _mm_shuffle_epi32(palette, 0xAA);
+            const __m128i pal3 = _mm_shuffle_epi32(palette, 0xFF);
+
+            // Each lane keeps only its own 2-bit index, still shifted in place
+            const __m128i lane_mask = _mm_setr_epi32(0x03, 0x0C, 0x30, 0xC0);
+            const __m128i index1 = _mm_setr_epi32(0x01, 0x04, 0x10, 0x40);
+            const __m128i index2 = _mm_setr_epi32(0x02, 0x08, 0x20, 0x80);
+
+            for (uint32_t y = 0; y < BLOCK_DIM; ++y)
+            {
+                const __m128i row_indices = _mm_and_si128(_mm_set1_epi32(static_cast<int32_t>(indices & 0xFF)), lane_mask);
+                indices >>= 8;
+
+                __m128i colors = _mm_and_si128(_mm_cmpeq_epi32(row_indices, _mm_setzero_si128()), pal0);
+                colors = _mm_or_si128(colors, _mm_and_si128(_mm_cmpeq_epi32(row_indices, index1), pal1));
+                colors = _mm_or_si128(colors, _mm_and_si128(_mm_cmpeq_epi32(row_indices, index2), pal2));
+                colors = _mm_or_si128(colors, _mm_and_si128(_mm_cmpeq_epi32(row_indices, lane_mask), pal3));
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(decompressed_block), colors);
+                decompressed_block += image_width_bytes;
+            }
+        }
+
+        template <texture_compression_type Type>
+        void decompress_block_row_sse2(
+            const std::byte* src_row,
+            const uint32_t hblocks,
+            std::byte* dst_row,
+            const uint32_t image_width_bytes)
+        {
+            constexpr bool is_bc3 = Type == texture_compression_type::DXT5_BC3;
+            constexpr auto block_size = get_texture_compression_block_size(Type);
+            constexpr uint32_t color_offset = is_bc3 ? 8 : 0;
+            constexpr auto decompressed_block_row_bytes = get_decompressed_block_row_bytes(Type);
+            constexpr uint32_t blocks_per_iteration = 4;
+
+            uint32_t block_x = 0;
+            for (; block_x + blocks_per_iteration <= hblocks; block_x += blocks_per_iteration)
+            {
+                std::array<bc_color_block_header, blocks_per_iteration> headers;
+                for (uint32_t i = 0; i < blocks_per_iteration; ++i)
+                {
+                    headers[i] = read_bc_color_block_header(src_row + ((block_x + i) * block_size) + color_offset);
+                }
+
+                __m128i palettes[blocks_per_iteration]; // NOLINT
+                expand_bc_color_palettes_sse2(headers, is_bc3, palettes);
+
+                for (uint32_t i = 0; i < blocks_per_iteration; ++i)
+                {
+                    auto* dst = dst_row + ((block_x + i) * decompressed_block_row_bytes);
+                    lookup_bc_color_block_sse2(palettes[i], headers[i].indices, dst, image_width_bytes);
+                    if constexpr (is_bc3)
+                    {
+                        decompress_bc_alpha_block(src_row + ((block_x + i) * block_size), dst + 3, image_width_bytes, 4);
+                    }
+                }
+            }
+
+            decompress_block_row_scalar<Type>(
+                src_row + (block_x * block_size),
+                hblocks - block_x,
+                dst_row + (block_x * decompressed_block_row_bytes),
+                image_width_bytes);
+        }
+
+        template <int Shift>
+        CATHEDRAL_TARGET_AVX2 inline __m256i expand_avx2(const __m256i v, const int32_t mul, const int32_t add)
+        {
+            const __m256i product = _mm256_mullo_epi32(v, _mm256_set1_epi32(mul));
+            return _mm256_srli_epi32(_mm256_add_epi32(product, _mm256_set1_epi32(add)), Shift);
+        }
+
+        CATHEDRAL_TARGET_AVX2 inline __m256i pack_rgba_avx2(const __m256i r, const __m256i g, const __m256i b)
+        {
+            const __m256i rg = _mm256_or_si256(r, _mm256_slli_epi32(g, 8));
+            const __m256i ba =
+                _mm256_or_si256(_mm256_slli_epi32(b, 16), _mm256_set1_epi32(static_cast<int32_t>(0xFF000000)));
+            return _mm256_or_si256(rg, ba);
+        }
+
+        CATHEDRAL_TARGET_AVX2 inline __m256i twice_plus_avx2(const __m256i a, const __m256i b)
+        {
+            return _mm256_add_epi32(_mm256_add_epi32(a, a), b);
+        }
+
+        // Expands the 565 endpoints of 8 blocks into their 4-entry palettes, returned one block per 128 bit lane
+        CATHEDRAL_TARGET_AVX2 void expand_bc_color_palettes_avx2(
+            const std::array<bc_color_block_header, 8>& headers,
+            const bool only_opaque_mode,
+            __m128i* palettes)
+        {
+            alignas(32) std::array<int32_t, 8> c0_values;
+            alignas(32) std::array<int32_t, 8> c1_values;
+            for (size_t i = 0; i < headers.size(); ++i)
+            {
+                c0_values[i] = headers[i].c0;
+                c1_values[i] = headers[i].c1;
+            }
+            const __m256i c0 = _mm256_load_si256(reinterpret_cast<const __m256i*>(c0_values.data()));
+            const __m256i c1 = _mm256_load_si256(reinterpret_cast<const __m256i*>(c1_values.data()));
+
+            const __m256i mask5 = _mm256_set1_epi32(0x1F);
+            const __m256i mask6 = _mm256_set1_epi32(0x3F);
+
+            const __m256i r0 = _mm256_and_si256(_mm256_srli_epi32(c0, 11), mask5);
+            const __m256i g0 = _mm256_and_si256(_mm256_srli_epi32(c0, 5), mask6);
+            const __m256i b0 = _mm256_and_si256(c0, mask5);
+            const __m256i r1 = _mm256_and_si256(_mm256_srli_epi32(c1, 11), mask5);
+            const __m256i g1 = _mm256_and_si256(_mm256_srli_epi32(c1, 5), mask6);
+            const __m256i b1 = _mm256_and_si256(c1, mask5);
+
+            const __m256i p0 =
+                pack_rgba_avx2(expand_avx2<6>(r0, 527, 23), expand_avx2<6>(g0, 259, 33), expand_avx2<6>(b0, 527, 23));
+            const __m256i p1 =
+                pack_rgba_avx2(expand_avx2<6>(r1, 527, 23), expand_avx2<6>(g1, 259, 33), expand_avx2<6>(b1, 527, 23));
+
+            const __m256i p2_opaque = pack_rgba_avx2(
+                expand_avx2<7>(twice_plus_avx2(r0, r1), 351, 61),
+                expand_avx2<11>(twice_plus_avx2(g0, g1), 2763, 1039),
+                expand_avx2<7>(twice_plus_avx2(b0, b1), 351, 61));
+            const __m256i p3_opaque = pack_rgba_avx2(
+                expand_avx2<7>(twice_plus_avx2(r1, r0), 351, 61),
+                expand_avx2<11>(twice_plus_avx2(g1, g0), 2763, 1039),
+                expand_avx2<7>(twice_plus_avx2(b1, b0), 351, 61));
+
+            const __m256i p2_alpha = pack_rgba_avx2(
+                expand_avx2<8>(_mm256_add_epi32(r0, r1), 1053, 125),
+                expand_avx2<11>(_mm256_add_epi32(g0, g1), 4145, 1019),
+                expand_avx2<8>(_mm256_add_epi32(b0, b1), 1053, 125));
+
+            const __m256i opaque_mask = only_opaque_mode ? _mm256_set1_epi32(-1) : _mm256_cmpgt_epi32(c0, c1);
+            const __m256i p2 = _mm256_blendv_epi8(p2_alpha, p2_opaque, opaque_mask);
+            const __m256i p3 = _mm256_and_si256(opaque_mask, p3_opaque);
+
+            // Per 128 bit lane transpose: blocks 0-3 end up in the low lanes, blocks 4-7 in the high lanes
+            const __m256i t0 = _mm256_unpacklo_epi32(p0, p1);
+            const __m256i t1 = _mm256_unpacklo_epi32(p2, p3);
+            const __m256i t2 = _mm256_unpackhi_epi32(p0, p1);
+            const __m256i t3 = _mm256_unpackhi_epi32(p2, p3);
+            const __m256i block_pairs[4] = { // NOLINT
+                _mm256_unpacklo_epi64(t0, t1),
+                _mm256_unpackhi_epi64(t0, t1),
+                _mm256_unpacklo_epi64(t2, t3),
+                _mm256_unpackhi_epi64(t2, t3)
+            };
+            for (size_t i = 0; i < 4; ++i)
+            {
+                palettes[i] = _mm256_castsi256_si128(block_pairs[i]);
+                palettes[i + 4] = _mm256_extracti128_si256(block_pairs[i], 1);
+            }
+        }
+
+        CATHEDRAL_TARGET_AVX2 void lookup_bc_color_block_avx2(
+            const __m128i palette,
+            const uint32_t indices,
+            std::byte* decompressed_block,
+            const uint32_t image_width_bytes)
+        {
+            const __m256i palette_x2 = _mm256_broadcastsi128_si256(palette);
+            const __m256i index_shifts = _mm256_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14);
+            const __m256i index_mask = _mm256_set1_epi32(0x03);
+
+            // Two rows per permute
+            for (uint32_t y = 0; y < BLOCK_DIM; y += 2)
+            {
+                const auto row_pair_indices = static_cast<int32_t>((indices >> (y * 8)) & 0xFFFF);
+                const __m256i lane_indices =
+                    _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32(row_pair_indices), index_shifts), index_mask);
+                const __m256i colors = _mm256_permutevar8x32_epi32(palette_x2, lane_indices);
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(decompressed_block), _mm256_castsi256_si128(colors));
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i*>(decompressed_block + image_width_bytes),
+                    _mm256_extracti128_si256(colors, 1));
+                decompressed_block += static_cast<size_t>(image_width_bytes) * 2;
+            }
+        }
+
+        template <texture_compression_type Type>
+        CATHEDRAL_TARGET_AVX2 void decompress_block_row_avx2(
+            const std::byte* src_row,
+            const uint32_t hblocks,
+            std::byte* dst_row,
+            const uint32_t image_width_bytes)
+        {
+            constexpr bool is_bc3 = Type == texture_compression_type::DXT5_BC3;
+            constexpr auto block_size = get_texture_compression_block_size(Type);
+            constexpr uint32_t color_offset = is_bc3 ? 8 : 0;
+            constexpr auto decompressed_block_row_bytes = get_decompressed_block_row_bytes(Type);
+            constexpr uint32_t blocks_per_iteration = 8;
+
+            uint32_t block_x = 0;
+            for (; block_x + blocks_per_iteration <= hblocks; block_x += blocks_per_iteration)
+            {
+                std::array<bc_color_block_header, blocks_per_iteration> headers;
+                for (uint32_t i = 0; i < blocks_per_iteration; ++i)
+                {
+                    headers[i] = read_bc_color_block_header(src_row + ((block_x + i) * block_size) + color_offset);
+                }
+
+                __m128i palettes[blocks_per_iteration]; // NOLINT
+                expand_bc_color_palettes_avx2(headers, is_bc3, palettes);
+
+                for (uint32_t i = 0; i < blocks_per_iteration; ++i)
+                {
+                    auto* dst = dst_row + ((block_x + i) * decompressed_block_row_bytes);
+                    lookup_bc_color_block_avx2(palettes[i], headers[i].indices, dst, image_width_bytes);
+                    if constexpr (is_bc3)
+                    {
+                        decompress_bc_alpha_block(src_row + ((block_x + i) * block_size), dst + 3, image_width_bytes, 4);
+                    }
+                }
+            }
+
+            // Leftover blocks go through the narrower path
+            decompress_block_row_sse2<Type>(
+                src_row + (block_x * block_size),
+                hblocks - block_x,
+                dst_row + (block_x * decompressed_block_row_bytes),
+                image_width_bytes);
+        }
+#endif
+
+        template <texture_compression_type Type>
+        block_row_decode_func get_block_row_decode_func(const detail::texture_decompression_isa isa)
+        {
+            // Only the BC1/BC3 color blocks have a vectorized path
+            constexpr bool has_simd_path =
+                Type == texture_compression_type::DXT1_BC1 || Type == texture_compression_type::DXT5_BC3;
+            if constexpr (!has_simd_path)
+            {
+                return &decompress_block_row_scalar<Type>;
+            }
+            else
+            {
+                switch (isa)
+                {
+                case detail::texture_decompression_isa::SCALAR:
+                    return &decompress_block_row_scalar<Type>;
+#ifdef CATHEDRAL_ARCH_X86_64
+                case detail::texture_decompression_isa::SSE2:
+                    return &decompress_block_row_sse2<Type>;
+                case detail::texture_decompression_isa::AVX2:
+                    return &decompress_block_row_avx2<Type>;
+#endif
+                default:
+                    CRITICAL_ERROR("Unsupported texture decompression instruction set");
+                }
+            }
+        }
+
+        block_row_decode_func get_block_row_decode_func(
+            const texture_compression_type type,
+            const detail::texture_decompression_isa isa)
+        {
+            switch (type)
+            {
+            case texture_compression_type::DXT1_BC1:
+                return get_block_row_decode_func<texture_compression_type::DXT1_BC1>(isa);
+            case texture_compression_type::DXT5_BC3:
+                return get_block_row_decode_func<texture_compression_type::DXT5_BC3>(isa);
+            case texture_compression_type::RGTC1_BC4:
+                return get_block_row_decode_func<texture_compression_type::RGTC1_BC4>(isa);
+            case texture_compression_type::RGTC2_BC5:
+                return get_block_row_decode_func<texture_compression_type::RGTC2_BC5>(isa);
+            case texture_compression_type::BPTC_BC7:
+                return get_block_row_decode_func<texture_compression_type::BPTC_BC7>(isa);
             default:
                 CRITICAL_ERROR("Unhandled texture compression type");
             }
@@ -177,31 +776,105 @@ namespace cathedral::engine
 
     namespace detail
     {
+        bool is_texture_decompression_isa_supported(const texture_decompression_isa isa)
+        {
+            switch (isa)
+            {
+            case texture_decompression_isa::SCALAR:
+                return true;
+#ifdef CATHEDRAL_ARCH_X86_64
+            case texture_decompression_isa::SSE2:
+                return get_cpu_features().sse2;
+            case texture_decompression_isa::AVX2:
+                return get_cpu_features().avx2;
+#endif
+            default:
+                return false;
+            }
+        }
+
+        texture_decompression_isa get_best_texture_decompression_isa()
+        {
+            static const texture_decompression_isa best_isa = [] {
+                for (const auto isa : { texture_decompression_isa::AVX2, texture_decompression_isa::SSE2 })
+                {
+                    if (is_texture_decompression_isa_supported(isa))
+                    {
+                        return isa;
+                    }
+                }
+                return texture_decompression_isa::SCALAR;
+            }();
+            return best_isa;
+        }
+
         void decompress_texture_data(
             const std::byte* src_data,
-            uint32_t image_width,
-            uint32_t image_height,
-            texture_compression_type type,
+            const uint32_t image_width,
+            const uint32_t image_height,
+            const texture_compression_type type,
             std::byte* dst_data)
         {
-            const auto hblocks = image_width / 4;
+            const auto isa = get_best_texture_decompression_isa();
+            decompress_texture_data(src_data, image_width, image_height, type, dst_data, isa);
+        }
+
+        void decompress_texture_data(
+            const std::byte* src_data,
+            const uint32_t image_width,
+            const uint32_t image_height,
+            const texture_compression_type type,
+            std::byte* dst_data,
+            const texture_decompression_isa isa)
+        {
+            CRITICAL_CHECK(is_texture_decompression_isa_supported(isa), "Unsupported texture decompression instruction set");
+
+            const auto hblocks = get_texture_compression_block_count(image_width);
+            const auto vblocks = static_cast<int>(get_texture_compression_block_count(image_height));
+            const auto full_hblocks = image_width / BLOCK_DIM;
+            const auto full_vblocks = static_cast<int>(image_height / BLOCK_DIM);
             const auto block_size = get_texture_compression_block_size(type);
-            const auto decompress_func = get_texture_compression_block_func(type);
+            const auto image_width_bytes = image_width * get_texture_compression_pixel_size(type);
+            const auto decode_row_func = get_block_row_decode_func(type, isa);
+            const auto decode_block_func = get_texture_compression_block_func(type);
 
-            for (size_t y = 0; y < image_height; y += 4)
+            const bool parallel = hblocks * static_cast<uint32_t>(vblocks) >= PARALLEL_DECODE_MIN_BLOCKS;
+
+#pragma omp parallel for schedule(static) if (parallel)
+            for (int block_y = 0; block_y < vblocks; ++block_y)
             {
-                const auto block_y = y / 4;
-                for (size_t x = 0; x < image_width; x += 4)
-                {
-                    const auto block_x = x / 4;
-                    const auto block_index = (block_y * hblocks) + block_x;
+                const auto* src_row = src_data + (static_cast<size_t>(block_y) * hblocks * block_size);
+                auto* dst_row = dst_data + (static_cast<size_t>(block_y) * BLOCK_DIM * image_width_bytes);
 
-                    const auto* dataptr = src_data + (block_size * block_index);
+                if (block_y < full_vblocks)
+                {
+                    decode_row_func(src_row, full_hblocks, dst_row, image_width_bytes);
+                    if (full_hblocks < hblocks)
+                    {
+                        decompress_edge_block(
+                            decode_block_func,
+                            type,
+                            src_row + (static_cast<size_t>(full_hblocks) * block_size),
+                            dst_row + (static_cast<size_t>(full_hblocks) * get_decompressed_block_row_bytes(type)),
+                            image_width_bytes,
+                            image_width % BLOCK_DIM,
+                            BLOCK_DIM);
+                    }
+                    continue;
+                }
 
-                    auto* dst = dst_data + (((y * image_width) + x) * 4);
-                    decompress_func(dataptr, dst, image_width * 4);
+                for (uint32_t block_x = 0; block_x < hblocks; ++block_x)
+                {
+                    decompress_edge_block(
+                        decode_block_func,
+                        type,
+                        src_row + (static_cast<size_t>(block_x) * block_size),
+                        dst_row + (static_cast<size_t>(block_x) * get_decompressed_block_row_bytes(type)),
+                        image_width_bytes,
+                        std::min(BLOCK_DIM, image_width - (block_x * BLOCK_DIM)),
+                        image_height % BLOCK_DIM);
                 }
             }
         }
     } // namespace detail
-} // namespace cathedral::engine
\ No newline at end of file
+} // namespace cathedral::engine
@@ -1,28 +1,510 @@
 #include <cathedral/engine/texture_mip.hpp>
 
 #include <cathedral/core.hpp>
+#include <cathedral/cpu_features.hpp>
+#include <cathedral/srgb.hpp>
 
 #include <ien/image/image.hpp>
 
+#ifdef CATHEDRAL_ARCH_X86_64
+    #include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
 namespace cathedral::engine
 {
-    ien::image create_image_mip(const ien::image& source, const ien::resize_filter filter)
+    namespace
     {
+        // A tile covers TILE_DIM x TILE_DIM source pixels and produces its share of the first TILE_LEVELS mips
+        constexpr uint32_t TILE_LEVELS = 6;
+        constexpr uint32_t TILE_DIM = 1U << TILE_LEVELS;
+
+        // Windowed sinc filters span this many destination pixels on each side
+        constexpr float SINC_FILTER_RADIUS = 3.0F;
+        constexpr float KAISER_ALPHA = 4.0F;
+
+        struct level_view
+        {
+            const uint8_t* data;
+            uint32_t width;
+            uint32_t height;
+        };
+
         // https://registry.khronos.org/vulkan/specs/1.3-khr-extensions/html/chap12.html#resources-image-mip-level-sizing
-        const uint32_t target_width = std::max<uint32_t>(static_cast<uint32_t>(source.width() / 2), 1);
-        const uint32_t target_height = std::max<uint32_t>(static_cast<uint32_t>(source.height() / 2), 1);
+        uint32_t get_mip_dimension(const uint32_t source_dimension, const uint32_t level)
+        {
+            return std::max<uint32_t>(source_dimension >> level, 1);
+        }
+
+#ifdef CATHEDRAL_ARCH_X86_64
+        // Averages 8 RGBA pixels from each of two rows down to 4 pixels
+        inline void box_downsample_rgba_x4_sse2(
+            const uint8_t* CATHEDRAL_RESTRICT_PTR row0,
+            const uint8_t* CATHEDRAL_RESTRICT_PTR row1,
+            uint8_t* CATHEDRAL_RESTRICT_PTR dst)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0));
+            const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 16));
+            const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1));
+            const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 16));
+
+            // Vertical sums, two pixels per register
+            const __m128i v01 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+            const __m128i v23 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+            const __m128i v45 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+            const __m128i v67 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+            // Horizontal sums of each pixel pair end up in the low half
+            const __m128i h01 = _mm_add_epi16(v01, _mm_srli_si128(v01, 8));
+            const __m128i h23 = _mm_add_epi16(v23, _mm_srli_si128(v23, 8));
+            const __m128i h45 = _mm_add_epi16(v45, _mm_srli_si128(v45, 8));
+            const __m128i h67 = _mm_add_epi16(v67, _mm_srli_si128(v67, 8));
+
+            const __m128i round = _mm_set1_epi16(2);
+            const __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(h01, h23), round), 2);
+            const __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(h45, h67), round), 2);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(lo, hi));
+        }
+#endif
+
+        // 2x2 box filter over the destination rectangle [x_begin, x_end) x [y_begin, y_end).
+        // Odd source dimensions drop their last row/column, 1 pixel wide sources repeat it.
+        template <uint32_t PixelSize>
+        void box_downsample_region(
+            const level_view& src,
+            uint8_t* dst,
+            const uint32_t dst_width,
+            const uint32_t x_begin,
+            const uint32_t x_end,
+            const uint32_t y_begin,
+            const uint32_t y_end)
+        {
+            const size_t src_row_bytes = static_cast<size_t>(src.width) * PixelSize;
+            const size_t dst_row_bytes = static_cast<size_t>(dst_width) * PixelSize;
+
+            for (uint32_t y = y_begin; y < y_end; ++y)
+            {
+                const uint8_t* row0 = src.data + (std::min(2 * y, src.height - 1) * src_row_bytes);
+                const uint8_t* row1 = src.data + (std::min((2 * y) + 1, src.height - 1) * src_row_bytes);
+                uint8_t* dst_row = dst + (y * dst_row_bytes);
+
+                uint32_t x = x_begin;
+#ifdef CATHEDRAL_ARCH_X86_64
+                if constexpr (PixelSize == 4)
+                {
+                    // Every source column must exist, the clamped edge goes through the scalar path
+                    const uint32_t simd_end = std::min(x_end, src.width / 2);
+                    for (; x + 4 <= simd_end; x += 4)
+                    {
+                        box_downsample_rgba_x4_sse2(
+                            row0 + (static_cast<size_t>(2 * x) * PixelSize),
+                            row1 + (static_cast<size_t>(2 * x) * PixelSize),
+                            dst_row + (static_cast<size_t>(x) * PixelSize));
+                    }
+                }
+#endif
+                for (; x < x_end; ++x)
+                {
+                    const size_t x0 = static_cast<size_t>(std::min(2 * x, src.width - 1)) * PixelSize;
+                    const size_t x1 = static_cast<size_t>(std::min((2 * x) + 1, src.width - 1)) * PixelSize;
+                    for (uint32_t c = 0; c < PixelSize; ++c)
+                    {
+                        const uint32_t sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+                        dst_row[(static_cast<size_t>(x) * PixelSize) + c] = static_cast<uint8_t>((sum + 2) >> 2);
+                    }
+                }
+            }
+        }
+
+        // Linear light version of box_downsample_region for sRGB encoded color channels. Alpha (the 4th channel) is
+        // stored linearly and keeps the integer average.
+        template <uint32_t PixelSize>
+        void box_downsample_region_srgb(
+            const level_view& src,
+            uint8_t* dst,
+            const uint32_t dst_width,
+            const uint32_t x_begin,
+            const uint32_t x_end,
+            const uint32_t y_begin,
+            const uint32_t y_end)
+        {
+            const size_t src_row_bytes = static_cast<size_t>(src.width) * PixelSize;
+            const size_t dst_row_bytes = static_cast<size_t>(dst_width) * PixelSize;
 
-        return source.resize(target_width, target_height, filter);
+            // Source columns [2 * x_begin, src_x_end) cover every clamped read of the region
+            const uint32_t src_x_begin = std::min(2 * x_begin, src.width - 1);
+            const uint32_t src_x_end = std::min(2 * x_end, src.width);
+            const size_t src_values = static_cast<size_t>(src_x_end - src_x_begin) * PixelSize;
+            const size_t dst_values = static_cast<size_t>(x_end - x_begin) * PixelSize;
+
+            std::vector<float> linear0(src_values);
+            std::vector<float> linear1(src_values);
+            std::vector<float> averaged(dst_values);
+
+            for (uint32_t y = y_begin; y < y_end; ++y)
+            {
+                const uint8_t* row0 = src.data + (std::min(2 * y, src.height - 1) * src_row_bytes);
+                const uint8_t* row1 = src.data + (std::min((2 * y) + 1, src.height - 1) * src_row_bytes);
+                uint8_t* dst_row = dst + (y * dst_row_bytes) + (static_cast<size_t>(x_begin) * PixelSize);
+
+                srgb_to_linear(row0 + (static_cast<size_t>(src_x_begin) * PixelSize), linear0.data(), src_values);
+                srgb_to_linear(row1 + (static_cast<size_t>(src_x_begin) * PixelSize), linear1.data(), src_values);
+
+                for (uint32_t x = x_begin; x < x_end; ++x)
+                {
+                    const size_t x0 = static_cast<size_t>(std::min(2 * x, src.width - 1) - src_x_begin) * PixelSize;
+                    const size_t x1 = static_cast<size_t>(std::min((2 * x) + 1, src.width - 1) - src_x_begin) * PixelSize;
+                    for (uint32_t c = 0; c < PixelSize; ++c)
+                    {
+                        averaged[(static_cast<size_t>(x - x_begin) * PixelSize) + c] =
+                            (linear0[x0 + c] + linear0[x1 + c] + linear1[x0 + c] + linear1[x1 + c]) * 0.25F;
+                    }
+                }
+                linear_to_srgb(averaged.data(), dst_row, dst_values);
+
+                if constexpr (PixelSize == 4)
+                {
+                    const uint8_t* alpha0 = row0 + 3;
+                    const uint8_t* alpha1 = row1 + 3;
+                    for (uint32_t x = x_begin; x < x_end; ++x)
+                    {
+                        const size_t x0 = static_cast<size_t>(std::min(2 * x, src.width - 1)) * PixelSize;
+                        const size_t x1 = static_cast<size_t>(std::min((2 * x) + 1, src.width - 1)) * PixelSize;
+                        const uint32_t sum = alpha0[x0] + alpha0[x1] + alpha1[x0] + alpha1[x1];
+                        dst_row[(static_cast<size_t>(x - x_begin) * PixelSize) + 3] = static_cast<uint8_t>((sum + 2) >> 2);
+                    }
+                }
+            }
+        }
+
+        using box_downsample_func = void (*)(const level_view&, uint8_t*, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t);
+
+        box_downsample_func get_box_downsample_func(const uint32_t pixel_size, const bool srgb)
+        {
+            switch (pixel_size)
+            {
+            case 1:
+                return srgb ? &box_downsample_region_srgb<1> : &box_downsample_region<1>;
+            case 2:
+                return srgb ? &box_downsample_region_srgb<2> : &box_downsample_region<2>;
+            case 3:
+                return srgb ? &box_downsample_region_srgb<3> : &box_downsample_region<3>;
+            case 4:
+                return srgb ? &box_downsample_region_srgb<4> : &box_downsample_region<4>;
+            default:
+                CRITICAL_ERROR("Unhandled mip pixel size");
+            }
+        }
+
+        level_view get_level_view(const mip_chain& chain, const ien::image& source, const size_t level)
+        {
+            if (level == 0)
+            {
+                return { reinterpret_cast<const uint8_t*>(source.data()),
+                         static_cast<uint32_t>(source.width()),
+                         static_cast<uint32_t>(source.height()) };
+            }
+            const auto& info = chain.level(level - 1);
+            return { reinterpret_cast<const uint8_t*>(chain.level_data(level - 1).data()), info.width, info.height };
+        }
+
+        void create_box_mips(const ien::image& source, mip_chain& chain, const bool srgb)
+        {
+            const auto downsample = get_box_downsample_func(chain.pixel_size(), srgb);
+            const auto fused_levels = std::min<size_t>(chain.level_count(), TILE_LEVELS);
+
+            const auto tiles_x = static_cast<uint32_t>((source.width() + TILE_DIM - 1) / TILE_DIM);
+            const auto tiles_y = static_cast<uint32_t>((source.height() + TILE_DIM - 1) / TILE_DIM);
+            const auto tile_count = static_cast<int>(tiles_x * tiles_y);
+
+            // Tiles are aligned to their footprint at every fused level, so they never read each other's output
+#pragma omp parallel for schedule(static)
+            for (int tile = 0; tile < tile_count; ++tile)
+            {
+                const auto tile_x = static_cast<uint32_t>(tile) % tiles_x;
+                const auto tile_y = static_cast<uint32_t>(tile) / tiles_x;
+                for (size_t level = 1; level <= fused_levels; ++level)
+                {
+                    const auto& info = chain.level(level - 1);
+                    const uint32_t level_tile_dim = TILE_DIM >> level;
+                    const uint32_t x_begin = tile_x * level_tile_dim;
+                    const uint32_t y_begin = tile_y * level_tile_dim;
+                    if (x_begin >= info.width || y_begin >= info.height)
+                    {
+                        break;
+                    }
+
+                    downsample(
+                        get_level_view(chain, source, level - 1),
+                        reinterpret_cast<uint8_t*>(chain.level_data(level - 1).data()),
+                        info.width,
+                        x_begin,
+                        std::min(x_begin + level_tile_dim, info.width),
+                        y_begin,
+                        std::min(y_begin + level_tile_dim, info.height));
+                }
+            }
+
+            // What is left is at most 1/TILE_DIM of the source per side
+            for (size_t level = fused_levels + 1; level <= chain.level_count(); ++level)
+            {
+                const auto& info = chain.level(level - 1);
+                downsample(
+                    get_level_view(chain, source, level - 1),
+                    reinterpret_cast<uint8_t*>(chain.level_data(level - 1).data()),
+                    info.width,
+                    0,
+                    info.width,
+                    0,
+                    info.height);
+            }
+        }
+
+        float sinc(const float x)
+        {
+            if (std::abs(x) < 1e-6F)
+            {
+                return 1.0F;
+            }
+            const float px = std::numbers::pi_v<float> * x;
+            return std::sin(px) / px;
+        }
+
+        // Zeroth order modified Bessel function of the first kind
+        float bessel_i0(const float x)
+        {
+            float result = 1.0F;
+            float term = 1.0F;
+            const float half_x_squared = (x * x) / 4.0F;
+            for (int k = 1; k < 32 && term > result * 1e-7F; ++k)
+            {
+                term *= half_x_squared / static_cast<float>(k * k);
+                result += term;
+            }
+            return result;
+        }
+
+        float evaluate_filter(const mip_filter filter, const float x)
+        {
+            const float ax = std::abs(x);
+            if (ax >= SINC_FILTER_RADIUS)
+            {
+                return 0.0F;
+            }
+
+            switch (filter)
+            {
+            case mip_filter::KAISER: {
+                const float t = ax / SINC_FILTER_RADIUS;
+                return sinc(x) * bessel_i0(KAISER_ALPHA * std::sqrt(1.0F - (t * t))) / bessel_i0(KAISER_ALPHA);
+            }
+            case mip_filter::LANCZOS3:
+                return sinc(x) * sinc(x / SINC_FILTER_RADIUS);
+            default:
+                CRITICAL_ERROR("Unhandled windowed sinc filter");
+            }
+        }
+
+        struct filter_tap
+        {
+            uint32_t index;
+            float weight;
+        };
+
+        // Taps of every destination pixel along one axis, flattened. Pixel i uses taps [begin[i], begin[i + 1]).
+        struct axis_filter
+        {
+            std::vector<filter_tap> taps;
+            std::vector<uint32_t> begin;
+        };
+
+        axis_filter build_axis_filter(const mip_filter filter, const uint32_t src_size, const uint32_t dst_size)
+        {
+            const float scale = static_cast<float>(src_size) / static_cast<float>(dst_size);
+            const float support = SINC_FILTER_RADIUS * scale;
+
+            axis_filter result;
+            result.begin.reserve(dst_size + 1);
+            for (uint32_t i = 0; i < dst_size; ++i)
+            {
+                result.begin.push_back(static_cast<uint32_t>(result.taps.size()));
+
+                const float center = ((static_cast<float>(i) + 0.5F) * scale) - 0.5F;
+                const auto first = static_cast<int>(std::ceil(center - support));
+                const auto last = static_cast<int>(std::floor(center + support));
+
+                float weight_sum = 0.0F;
+                for (int j = first; j <= last; ++j)
+                {
+                    const float weight = evaluate_filter(filter, (static_cast<float>(j) - center) / scale);
+                    if (weight == 0.0F)
+                    {
+                        continue;
+                    }
+                    const auto index = static_cast<uint32_t>(std::clamp(j, 0, static_cast<int>(src_size) - 1));
+                    result.taps.push_back({ index, weight });
+                    weight_sum += weight;
+                }
+
+                for (auto tap = result.begin.back(); tap < result.taps.size(); ++tap)
+                {
+                    result.taps[tap].weight /= weight_sum;
+                }
+            }
+            result.begin.push_back(static_cast<uint32_t>(result.taps.size()));
+            return result;
+        }
+
+        void sinc_downsample_level(
+            const level_view& src,
+            const mip_level& dst_info,
+            uint8_t* dst,
+            const mip_filter filter,
+            const uint32_t pixel_size,
+            const bool srgb)
+        {
+            const auto horizontal = build_axis_filter(filter, src.width, dst_info.width);
+            const auto vertical = build_axis_filter(filter, src.height, dst_info.height);
+
+            const size_t src_row_values = static_cast<size_t>(src.width) * pixel_size;
+            const size_t dst_row_values = static_cast<size_t>(dst_info.width) * pixel_size;
+            const auto dst_height = static_cast<int>(dst_info.height);
+
+#pragma omp parallel
+            {
+                std::vector<float> column_sums(src_row_values);
+                std::vector<float> src_linear(srgb ? src_row_values : 0);
+                std::vector<float> dst_linear(srgb ? dst_row_values : 0);
+
+#pragma omp for schedule(static)
+                for (int y = 0; y < dst_height; ++y)
+                {
+                    // Vertical pass into a single row, then the horizontal pass straight into the destination
+                    std::fill(column_sums.begin(), column_sums.end(), 0.0F);
+                    for (auto tap = vertical.begin[y]; tap < vertical.begin[y + 1]; ++tap)
+                    {
+                        const auto [index, weight] = vertical.taps[tap];
+                        const uint8_t* src_row = src.data + (index * src_row_values);
+                        if (srgb)
+                        {
+                            // Filter in linear light, scaled back to the byte range. Alpha is already linear.
+                            srgb_to_linear(src_row, src_linear.data(), src_row_values);
+                            for (size_t i = 3; pixel_size == 4 && i < src_row_values; i += 4)
+                            {
+                                src_linear[i] = static_cast<float>(src_row[i]) / 255.0F;
+                            }
+                            for (size_t i = 0; i < src_row_values; ++i)
+                            {
+                                column_sums[i] += weight * src_linear[i] * 255.0F;
+                            }
+                        }
+                        else
+                        {
+                            for (size_t i = 0; i < src_row_values; ++i)
+                            {
+                                column_sums[i] += weight * src_row[i];
+                            }
+                        }
+                    }
+
+                    uint8_t* dst_row = dst + (static_cast<size_t>(y) * dst_row_values);
+                    for (uint32_t x = 0; x < dst_info.width; ++x)
+                    {
+                        for (uint32_t c = 0; c < pixel_size; ++c)
+                        {
+                            float value = 0.0F;
+                            for (auto tap = horizontal.begin[x]; tap < horizontal.begin[x + 1]; ++tap)
+                            {
+                                const auto [index, weight] = horizontal.taps[tap];
+                                value += weight * column_sums[(static_cast<size_t>(index) * pixel_size) + c];
+                            }
+                            const size_t dst_index = (static_cast<size_t>(x) * pixel_size) + c;
+                            if (srgb)
+                            {
+                                dst_linear[dst_index] = value / 255.0F;
+                            }
+                            else
+                            {
+                                dst_row[dst_index] = static_cast<uint8_t>(std::clamp(std::lround(value), 0L, 255L));
+                            }
+                        }
+                    }
+
+                    if (srgb)
+                    {
+                        linear_to_srgb(dst_linear.data(), dst_row, dst_row_values);
+                        for (size_t i = 3; pixel_size == 4 && i < dst_row_values; i += 4)
+                        {
+                            dst_row[i] = static_cast<uint8_t>(std::clamp(std::lround(dst_linear[i] * 255.0F), 0L, 255L));
+                        }
+                    }
+                }
+            }
+        }
+
+        void create_sinc_mips(const ien::image& source, mip_chain& chain, const mip_filter filter, const bool srgb)
+        {
+            for (size_t level = 1; level <= chain.level_count(); ++level)
+            {
+                sinc_downsample_level(
+                    get_level_view(chain, source, level - 1),
+                    chain.level(level - 1),
+                    reinterpret_cast<uint8_t*>(chain.level_data(level - 1).data()),
+                    filter,
+                    chain.pixel_size(),
+                    srgb);
+            }
+        }
+    } // namespace
+
+    mip_chain::mip_chain(
+        const uint32_t source_width,
+        const uint32_t source_height,
+        const uint32_t pixel_size,
+        const uint32_t mip_count)
+        : _pixel_size(pixel_size)
+    {
+        size_t offset = 0;
+        for (uint32_t level = 1; level <= mip_count; ++level)
+        {
+            const uint32_t prev_width = get_mip_dimension(source_width, level - 1);
+            const uint32_t prev_height = get_mip_dimension(source_height, level - 1);
+            if (prev_width == 1 && prev_height == 1)
+            {
+                break;
+            }
+
+            const uint32_t width = get_mip_dimension(source_width, level);
+            const uint32_t height = get_mip_dimension(source_height, level);
+            const size_t size = static_cast<size_t>(width) * height * pixel_size;
+            _levels.push_back({ width, height, offset, size });
+            offset += size;
+        }
+        _data.resize(offset);
     }
 
-    std::vector<ien::image> create_image_mips(const ien::image& source, ien::resize_filter filter, uint32_t mip_count)
+    mip_chain create_image_mips(
+        const ien::image& source,
+        const mip_filter filter,
+        const uint32_t mip_count,
+        const bool srgb)
     {
-        std::vector<ien::image> result;
-        result.reserve(mip_count);
-        for (size_t i = 0; i < mip_count; ++i)
+        const auto pixel_size = static_cast<uint32_t>(source.size() / (source.width() * source.height()));
+        mip_chain result(static_cast<uint32_t>(source.width()), static_cast<uint32_t>(source.height()), pixel_size, mip_count);
+
+        if (filter == mip_filter::BOX)
+        {
+            create_box_mips(source, result, srgb);
+        }
+        else
         {
-            result.push_back(create_image_mip(result.empty() ? source : result.back(), filter));
+            create_sinc_mips(source, result, filter, srgb);
         }
         return result;
     }
-} // namespace cathedral::engine
\ No newline at end of file
+} // namespace cathedral::engine
@@ -0,0 +1,238 @@
+#include <cathedral/engine/texture_streamer.hpp>
+
+#include <cathedral/engine/upload_queue.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+
+namespace cathedral::engine
+{
+    uint32_t calc_texture_streaming_mip(const glm::uvec2 texture_size, const float projected_size, const uint32_t mip_count)
+    {
+        CRITICAL_CHECK(mip_count > 0, "Invalid mip count");
+
+        const auto last_mip = static_cast<float>(mip_count - 1);
+        if (!(projected_size > 0.0F))
+        {
+            return mip_count - 1;
+        }
+
+        const auto texels = static_cast<float>(std::max(texture_size.x, texture_size.y));
+        const float mip = std::floor(std::log2(texels / projected_size));
+        return static_cast<uint32_t>(std::clamp(mip, 0.0F, last_mip));
+    }
+
+    size_t calc_texture_streaming_budget(
+        const gfx::memory_budget_event& event,
+        const size_t configured_budget,
+        const size_t resident_size)
+    {
+        if (!event.over_budget)
+        {
+            return configured_budget;
+        }
+
+        const size_t other_usage = event.usage > resident_size ? event.usage - resident_size : 0;
+        const size_t headroom = event.threshold > other_usage ? event.threshold - other_usage : 0;
+        return std::min(configured_budget, headroom);
+    }
+
+    namespace
+    {
+        size_t resident_bytes(const texture_streaming_state& state, const uint32_t base_mip)
+        {
+            size_t result = 0;
+            for (size_t mip = base_mip; mip < state.mip_bytes.size(); ++mip)
+            {
+                result += state.mip_bytes[mip];
+            }
+            return result;
+        }
+
+        std::vector<size_t> sorted_indices(
+            const std::span<const texture_streaming_state> textures,
+            const std::function<bool(const texture_streaming_state&, const texture_streaming_state&)>& less)
+        {
+            std::vector<size_t> result(textures.size());
+            std::iota(result.begin(), result.end(), 0);
+            std::ranges::stable_sort(result, [&](const size_t lhs, const size_t rhs) {
+                return less(textures[lhs], textures[rhs]);
+            });
+            return result;
+        }
+    } // namespace
+
+    std::vector<texture_streaming_change> plan_texture_evictions(
+        const std::span<const texture_streaming_state> textures,
+        size_t resident_size,
+        const size_t budget)
+    {
+        std::vector<texture_streaming_change> result;
+        if (resident_size <= budget)
+        {
+            return result;
+        }
+
+        // Textures that hold more than they currently need give it back, least recently used first
+        const auto order = sorted_indices(textures, [](const auto& lhs, const auto& rhs) {
+            return lhs.last_used_frame < rhs.last_used_frame;
+        });
+        for (const size_t index : order)
+        {
+            if (resident_size <= budget)
+            {
+                break;
+            }
+
+            const auto& state = textures[index];
+            const uint32_t evict_to = std::min(state.target_mip, state.min_resident_base_mip);
+            if (evict_to > state.resident_base_mip)
+            {
+                resident_size -= resident_bytes(state, state.resident_base_mip) - resident_bytes(state, evict_to);
+                result.push_back({ .texture_index = index, .base_mip = evict_to });
+            }
+        }
+        return result;
+    }
+
+    std::vector<texture_streaming_change> plan_texture_upgrades(
+        const std::span<const texture_streaming_state> textures,
+        size_t resident_size,
+        const size_t budget,
+        const uint32_t max_upgrades)
+    {
+        const auto order = sorted_indices(textures, [](const auto& lhs, const auto& rhs) {
+            if (lhs.last_used_frame != rhs.last_used_frame)
+            {
+                return lhs.last_used_frame > rhs.last_used_frame;
+            }
+            const auto lhs_distance = static_cast<int64_t>(lhs.resident_base_mip) - lhs.target_mip;
+            const auto rhs_distance = static_cast<int64_t>(rhs.resident_base_mip) - rhs.target_mip;
+            return lhs_distance > rhs_distance;
+        });
+
+        std::vector<texture_streaming_change> result;
+        for (const size_t index : order)
+        {
+            if (result.size() == max_upgrades)
+            {
+                break;
+            }
+
+            const auto& state = textures[index];
+            const uint32_t target = std::min(state.target_mip, state.min_resident_base_mip);
+            if (target >= state.resident_base_mip)
+            {
+                continue;
+            }
+
+            const uint32_t next_mip = state.resident_base_mip - 1;
+            if (resident_size + state.mip_bytes[next_mip] > budget)
+            {
+                continue;
+            }
+
+            resident_size += state.mip_bytes[next_mip];
+            result.push_back({ .texture_index = index, .base_mip = next_mip });
+        }
+        return result;
+    }
+
+    texture_streamer::texture_streamer(texture_streamer_args args, const uint32_t frames_in_flight)
+        : _args(args)
+        , _frames_in_flight(frames_in_flight)
+    {
+        CRITICAL_CHECK(_frames_in_flight > 0, "Invalid frames in flight count");
+    }
+
+    void texture_streamer::add_texture(const std::shared_ptr<texture>& tex)
+    {
+        CRITICAL_CHECK_NOTNULL(tex);
+        CRITICAL_CHECK(tex->is_streamed(), "Attempt to stream a non streamed texture");
+        entry info{ .tex = tex };
+        for (uint32_t mip = 0; mip < tex->mip_count(); ++mip)
+        {
+            info.mip_bytes.push_back(tex->mip_size_bytes(mip));
+        }
+        _entries[tex.get()] = std::move(info);
+    }
+
+    void texture_streamer::request_mip(const texture& tex, const uint32_t mip_index)
+    {
+        if (const auto it = _entries.find(&tex); it != _entries.end())
+        {
+            it->second.requested_mip = std::min(it->second.requested_mip, mip_index);
+        }
+    }
+
+    void texture_streamer::update(upload_queue& queue, const uint64_t frame)
+    {
+        // Anything replaced 'frames in flight' updates ago is no longer referenced by a command buffer
+        while (!_retired.empty() && _retired.front().first + _frames_in_flight <= frame)
+        {
+            _retired.pop_front();
+        }
+
+        std::vector<std::shared_ptr<texture>> live;
+        std::vector<texture_streaming_state> states;
+        live.reserve(_entries.size());
+        states.reserve(_entries.size());
+        _resident_size = 0;
+
+        for (auto it = _entries.begin(); it != _entries.end();)
+        {
+            auto tex = it->second.tex.lock();
+            if (tex == nullptr)
+            {
+                it = _entries.erase(it);
+                continue;
+            }
+
+            auto& info = it->second;
+            if (info.requested_mip != std::numeric_limits<uint32_t>::max())
+            {
+                info.target_mip = info.requested_mip;
+                info.requested_mip = std::numeric_limits<uint32_t>::max();
+                info.last_used_frame = frame;
+            }
+            else if (frame - info.last_used_frame > _args.eviction_delay_frames)
+            {
+                info.target_mip = tex->min_resident_base_mip();
+            }
+
+            _resident_size += tex->resident_size_bytes();
+            states.push_back({ .resident_base_mip = tex->resident_base_mip(),
+                               .min_resident_base_mip = tex->min_resident_base_mip(),
+                               .target_mip = info.target_mip,
+                               .last_used_frame = info.last_used_frame,
+                               .mip_bytes = info.mip_bytes });
+            live.push_back(std::move(tex));
+            ++it;
+        }
+
+        for (const auto& change : plan_texture_evictions(states, _resident_size, _args.vram_budget))
+        {
+            change_residency(*live[change.texture_index], change.base_mip, queue, frame);
+            states[change.texture_index].resident_base_mip = change.base_mip;
+        }
+
+        for (const auto& change :
+             plan_texture_upgrades(states, _resident_size, _args.vram_budget, _args.max_upgrades_per_frame))
+        {
+            change_residency(*live[change.texture_index], change.base_mip, queue, frame);
+        }
+    }
+
+    void texture_streamer::change_residency(
+        texture& tex,
+        const uint32_t base_mip,
+        upload_queue& queue,
+        const uint64_t frame)
+    {
+        _resident_size -= tex.resident_size_bytes();
+        _retired.emplace_back(frame, tex.set_resident_base_mip(base_mip, queue));
+        _resident_size += tex.resident_size_bytes();
+    }
+} // namespace cathedral::engine
@@ -0,0 +1,65 @@
+#include <cathedral/engine/uniform_arena.hpp>
+
+#include <cathedral/gfx/vulkan_context.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace cathedral::engine
+{
+    namespace
+    {
+        constexpr uint32_t align_up(const uint32_t value, const uint32_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    } // namespace
+
+    uniform_arena::uniform_arena(const gfx::vulkan_context& vkctx, uniform_arena_args args)
+        : _vkctx(vkctx)
+        , _args(args)
+        , _alignment(std::max(vkctx.min_uniform_buffer_offset_alignment(), 16U))
+    {
+        CRITICAL_CHECK(_args.frame_count > 0, "Uniform arena requires at least one frame");
+
+        _args.frame_size = align_up(std::max(_args.frame_size, EMPTY_BLOCK_RANGE), _alignment);
+
+        gfx::uniform_buffer_args buff_args;
+        buff_args.vkctx = &vkctx;
+        buff_args.size = static_cast<size_t>(_args.frame_size) * _args.frame_count;
+        buff_args.host_mapped = true;
+        _buffer = std::make_unique<gfx::uniform_buffer>(buff_args);
+    }
+
+    void uniform_arena::begin_frame()
+    {
+        _frame_index = (_frame_index + 1) % _args.frame_count;
+        _offset = 0;
+    }
+
+    uint32_t uniform_arena::write(const std::span<const std::byte> data)
+    {
+        const uint32_t offset = align_up(_offset, _alignment);
+        CRITICAL_CHECK(offset + data.size() <= _args.frame_size, "Uniform arena frame size exceeded");
+
+        const uint32_t result = (_frame_index * _args.frame_size) + offset;
+        std::memcpy(_buffer->mapped_memory() + result, data.data(), data.size());
+
+        _offset = offset + static_cast<uint32_t>(data.size());
+        return result;
+    }
+
+    void uniform_arena::write_descriptor(
+        descriptor_write_batch& batch,
+        const vk::DescriptorSet set,
+        const uint32_t binding,
+        const uint32_t block_size) const
+    {
+        vk::DescriptorBufferInfo buffer_info;
+        buffer_info.buffer = _buffer->buffer();
+        buffer_info.offset = 0;
+        buffer_info.range = block_size > 0 ? block_size : EMPTY_BLOCK_RANGE;
+
+        batch.write_buffer(set, binding, vk::DescriptorType::eUniformBufferDynamic, buffer_info);
+    }
+} // namespace cathedral::engine
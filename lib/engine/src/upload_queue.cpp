@@ -3,22 +3,50 @@
 #include <cathedral/gfx/image.hpp>
 #include <cathedral/gfx/vulkan_context.hpp>
 
-#include <cmath>
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 namespace cathedral::engine
 {
-    upload_queue::upload_queue(const gfx::vulkan_context& vkctx, uint32_t staging_buff_size)
+    namespace
+    {
+        constexpr uint32_t STAGING_ALIGNMENT = 16; // Image copies need offsets aligned to the texel block size
+        constexpr uint32_t BUFFER_STAGING_ALIGNMENT = 4; // Small enough for consecutive updates to stay contiguous
+
+        constexpr uint32_t align_up(const uint32_t value, const uint32_t alignment = STAGING_ALIGNMENT)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    } // namespace
+
+    upload_queue::upload_queue(const gfx::vulkan_context& vkctx, uint32_t staging_buff_size, const uint32_t frame_count)
         : _vkctx(vkctx)
     {
+        CRITICAL_CHECK(frame_count > 0, "Upload queue requires at least one frame");
+
+        _region_size = staging_buff_size / frame_count / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+        CRITICAL_CHECK(_region_size > 0, "Staging buffer too small for the requested frame count");
+
         gfx::staging_buffer_args sbuff_args;
-        sbuff_args.size = staging_buff_size;
+        sbuff_args.size = static_cast<size_t>(_region_size) * frame_count;
         sbuff_args.vkctx = &vkctx;
 
         _staging_buffer = std::make_unique<gfx::staging_buffer>(sbuff_args);
+        _staging_buffer->map_memory();
 
-        _cmdbuff = vkctx.create_primary_commandbuffer();
+        _frames.resize(frame_count);
+        for (auto& frame : _frames)
+        {
+            frame.cmdbuff = vkctx.create_primary_commandbuffer();
+            frame.fence = vkctx.create_signaled_fence();
+            if (uses_transfer_queue())
+            {
+                frame.transfer_cmdbuff = vkctx.create_transfer_commandbuffer();
+            }
+        }
 
-        _fence = vkctx.create_signaled_fence();
+        _transfer_timeline = vkctx.create_timeline_semaphore();
     }
 
     void upload_queue::update_buffer(
@@ -53,81 +81,262 @@ namespace cathedral::engine
         update_generic_buffer(target_buffer, target_offset, data);
     }
 
+    void upload_queue::begin_image_upload(const gfx::image& target_image)
+    {
+        ++_frame_stats.barriers;
+        target_image.transition_layout_suboptimal(
+            vk::ImageLayout::eUndefined,
+            vk::ImageLayout::eTransferDstOptimal,
+            image_cmdbuff(),
+            target_image.aspect_flags(),
+            0,
+            target_image.mip_levels());
+    }
+
+    void upload_queue::end_image_upload(const gfx::image& target_image)
+    {
+        ++_frame_stats.barriers;
+        if (!uses_transfer_queue())
+        {
+            target_image.transition_layout_suboptimal(
+                vk::ImageLayout::eTransferDstOptimal,
+                vk::ImageLayout::eShaderReadOnlyOptimal,
+                image_cmdbuff(),
+                target_image.aspect_flags(),
+                0,
+                target_image.mip_levels());
+            return;
+        }
+
+        // Queue family ownership transfer: released here, acquired by the graphics queue once the transfer completes
+        vk::ImageMemoryBarrier2 release;
+        release.image = target_image.get_image();
+        release.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+        release.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+        release.srcQueueFamilyIndex = _vkctx.transfer_queue_family_index();
+        release.dstQueueFamilyIndex = _vkctx.graphics_queue_family_index();
+        release.srcStageMask = vk::PipelineStageFlagBits2::eTransfer;
+        release.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+        release.dstStageMask = vk::PipelineStageFlagBits2::eNone;
+        release.dstAccessMask = vk::AccessFlagBits2::eNone;
+        release.subresourceRange.aspectMask = target_image.aspect_flags();
+        release.subresourceRange.baseArrayLayer = 0;
+        release.subresourceRange.baseMipLevel = 0;
+        release.subresourceRange.layerCount = 1;
+        release.subresourceRange.levelCount = target_image.mip_levels();
+
+        vk::DependencyInfo depinfo;
+        depinfo.imageMemoryBarrierCount = 1;
+        depinfo.pImageMemoryBarriers = &release;
+        image_cmdbuff().pipelineBarrier2(depinfo);
+
+        vk::ImageMemoryBarrier2 acquire = release;
+        acquire.srcStageMask = vk::PipelineStageFlagBits2::eNone;
+        acquire.srcAccessMask = vk::AccessFlagBits2::eNone;
+        acquire.dstStageMask = vk::PipelineStageFlagBits2::eAllCommands;
+        acquire.dstAccessMask = vk::AccessFlagBits2::eMemoryRead;
+        current_frame().acquire_barriers.push_back(acquire);
+    }
+
     void upload_queue::update_image(const gfx::image& target_image, const std::span<const std::byte> data,
         const uint32_t mip_level)
     {
-        prepare_to_record();
+        if (data.size() > _region_size)
+        {
+            update_image_chunked(target_image, data, mip_level);
+            return;
+        }
 
-        if (data.size() > _staging_buffer->size())
+        update_image(target_image, data.size(), mip_level, [data](const std::span<std::byte> staging) {
+            std::memcpy(staging.data(), data.data(), data.size());
+        });
+    }
+
+    void upload_queue::update_image(
+        const gfx::image& target_image,
+        const size_t size,
+        const uint32_t mip_level,
+        const std::function<void(std::span<std::byte>)>& fill)
+    {
+        if (size > _region_size)
         {
-            CRITICAL_ERROR("Image update operation exceeds size of staging buffer");
+            // Has to be split across staging blocks, so it cannot be written in place
+            if (_fill_scratch.size() < size)
+            {
+                _fill_scratch.resize(size);
+            }
+            const std::span<std::byte> data(_fill_scratch.data(), size);
+            fill(data);
+            update_image_chunked(target_image, data, mip_level);
             return;
         }
 
-        // Align offset to 16 bytes
-        if (_offset % 16 != 0)
+        prepare_to_record();
+
+        const auto staging = allocate_staging(size, STAGING_ALIGNMENT);
+        fill({ staging.data, size });
+
+        record_image_copy(target_image, staging, mip_level, 0, std::max(target_image.height() >> mip_level, 1U));
+    }
+
+    void upload_queue::update_image_chunked(
+        const gfx::image& target_image,
+        const std::span<const std::byte> data,
+        const uint32_t mip_level)
+    {
+        prepare_to_record();
+
+        // Every chunk holds whole rows of texels, or whole rows of blocks for block compressed images
+        const auto mip_height = std::max(target_image.height() >> mip_level, 1U);
+        const uint32_t block_height = target_image.compressed() ? 4 : 1;
+        const uint32_t block_rows = (mip_height + block_height - 1) / block_height;
+        CRITICAL_CHECK(data.size() % block_rows == 0, "Image data is not made of whole rows");
+
+        const size_t row_size = data.size() / block_rows;
+        CRITICAL_CHECK(row_size <= _region_size, "Image row exceeds size of staging region");
+
+        uint32_t row = 0;
+        while (row < block_rows)
         {
-            _offset += (16 - (_offset % 16));
+            reserve_chunk(row_size);
+
+            // Fill what is left of the current staging block first, then move on in region sized pieces
+            const size_t space_left = staging_space_left();
+            const size_t max_rows = (space_left >= row_size ? space_left : _region_size) / row_size;
+            const auto rows = static_cast<uint32_t>(std::min<size_t>(max_rows, block_rows - row));
+            const size_t chunk_size = rows * row_size;
+
+            const auto staging = allocate_staging(chunk_size, STAGING_ALIGNMENT);
+            std::memcpy(staging.data, data.data() + (row * row_size), chunk_size);
+
+            const uint32_t y_offset = row * block_height;
+            record_image_copy(
+                target_image,
+                staging,
+                mip_level,
+                y_offset,
+                std::min(rows * block_height, mip_height - y_offset));
+
+            row += rows;
         }
+    }
 
-        if (_offset + data.size() > _staging_buffer->size())
+    void upload_queue::reserve_chunk(const size_t size)
+    {
+        prepare_to_record();
+        if (staging_space_left() < size && current_frame().overflow_size >= _region_size)
         {
-            submit_current();
+            submit_handoff();
         }
+    }
+
+    void upload_queue::submit_handoff()
+    {
+        flush_buffer_copies();
+        submit_transfers();
+        cmdbuff().end();
 
-        auto* mem = static_cast<uint8_t*>(_staging_buffer->map_memory());
-        std::memcpy(mem + _offset, data.data(), data.size());
+        const vk::PipelineStageFlags wait_stage = vk::PipelineStageFlagBits::eAllCommands;
 
-        const auto target_width = static_cast<uint32_t>(target_image.width() / std::pow(2, mip_level));
-        const auto target_height = static_cast<uint32_t>(target_image.height() / std::pow(2, mip_level));
+        vk::TimelineSemaphoreSubmitInfo timeline_info;
+        timeline_info.waitSemaphoreValueCount = 1;
+        timeline_info.pWaitSemaphoreValues = &_transfer_wait_value;
 
-        if (target_width == 0 || target_height == 0)
+        vk::SubmitInfo submit_info;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &*current_frame().cmdbuff;
+        if (_transfer_wait_value != 0)
         {
-            return;
+            submit_info.pNext = &timeline_info;
+            submit_info.waitSemaphoreCount = 1;
+            submit_info.pWaitSemaphores = &*_transfer_timeline;
+            submit_info.pWaitDstStageMask = &wait_stage;
         }
+        _vkctx.graphics_queue().submit(submit_info, *current_frame().fence);
+
+        ++_stats.handoffs;
+        notify_submitted();
+
+        // Waits for the next region if the GPU still holds it
+        prepare_to_record();
+    }
+
+    void upload_queue::record_image_copy(
+        const gfx::image& target_image,
+        const staging_allocation& src,
+        const uint32_t mip_level,
+        const uint32_t y_offset,
+        const uint32_t height)
+    {
+        // Block compressed mips keep their real extent: a copy reaching the mip edge may end in a partial block,
+        // while the staged data still holds whole, tightly packed blocks
+        const auto target_width = std::max(target_image.width() >> mip_level, 1U);
 
         vk::BufferImageCopy copy;
         copy.bufferImageHeight = 0;
         copy.bufferRowLength = 0;
-        copy.bufferOffset = _offset;
-        copy.imageOffset = vk::Offset3D{ .x = 0, .y = 0, .z = 0 };
-        copy.imageExtent = vk::Extent3D{ .width = target_width, .height = target_height, .depth = 1U };
+        copy.bufferOffset = src.offset;
+        copy.imageOffset = vk::Offset3D{ .x = 0, .y = static_cast<int32_t>(y_offset), .z = 0 };
+        copy.imageExtent = vk::Extent3D{ .width = target_width, .height = height, .depth = 1U };
         copy.imageSubresource.aspectMask = target_image.aspect_flags();
         copy.imageSubresource.baseArrayLayer = 0;
         copy.imageSubresource.mipLevel = mip_level;
         copy.imageSubresource.layerCount = 1;
 
-        _cmdbuff->copyBufferToImage(
-            _staging_buffer->buffer(),
+        image_cmdbuff().copyBufferToImage(
+            src.buffer,
             target_image.get_image(),
             vk::ImageLayout::eTransferDstOptimal,
             copy);
-
-        _offset += static_cast<uint32_t>(data.size());
+        ++_frame_stats.copy_commands;
+        ++_frame_stats.copy_regions;
     }
 
     void upload_queue::record(const std::function<void(vk::CommandBuffer)>& fn)
     {
         prepare_to_record();
-        fn(*_cmdbuff);
+        flush_buffer_copies();
+        fn(cmdbuff());
+    }
+
+    void upload_queue::record_after_transfers(std::function<void(vk::CommandBuffer)> fn)
+    {
+        if (!uses_transfer_queue())
+        {
+            record(fn);
+            return;
+        }
+
+        // There is always a transfer submission to follow, the images this depends on were uploaded on it
+        CRITICAL_CHECK(current_frame().transfer_recording, "No transfers to record after");
+        current_frame().after_transfers.push_back(std::move(fn));
     }
 
     void upload_queue::prepare_to_submit()
     {
         prepare_to_record();
-        _cmdbuff->end();
+        flush_buffer_copies();
+        submit_transfers();
+        cmdbuff().end();
+
+        _last_frame_stats = _frame_stats;
+        _frame_stats = {};
         _state = upload_queue_state::PENDING_SUBMIT;
     }
 
     void upload_queue::notify_submitted()
     {
+        current_frame().fence_needs_wait = true;
+        _transfer_wait_value = 0;
+
+        // Recording moves on to the next frame's region, which is reclaimed once its fence has been waited
+        _frame_index = (_frame_index + 1) % static_cast<uint32_t>(_frames.size());
         _state = upload_queue_state::SUBMITTED;
-        _fence_needs_wait = true;
     }
 
     void upload_queue::notify_fence_waited()
     {
-        _fence_needs_wait = false;
+        current_frame().fence_needs_wait = false;
     }
 
     void upload_queue::update_generic_buffer(
@@ -135,57 +344,194 @@ namespace cathedral::engine
         const uint32_t target_offset,
         const std::span<const std::byte> data)
     {
-        if (data.size() > _staging_buffer->size())
+        // Oversized updates are staged one region sized piece at a time
+        if (data.size() > _region_size)
         {
-            CRITICAL_ERROR("Buffer update operation exceeds size of staging buffer");
+            const size_t chunk_size = _region_size;
+            for (size_t offset = 0; offset < data.size(); offset += chunk_size)
+            {
+                reserve_chunk(std::min(chunk_size, data.size() - offset));
+                update_generic_buffer(
+                    target_buffer,
+                    target_offset + static_cast<uint32_t>(offset),
+                    data.subspan(offset, std::min(chunk_size, data.size() - offset)));
+            }
             return;
         }
 
         prepare_to_record();
 
-        if (_offset + data.size() > _staging_buffer->size())
+        const auto staging = allocate_staging(data.size(), BUFFER_STAGING_ALIGNMENT);
+        std::memcpy(staging.data, data.data(), data.size());
+
+        _pending_buffer_copies[static_cast<VkBuffer>(target_buffer.buffer())].add(staging.buffer, staging.offset, target_offset, data.size());
+    }
+
+    void upload_queue::flush_buffer_copies()
+    {
+        if (_pending_buffer_copies.empty())
         {
-            submit_current();
+            return;
         }
 
-        auto* mem = static_cast<uint8_t*>(_staging_buffer->map_memory());
-        std::memcpy(mem + _offset, data.data(), data.size());
+        std::vector<vk::BufferMemoryBarrier2> barriers;
+        barriers.reserve(_pending_buffer_copies.size());
+
+        std::vector<vk::BufferCopy> regions;
+        for (auto& [target_buffer, copies] : _pending_buffer_copies)
+        {
+            // One copy command per staging buffer, which is nearly always just the ring
+            auto pending = copies.copies();
+            std::ranges::stable_sort(pending, {}, [](const buffer_copy& copy) {
+                return static_cast<VkBuffer>(copy.src);
+            });
 
-        vk::BufferCopy copy;
-        copy.srcOffset = _offset;
-        copy.dstOffset = target_offset;
-        copy.size = data.size();
+            for (auto it = pending.begin(); it != pending.end();)
+            {
+                const auto src = it->src;
+                regions.clear();
+                for (; it != pending.end() && it->src == src; ++it)
+                {
+                    regions.push_back(it->region);
+                }
+
+                cmdbuff().copyBuffer(src, vk::Buffer(target_buffer), regions);
+                ++_frame_stats.copy_commands;
+                _frame_stats.copy_regions += static_cast<uint32_t>(regions.size());
+            }
 
-        _cmdbuff->copyBuffer(_staging_buffer->buffer(), target_buffer.buffer(), copy);
+            vk::BufferMemoryBarrier2 barrier;
+            barrier.buffer = vk::Buffer(target_buffer);
+            barrier.srcStageMask = vk::PipelineStageFlagBits2::eTransfer;
+            barrier.srcAccessMask = vk::AccessFlagBits2::eTransferWrite;
+            barrier.dstStageMask = vk::PipelineStageFlagBits2::eAllCommands;
+            barrier.dstAccessMask = vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite;
+            barrier.offset = copies.dst_begin();
+            barrier.size = copies.dst_end() - copies.dst_begin();
+            barriers.push_back(barrier);
+        }
 
-        vk::BufferMemoryBarrier barrier;
-        barrier.buffer = target_buffer.buffer();
-        barrier.srcAccessMask = vk::AccessFlagBits::eMemoryWrite;
-        barrier.dstAccessMask = vk::AccessFlagBits::eMemoryWrite;
-        barrier.dstQueueFamilyIndex = _vkctx.graphics_queue_family_index();
-        barrier.offset = copy.dstOffset;
-        barrier.size = copy.size;
+        // A single barrier batch makes every copy visible to whatever comes next
+        vk::DependencyInfo depinfo;
+        depinfo.bufferMemoryBarrierCount = static_cast<uint32_t>(barriers.size());
+        depinfo.pBufferMemoryBarriers = barriers.data();
+        cmdbuff().pipelineBarrier2(depinfo);
+        _frame_stats.barriers += static_cast<uint32_t>(barriers.size());
 
-        _cmdbuff->pipelineBarrier(
-            vk::PipelineStageFlagBits::eTransfer,
-            vk::PipelineStageFlagBits::eTransfer,
-            static_cast<vk::DependencyFlags>(0),
-            {},
-            barrier,
-            {});
+        _pending_buffer_copies.clear();
+    }
 
-        _offset += static_cast<uint32_t>(data.size());
+    bool upload_queue::uses_transfer_queue() const
+    {
+        return _vkctx.has_transfer_queue();
     }
 
-    void upload_queue::submit_current()
+    vk::CommandBuffer upload_queue::image_cmdbuff()
     {
-        _cmdbuff->end();
-        _vkctx.submit_commandbuffer_sync(*_cmdbuff);
+        prepare_to_record();
+        if (!uses_transfer_queue())
+        {
+            return cmdbuff();
+        }
 
-        _cmdbuff->reset();
-        _cmdbuff->begin(vk::CommandBufferBeginInfo{});
-        _offset = 0;
-        _state = upload_queue_state::RECORDING;
+        // Reusing it is safe once the frame's region is reclaimed, the graphics submission waited for the transfer
+        auto& frame = current_frame();
+        if (!frame.transfer_recording)
+        {
+            frame.transfer_cmdbuff->reset();
+            frame.transfer_cmdbuff->begin(vk::CommandBufferBeginInfo{});
+            frame.transfer_recording = true;
+        }
+        return *frame.transfer_cmdbuff;
+    }
+
+    void upload_queue::submit_transfers()
+    {
+        auto& frame = current_frame();
+        if (!frame.transfer_recording)
+        {
+            return;
+        }
+
+        frame.transfer_cmdbuff->end();
+        frame.transfer_recording = false;
+
+        ++_transfer_timeline_value;
+        vk::TimelineSemaphoreSubmitInfo timeline_info;
+        timeline_info.signalSemaphoreValueCount = 1;
+        timeline_info.pSignalSemaphoreValues = &_transfer_timeline_value;
+
+        vk::SubmitInfo submit_info;
+        submit_info.pNext = &timeline_info;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &*frame.transfer_cmdbuff;
+        submit_info.signalSemaphoreCount = 1;
+        submit_info.pSignalSemaphores = &*_transfer_timeline;
+        _vkctx.transfer_queue().submit(submit_info);
+
+        _transfer_wait_value = _transfer_timeline_value;
+
+        vk::DependencyInfo depinfo;
+        depinfo.imageMemoryBarrierCount = static_cast<uint32_t>(frame.acquire_barriers.size());
+        depinfo.pImageMemoryBarriers = frame.acquire_barriers.data();
+        cmdbuff().pipelineBarrier2(depinfo);
+        _frame_stats.barriers += static_cast<uint32_t>(frame.acquire_barriers.size());
+        frame.acquire_barriers.clear();
+
+        for (const auto& fn : frame.after_transfers)
+        {
+            fn(cmdbuff());
+        }
+        frame.after_transfers.clear();
+    }
+
+    upload_queue::staging_allocation upload_queue::allocate_staging(const size_t size, const uint32_t alignment)
+    {
+        auto& frame = current_frame();
+
+        const uint32_t ring_offset = align_up(_offset, alignment);
+        if (frame.overflow_blocks.empty() && ring_offset + size <= _region_size)
+        {
+            const uint32_t offset = (_frame_index * _region_size) + ring_offset;
+            _offset = ring_offset + static_cast<uint32_t>(size);
+            return { .buffer = _staging_buffer->buffer(),
+                     .data = static_cast<std::byte*>(_staging_buffer->map_memory()) + offset,
+                     .offset = offset };
+        }
+
+        // The region is full: rather than waiting for the GPU, stage into blocks that live until the frame completes
+        _stats.overflow_bytes += size;
+
+        uint32_t overflow_offset = align_up(_overflow_offset, alignment);
+        if (frame.overflow_blocks.empty() || overflow_offset + size > frame.overflow_blocks.back()->size())
+        {
+            gfx::staging_buffer_args sbuff_args;
+            sbuff_args.size = std::max<size_t>(size, _region_size);
+            sbuff_args.vkctx = &_vkctx;
+
+            frame.overflow_blocks.push_back(std::make_unique<gfx::staging_buffer>(sbuff_args));
+            frame.overflow_size += sbuff_args.size;
+            ++_stats.overflow_blocks;
+            overflow_offset = 0;
+        }
+
+        auto& block = *frame.overflow_blocks.back();
+        _overflow_offset = overflow_offset + static_cast<uint32_t>(size);
+        return { .buffer = block.buffer(),
+                 .data = static_cast<std::byte*>(block.map_memory()) + overflow_offset,
+                 .offset = overflow_offset };
+    }
+
+    size_t upload_queue::staging_space_left() const
+    {
+        const auto& frame = current_frame();
+        if (frame.overflow_blocks.empty())
+        {
+            return _region_size - std::min(align_up(_offset), _region_size);
+        }
+
+        const size_t block_size = frame.overflow_blocks.back()->size();
+        return block_size - std::min<size_t>(align_up(_overflow_offset), block_size);
     }
 
     void upload_queue::prepare_to_record()
@@ -193,7 +539,7 @@ namespace cathedral::engine
         switch (_state)
         {
         case upload_queue_state::READY_TO_RECORD:
-            _cmdbuff->begin(vk::CommandBufferBeginInfo{});
+            cmdbuff().begin(vk::CommandBufferBeginInfo{});
             _state = upload_queue_state::RECORDING;
             break;
         case upload_queue_state::RECORDING:
@@ -201,18 +547,31 @@ namespace cathedral::engine
         case upload_queue_state::PENDING_SUBMIT:
             CRITICAL_ERROR("Attempt to record into pending upload queue");
             break;
-        case upload_queue_state::SUBMITTED:
-            if (_fence_needs_wait)
+        case upload_queue_state::SUBMITTED: {
+            auto& frame = current_frame();
+            if (frame.fence_needs_wait)
             {
-                const vk::Result wait_result = _vkctx.device().waitForFences(*_fence, vk::True, UINT64_MAX);
+                if (_vkctx.device().getFenceStatus(*frame.fence) == vk::Result::eNotReady)
+                {
+                    ++_stats.stalls;
+                }
+                const vk::Result wait_result = _vkctx.device().waitForFences(*frame.fence, vk::True, UINT64_MAX);
                 CRITICAL_CHECK(wait_result == vk::Result::eSuccess, "Failure waiting for fence");
-                _vkctx.device().resetFences(*_fence);
-                _fence_needs_wait = false;
+                _vkctx.device().resetFences(*frame.fence);
+                frame.fence_needs_wait = false;
             }
-            _cmdbuff->reset();
-            _cmdbuff->begin(vk::CommandBufferBeginInfo{});
+
+            // The GPU is done with this frame's region and overflow blocks
+            frame.overflow_blocks.clear();
+            frame.overflow_size = 0;
+            _offset = 0;
+            _overflow_offset = 0;
+
+            frame.cmdbuff->reset();
+            frame.cmdbuff->begin(vk::CommandBufferBeginInfo{});
             _state = upload_queue_state::RECORDING;
             break;
         }
+        }
     }
 } // namespace cathedral::engine
\ No newline at end of file
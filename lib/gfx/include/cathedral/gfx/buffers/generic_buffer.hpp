@@ -11,6 +11,8 @@ namespace cathedral::gfx
         size_t size = 0;
         vk::BufferUsageFlags usage;
         vk::MemoryPropertyFlags memory_flags;
+        bool shared_with_transfer_queue = false; // Usable from the transfer queue without ownership transfers
+        memory_category category = memory_category::OTHER;
     };
 
     class generic_buffer
@@ -28,7 +30,7 @@ namespace cathedral::gfx
     protected:
         generic_buffer_args _args;
         VkBuffer _buffer = VK_NULL_HANDLE;
-        VmaAllocation* _allocation = nullptr;
-        VmaAllocationInfo* _allocation_info = nullptr;
+        VmaAllocation _allocation = nullptr;
+        uint64_t _allocation_size = 0; // As allocated by VMA, may be larger than the requested size
     };
 } // namespace cathedral::gfx
\ No newline at end of file
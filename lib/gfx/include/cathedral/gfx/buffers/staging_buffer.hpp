@@ -16,6 +16,9 @@ namespace cathedral::gfx
     {
     public:
         staging_buffer(staging_buffer_args);
+        staging_buffer(const staging_buffer&) = delete;
+        staging_buffer(staging_buffer&&) noexcept = default;
+        ~staging_buffer() override;
 
         void* map_memory();
         void unmap_memory();
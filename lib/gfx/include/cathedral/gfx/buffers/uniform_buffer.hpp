@@ -10,11 +10,20 @@ namespace cathedral::gfx
     {
         const vulkan_context* vkctx = nullptr;
         size_t size = 0;
+        bool host_mapped = false; // Host visible and persistently mapped, written directly instead of through transfers
     };
 
     class uniform_buffer : public generic_buffer
     {
     public:
         uniform_buffer(uniform_buffer_args);
+        uniform_buffer(const uniform_buffer&) = delete;
+        ~uniform_buffer() override;
+
+        // Only for host mapped buffers
+        std::byte* mapped_memory() const { return _mapped_memory; }
+
+    private:
+        std::byte* _mapped_memory = nullptr;
     };
 } // namespace cathedral::gfx
\ No newline at end of file
@@ -16,16 +16,19 @@ namespace cathedral::gfx
         uint32_t binding;
         descriptor_type type;
         uint32_t count;
+        bool partially_bound; // Unused elements may hold stale descriptors, and may be written while a frame is pending
 
         constexpr descriptor_set_entry(
             const uint32_t set,
             const uint32_t binding,
             const descriptor_type type,
-            const uint32_t count)
+            const uint32_t count,
+            const bool partially_bound = false)
             : set(set)
             , binding(binding)
             , type(type)
             , count(count)
+            , partially_bound(partially_bound)
         {
         }
     };
@@ -2,6 +2,8 @@
 
 #include <cathedral/core.hpp>
 
+#include <cathedral/gfx/memory_tracker.hpp>
+
 #include <ien/image/image.hpp>
 
 #include <vulkan/vulkan.hpp>
@@ -26,6 +28,7 @@ namespace cathedral::gfx
         vk::ImageUsageFlags usage_flags = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
         bool compressed = false;
         bool allow_host_memory_mapping = false;
+        memory_category category = memory_category::TEXTURE;
 
         constexpr bool validate() const
         {
@@ -64,6 +67,8 @@ namespace cathedral::gfx
 
         vk::Format format() const { return _format; }
 
+        bool compressed() const { return _compressed; }
+
         VmaAllocation allocation() const { return _allocation; }
 
         VmaAllocationInfo allocation_info() const { return _allocation_info; }
@@ -78,6 +83,8 @@ namespace cathedral::gfx
         VmaAllocation _allocation = {};
         VmaAllocationInfo _allocation_info = {};
         uint32_t _mip_levels = 0;
+        bool _compressed = false;
+        memory_category _category;
     };
 
     void transition_image_layout_suboptimal(
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cathedral/core.hpp>
+
+#include <cathedral/gfx/vma_forward.hpp>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace cathedral::gfx
+{
+    class memory_tracker;
+
+    enum class memory_category : uint8_t
+    {
+        OTHER,
+        MESH,
+        TEXTURE,
+        UNIFORM,
+        STAGING,
+        ATTACHMENT
+    };
+
+    constexpr size_t MEMORY_CATEGORY_COUNT = 6;
+
+    struct memory_category_stats
+    {
+        uint64_t bytes = 0;
+        uint32_t allocation_count = 0;
+    };
+
+    struct memory_heap_budget
+    {
+        uint32_t heap_index = 0;
+        bool device_local = false;
+        uint64_t size = 0;
+        uint64_t budget = 0; // From VK_EXT_memory_budget when present, an estimate from the heap size otherwise
+        uint64_t usage = 0; // Includes memory used by other processes when VK_EXT_memory_budget is present
+        uint64_t allocation_bytes = 0;
+        uint64_t block_bytes = 0;
+    };
+
+    struct memory_stats
+    {
+        std::vector<memory_heap_budget> heaps;
+        std::array<memory_category_stats, MEMORY_CATEGORY_COUNT> categories = {};
+        uint64_t allocation_bytes = 0;
+        uint64_t block_bytes = 0; // Device memory blocks allocated by VMA, allocations are suballocated from them
+        uint32_t allocation_count = 0;
+        uint32_t block_count = 0;
+        uint64_t largest_allocation = 0;
+        uint64_t largest_unused_range = 0;
+    };
+
+    struct memory_budget_event
+    {
+        uint32_t heap_index = 0;
+        bool device_local = false;
+        uint64_t budget = 0;
+        uint64_t usage = 0;
+        uint64_t threshold = 0; // 'budget_ratio' of the budget
+        bool over_budget = true; // False once usage has dropped back below the threshold, minus the hysteresis
+    };
+
+    using memory_budget_callback = std::function<void(const memory_budget_event&)>;
+
+    // Unsubscribes its callback from the tracker when destroyed
+    class memory_budget_subscription
+    {
+    public:
+        memory_budget_subscription() = default;
+        memory_budget_subscription(memory_tracker* tracker, uint32_t id);
+        ~memory_budget_subscription();
+
+        CATHEDRAL_NON_COPYABLE(memory_budget_subscription);
+        memory_budget_subscription(memory_budget_subscription&& other) noexcept;
+        memory_budget_subscription& operator=(memory_budget_subscription&& other) noexcept;
+
+    private:
+        memory_tracker* _tracker = nullptr;
+        uint32_t _id = 0;
+
+        void reset();
+    };
+
+    // Turns heap budgets into budget events. A heap goes over budget once its usage reaches 'budget_ratio' of its budget,
+    // and is reported on every update from then on, until usage drops below 'budget_ratio - hysteresis' of the budget
+    // and a last event reports it back under
+    class memory_budget_monitor
+    {
+    public:
+        memory_budget_monitor(float budget_ratio, float hysteresis);
+
+        std::vector<memory_budget_event> update(std::span<const memory_heap_budget> heaps);
+
+        bool over_budget(uint32_t heap_index) const;
+
+    private:
+        float _budget_ratio;
+        float _hysteresis;
+        std::vector<bool> _heap_over_budget;
+    };
+
+    // Device memory usage by category, tagged at buffer and image creation, plus the VMA heap budgets, checked against
+    // a memory_budget_monitor for the budget callbacks
+    class memory_tracker
+    {
+    public:
+        memory_tracker(VmaAllocator allocator, float budget_ratio, float hysteresis);
+
+        void track(memory_category category, uint64_t bytes);
+        void untrack(memory_category category, uint64_t bytes);
+
+        memory_category_stats category_stats(memory_category category) const;
+
+        // Cheap enough to query every frame
+        std::vector<memory_heap_budget> heap_budgets() const;
+
+        // Walks every VMA block, meant for tooling rather than every frame
+        memory_stats detailed_stats() const;
+
+        [[nodiscard]] memory_budget_subscription subscribe(memory_budget_callback callback);
+
+        // Compares the heap budgets against the ratio and notifies subscribers, called once a frame
+        void check_budgets();
+
+    private:
+        struct category_counters
+        {
+            std::atomic<uint64_t> bytes = 0;
+            std::atomic<uint32_t> allocation_count = 0;
+        };
+
+        VmaAllocator _allocator;
+        memory_budget_monitor _monitor;
+        std::array<category_counters, MEMORY_CATEGORY_COUNT> _categories;
+
+        std::mutex _callbacks_mutex;
+        std::vector<std::pair<uint32_t, memory_budget_callback>> _callbacks;
+        uint32_t _next_callback_id = 1;
+
+        void unsubscribe(uint32_t id);
+
+        friend class memory_budget_subscription;
+    };
+} // namespace cathedral::gfx
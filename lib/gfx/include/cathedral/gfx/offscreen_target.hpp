@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cathedral/core.hpp>
+
+#include <cathedral/gfx/image.hpp>
+#include <cathedral/gfx/render_target.hpp>
+
+#include <vulkan/vulkan.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace cathedral::gfx
+{
+    FORWARD_CLASS_INLINE(vulkan_context);
+
+    struct offscreen_target_args
+    {
+        vulkan_context* vkctx = nullptr;
+        vk::Format format = vk::Format::eB8G8R8A8Srgb; // Matches the usual default swapchain format
+    };
+
+    // Render target without a window, for headless contexts. Frames rotate through one image per frame in flight and
+    // are left in TransferSrcOptimal so they can be read back, e.g. with renderer::capture_screenshot
+    class offscreen_target : public render_target
+    {
+    public:
+        explicit offscreen_target(offscreen_target_args args);
+
+        void recreate() override;
+
+        vk::Semaphore image_ready_semaphore() const override { return {}; }
+
+        void set_frames_in_flight(uint32_t count) override;
+
+        uint32_t acquire_next_image(const std::function<void()>& swapchain_recreate_callback) override;
+
+        vk::Image image(uint32_t index) const override;
+        vk::ImageView imageview(uint32_t index) const override;
+
+        size_t image_count() const override { return _images.size(); }
+
+        vk::SwapchainKHR get() const override { return {}; }
+
+        vk::ImageLayout present_layout() const override { return vk::ImageLayout::eTransferSrcOptimal; }
+
+        void transition_undefined_color(uint32_t index, vk::CommandBuffer cmdbuff) const override;
+        void transition_color_present(uint32_t index, vk::CommandBuffer cmdbuff) const override;
+
+        vk::Format swapchain_image_format() const override { return _args.format; }
+
+        vulkan_context& vkctx() const override { return *_args.vkctx; }
+
+        VkExtent2D extent() const override { return _extent; }
+
+        // Image written by the last acquire
+        uint32_t current_image_index() const { return _image_index; }
+
+    private:
+        offscreen_target_args _args;
+        VkExtent2D _extent = {};
+        std::vector<std::unique_ptr<gfx::image>> _images;
+        std::vector<vk::UniqueImageView> _imageviews;
+        uint32_t _image_index = 0;
+
+        void init_images(uint32_t count);
+    };
+} // namespace cathedral::gfx
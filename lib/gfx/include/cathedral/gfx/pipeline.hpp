@@ -14,6 +14,7 @@ namespace cathedral::gfx
     {
         uint32_t set_index = 0;
         descriptor_set_definition definition;
+        vk::DescriptorSetLayout layout; // Shared layout matching 'definition', the pipeline creates its own when empty
     };
 
     struct pipeline_args
@@ -28,6 +29,8 @@ namespace cathedral::gfx
         float line_width = 1.0F;
         vertex_input_description vertex_input;
         std::vector<pipeline_descriptor_set> descriptor_sets;
+        uint32_t push_constant_size = 0; // Single range at offset 0, visible to the vertex and fragment stages
+        vk::PipelineLayout layout; // Shared layout matching the sets and push constants, created per pipeline when empty
         const shader* vertex_shader = nullptr;
         const shader* fragment_shader = nullptr;
         std::vector<vk::Format> color_attachment_formats;
@@ -39,7 +42,7 @@ namespace cathedral::gfx
     public:
         explicit pipeline(pipeline_args);
 
-        vk::PipelineLayout pipeline_layout() const { return *_layout; }
+        vk::PipelineLayout pipeline_layout() const { return _layout; }
 
         vk::Pipeline get() const { return *_pipeline; }
 
@@ -50,18 +53,20 @@ namespace cathedral::gfx
             CRITICAL_CHECK(
                 _descriptor_set_layouts.count(set_index),
                 "Attempt to get descriptor set layout with non-existing set index");
-            return *_descriptor_set_layouts.at(set_index);
+            return _descriptor_set_layouts.at(set_index);
         }
 
-        const std::unordered_map<uint32_t, vk::UniqueDescriptorSetLayout>& descriptor_set_layouts() const
+        const std::unordered_map<uint32_t, vk::DescriptorSetLayout>& descriptor_set_layouts() const
         {
             return _descriptor_set_layouts;
         }
 
     private:
         pipeline_args _args;
-        vk::UniquePipelineLayout _layout;
-        std::unordered_map<uint32_t, vk::UniqueDescriptorSetLayout> _descriptor_set_layouts;
+        vk::PipelineLayout _layout;
+        std::unordered_map<uint32_t, vk::DescriptorSetLayout> _descriptor_set_layouts;
+        std::vector<vk::UniqueDescriptorSetLayout> _owned_descriptor_set_layouts;
+        vk::UniquePipelineLayout _owned_layout;
         vk::UniquePipeline _pipeline;
     };
 } // namespace cathedral::gfx
\ No newline at end of file
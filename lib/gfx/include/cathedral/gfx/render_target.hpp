@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cathedral/core.hpp>
+
+#include <vulkan/vulkan.hpp>
+
+#include <functional>
+
+namespace cathedral::gfx
+{
+    FORWARD_CLASS_INLINE(vulkan_context);
+
+    // Color images the renderer draws frames into, a window swapchain or an offscreen_target
+    class render_target
+    {
+    public:
+        virtual ~render_target() = default;
+
+        // Resizes the images to the context's surface size
+        virtual void recreate() = 0;
+
+        // Semaphore signalled by the last acquired image, null when acquiring needs no GPU wait
+        virtual vk::Semaphore image_ready_semaphore() const = 0;
+
+        virtual void set_frames_in_flight(uint32_t count) = 0;
+
+        virtual uint32_t acquire_next_image(const std::function<void()>& swapchain_recreate_callback) = 0;
+
+        virtual vk::Image image(uint32_t index) const = 0;
+        virtual vk::ImageView imageview(uint32_t index) const = 0;
+
+        virtual size_t image_count() const = 0;
+
+        // Null for targets that are never presented
+        virtual vk::SwapchainKHR get() const = 0;
+
+        // Layout frames are left in once rendered, see transition_color_present
+        virtual vk::ImageLayout present_layout() const = 0;
+
+        virtual void transition_undefined_color(uint32_t index, vk::CommandBuffer cmdbuff) const = 0;
+        virtual void transition_color_present(uint32_t index, vk::CommandBuffer cmdbuff) const = 0;
+
+        virtual vk::Format swapchain_image_format() const = 0;
+
+        virtual vulkan_context& vkctx() const = 0;
+
+        virtual VkExtent2D extent() const = 0;
+    };
+} // namespace cathedral::gfx
@@ -15,6 +15,8 @@ namespace cathedral::gfx
         vk::Filter mag_filter = vk::Filter::eLinear;
         vk::Filter min_filter = vk::Filter::eLinear;
         uint32_t anisotropy_level = 0;
+
+        bool operator==(const sampler_info&) const = default;
     };
 
     class sampler
@@ -24,6 +26,8 @@ namespace cathedral::gfx
 
         vk::Sampler get_sampler() const { return *_sampler; }
 
+        const sampler_info& info() const { return _info; }
+
     private:
         vk::UniqueSampler _sampler;
         const vulkan_context* _vkctx;
@@ -2,6 +2,8 @@
 
 #include <cathedral/core.hpp>
 
+#include <cathedral/gfx/render_target.hpp>
+
 #include <vulkan/vulkan.hpp>
 
 #include <VkBootstrap.h>
@@ -12,34 +14,40 @@ namespace cathedral::gfx
 {
     FORWARD_CLASS_INLINE(vulkan_context);
 
-    class swapchain
+    class swapchain : public render_target
     {
     public:
         explicit swapchain(vulkan_context& vkctx, vk::PresentModeKHR initial_present_mode);
 
-        void recreate();
+        void recreate() override;
+
+        // Semaphore signalled by the last acquired image
+        vk::Semaphore image_ready_semaphore() const override { return *_image_ready_semaphores[_semaphore_index]; }
+
+        // Acquires rotate through one semaphore per frame in flight, so a pending wait is never reused
+        void set_frames_in_flight(uint32_t count) override;
 
-        vk::Semaphore image_ready_semaphore() const { return *_image_ready_semaphore; }
+        uint32_t acquire_next_image(const std::function<void()>& swapchain_recreate_callback) override;
 
-        uint32_t acquire_next_image(const std::function<void()>& swapchain_recreate_callback);
+        vk::Image image(uint32_t index) const override;
+        vk::ImageView imageview(uint32_t index) const override;
 
-        vk::Image image(uint32_t index) const;
-        vk::ImageView imageview(uint32_t index) const;
+        size_t image_count() const override { return _swapchain_images.size(); }
 
-        size_t image_count() const { return _swapchain_images.size(); }
+        vk::SwapchainKHR get() const override { return _swapchain.swapchain; }
 
-        vk::SwapchainKHR get() const { return _swapchain.swapchain; }
+        vk::ImageLayout present_layout() const override { return vk::ImageLayout::ePresentSrcKHR; }
 
-        void transition_undefined_color(uint32_t index, vk::CommandBuffer cmdbuff) const;
-        void transition_color_present(uint32_t index, vk::CommandBuffer cmdbuff) const;
+        void transition_undefined_color(uint32_t index, vk::CommandBuffer cmdbuff) const override;
+        void transition_color_present(uint32_t index, vk::CommandBuffer cmdbuff) const override;
 
-        vk::Format swapchain_image_format() const { return static_cast<vk::Format>(_swapchain.image_format); }
+        vk::Format swapchain_image_format() const override { return static_cast<vk::Format>(_swapchain.image_format); }
 
-        vulkan_context& vkctx() const { return _vkctx; }
+        vulkan_context& vkctx() const override { return _vkctx; }
 
         void set_present_mode(const vk::PresentModeKHR mode) { _present_mode = mode; }
 
-        VkExtent2D extent() const { return _swapchain.extent; }
+        VkExtent2D extent() const override { return _swapchain.extent; }
 
     private:
         vulkan_context& _vkctx;
@@ -47,7 +55,8 @@ namespace cathedral::gfx
         vkb::Swapchain _swapchain;
         std::vector<vk::Image> _swapchain_images;
         std::vector<vk::ImageView> _swapchain_imageviews;
-        vk::UniqueSemaphore _image_ready_semaphore;
+        std::vector<vk::UniqueSemaphore> _image_ready_semaphores;
+        uint32_t _semaphore_index = 0;
 
         void init_swapchain();
         void init_swapchain_images();
@@ -12,7 +12,8 @@ namespace cathedral::gfx
         UNDEFINED,
         UNIFORM,
         STORAGE,
-        SAMPLER
+        SAMPLER,
+        UNIFORM_DYNAMIC
     };
 
     enum class shader_type : uint8_t
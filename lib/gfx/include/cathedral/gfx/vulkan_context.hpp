@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cathedral/gfx/memory_tracker.hpp>
 #include <cathedral/gfx/vma_forward.hpp>
 
 #include <glm/vec2.hpp>
@@ -8,6 +9,8 @@
 #include <vulkan/vulkan.hpp>
 
 #include <functional>
+#include <memory>
+#include <string>
 
 namespace cathedral::gfx
 {
@@ -19,13 +22,20 @@ namespace cathedral::gfx
     struct vulkan_context_args
     {
         std::function<vk::SurfaceKHR(vk::Instance)> surface_retriever = nullptr;
-        std::function<glm::ivec2()> surface_size_retriever = nullptr;
+        std::function<glm::ivec2()> surface_size_retriever = nullptr; // Offscreen target size when headless
+        bool headless = false; // No surface or presentation support, for rendering to an offscreen_target
         bool validation_layers = false;
+        bool use_transfer_queue = true; // Use a transfer-only queue family for uploads when the device has one
+        bool descriptor_indexing = false; // Requires the descriptor indexing features bindless texture tables rely on
+        float memory_budget_ratio = 0.9F; // Fraction of a heap's budget past which budget callbacks fire
+        float memory_budget_hysteresis = 0.05F; // How far below the ratio usage has to drop for the callbacks to stop
+        std::string pipeline_cache_dir; // Holds one pipeline cache file per device, the cache is not persisted if empty
         std::vector<const char*> instance_extensions;
 
         struct
         {
             uint32_t uniform_buffer_count = 10000;
+            uint32_t uniform_buffer_dynamic_count = 10000;
             uint32_t storage_buffer_count = 10000;
             uint32_t combined_image_sampler_count = 10000;
             uint32_t max_sets = 10000;
@@ -41,21 +51,45 @@ namespace cathedral::gfx
         vk::Instance instance() const;
         vk::PhysicalDevice physdev() const;
         vk::SurfaceKHR surface() const;
+        bool headless() const { return _headless; }
         vk::Device device() const;
         vk::Queue graphics_queue() const;
         uint32_t graphics_queue_family_index() const;
+
+        // Without a dedicated transfer queue family these return the graphics queue and family
+        bool has_transfer_queue() const { return _has_transfer_queue; }
+        vk::Queue transfer_queue() const;
+        uint32_t transfer_queue_family_index() const;
+
         const VmaAllocator& allocator() const;
+        memory_tracker& memory() const { return *_memory; }
         vk::CommandPool command_pool() const;
+        vk::CommandPool transfer_command_pool() const;
         vk::DescriptorPool descriptor_pool() const;
         vk::PipelineCache pipeline_cache() const;
 
+        // Writes the pipeline cache to disk if pipelines were added to it since the last save, also done on destruction
+        bool save_pipeline_cache();
+
+        // Saves the current pipeline cache and switches to the one in 'cache_dir', empty to stop persisting it. No
+        // pipeline may be created while this runs
+        void set_pipeline_cache_dir(const std::string& cache_dir);
+
+        uint32_t min_uniform_buffer_offset_alignment() const;
+
+        bool descriptor_indexing_enabled() const { return _descriptor_indexing; }
+
+        uint32_t max_sampled_image_descriptors() const;
+
         vk::Viewport get_default_viewport() const;
         vk::Rect2D get_default_scissor() const;
 
         vk::UniqueCommandBuffer create_primary_commandbuffer() const;
+        vk::UniqueCommandBuffer create_transfer_commandbuffer() const;
         void submit_commandbuffer_sync(vk::CommandBuffer cmdbuff) const;
 
         vk::UniqueSemaphore create_default_semaphore() const;
+        vk::UniqueSemaphore create_timeline_semaphore(uint64_t initial_value = 0) const;
         vk::UniqueFence create_signaled_fence() const;
 
         glm::ivec2 get_surface_size() const;
@@ -66,14 +100,24 @@ namespace cathedral::gfx
         vk::SurfaceKHR _surface;
         vkb::Device _device;
         vk::Queue _graphics_queue;
+        vk::Queue _transfer_queue;
+        bool _has_transfer_queue = false;
+        bool _descriptor_indexing = false;
+        bool _headless = false;
 
         std::function<glm::ivec2()> _surface_size_retriever;
 
         VmaAllocator _allocator = {};
+        std::unique_ptr<memory_tracker> _memory;
 
         vk::UniqueCommandPool _cmdpool;
+        vk::UniqueCommandPool _transfer_cmdpool;
         vk::UniqueDescriptorPool _descriptor_pool;
 
         vk::UniquePipelineCache _pipeline_cache;
+        std::string _pipeline_cache_path;
+        size_t _saved_pipeline_cache_size = 0;
+
+        void init_pipeline_cache(const std::string& cache_dir);
     };
 } // namespace cathedral::gfx
@@ -4,16 +4,21 @@
 
 #include <vk_mem_alloc.h>
 
+#include <array>
+
 namespace cathedral::gfx
 {
     generic_buffer::generic_buffer(const generic_buffer_args& args)
         : _args(args)
     {
-        const uint32_t queue_index = _args.vkctx->graphics_queue_family_index();
+        const std::array<uint32_t, 2> queue_indices = { _args.vkctx->graphics_queue_family_index(),
+                                                        _args.vkctx->transfer_queue_family_index() };
+        const bool concurrent = _args.shared_with_transfer_queue && _args.vkctx->has_transfer_queue();
+
         auto buffer_info = zero_struct<VkBufferCreateInfo>();
-        buffer_info.pQueueFamilyIndices = &queue_index;
-        buffer_info.queueFamilyIndexCount = 1;
-        buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        buffer_info.pQueueFamilyIndices = queue_indices.data();
+        buffer_info.queueFamilyIndexCount = concurrent ? 2 : 1;
+        buffer_info.sharingMode = concurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
         buffer_info.size = _args.size;
         buffer_info.usage = static_cast<VkBufferUsageFlags>(_args.usage);
         buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -22,24 +27,25 @@ namespace cathedral::gfx
         alloc_info.pool = VK_NULL_HANDLE;
         alloc_info.requiredFlags = static_cast<VkMemoryPropertyFlags>(_args.memory_flags);
 
-        _allocation = new VmaAllocation;
-        _allocation_info = new VmaAllocationInfo;
-
+        VmaAllocationInfo allocation_info = {};
         const auto buffer_create_result =
-            vmaCreateBuffer(_args.vkctx->allocator(), &buffer_info, &alloc_info, &_buffer, _allocation, _allocation_info);
+            vmaCreateBuffer(_args.vkctx->allocator(), &buffer_info, &alloc_info, &_buffer, &_allocation, &allocation_info);
 
         CRITICAL_CHECK(buffer_create_result == VK_SUCCESS, "Failure creating buffer");
+
+        _allocation_size = allocation_info.size;
+        _args.vkctx->memory().track(_args.category, _allocation_size);
     }
 
     generic_buffer::generic_buffer(generic_buffer&& mv_src) noexcept
         : _args(std::move(mv_src._args))
         , _buffer(mv_src._buffer)
         , _allocation(mv_src._allocation)
-        , _allocation_info(mv_src._allocation_info) 
+        , _allocation_size(mv_src._allocation_size)
     {
         mv_src._buffer = VK_NULL_HANDLE;
         mv_src._allocation = nullptr;
-        mv_src._allocation_info = nullptr;
+        mv_src._allocation_size = 0;
         mv_src._args = {};
     }
 
@@ -47,11 +53,9 @@ namespace cathedral::gfx
     {
         if (_allocation != nullptr)
         {
-            vmaDestroyBuffer(_args.vkctx->allocator(), _buffer, *_allocation);
-            delete _allocation;
-            delete _allocation_info;
+            vmaDestroyBuffer(_args.vkctx->allocator(), _buffer, _allocation);
+            _args.vkctx->memory().untrack(_args.category, _allocation_size);
             _allocation = nullptr;
-            _allocation_info = nullptr;
             _buffer = VK_NULL_HANDLE;
         }
     }
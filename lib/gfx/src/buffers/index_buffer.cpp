@@ -13,6 +13,7 @@ namespace cathedral::gfx
             result.memory_flags = vk::MemoryPropertyFlagBits::eDeviceLocal;
             result.usage = vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst;
             result.vkctx = vkctx;
+            result.category = memory_category::MESH;
             return result;
         }
     } // namespace
@@ -15,6 +15,8 @@ namespace cathedral::gfx
             result.memory_flags = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
             result.usage = vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst;
             result.vkctx = vkctx;
+            result.category = memory_category::STAGING;
+            result.shared_with_transfer_queue = true;
             return result;
         }
     } // namespace
@@ -24,20 +26,27 @@ namespace cathedral::gfx
     {
     }
 
+    staging_buffer::~staging_buffer()
+    {
+        unmap_memory();
+    }
+
     void* staging_buffer::map_memory()
     {
+        // Mapped through VMA, several staging buffers may live in the same device memory block
         if (_mapped_memory == nullptr)
         {
-            _mapped_memory = _args.vkctx->device().mapMemory(_allocation_info->deviceMemory, 0, _allocation_info->size);
+            const auto map_result = vmaMapMemory(_args.vkctx->allocator(), _allocation, &_mapped_memory);
+            CRITICAL_CHECK(map_result == VK_SUCCESS, "Failure mapping staging buffer memory");
         }
         return _mapped_memory;
     }
 
     void staging_buffer::unmap_memory()
     {
-        if (_mapped_memory != nullptr)
+        if (_mapped_memory != nullptr && _allocation != nullptr)
         {
-            _args.vkctx->device().unmapMemory(_allocation_info->deviceMemory);
+            vmaUnmapMemory(_args.vkctx->allocator(), _allocation);
             _mapped_memory = nullptr;
         }
     }
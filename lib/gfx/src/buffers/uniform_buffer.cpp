@@ -2,23 +2,49 @@
 
 #include <cathedral/core.hpp>
 
+#include <vk_mem_alloc.h>
+
 namespace cathedral::gfx
 {
     namespace
     {
-        generic_buffer_args get_uniform_buffer_args(const size_t sz, const vulkan_context* vkctx)
+        generic_buffer_args get_uniform_buffer_args(const uniform_buffer_args& args)
         {
             generic_buffer_args result;
-            result.size = sz;
-            result.memory_flags = vk::MemoryPropertyFlagBits::eDeviceLocal;
-            result.usage = vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eTransferDst;
-            result.vkctx = vkctx;
+            result.size = args.size;
+            if (args.host_mapped)
+            {
+                result.memory_flags = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
+                result.usage = vk::BufferUsageFlagBits::eUniformBuffer;
+            }
+            else
+            {
+                result.memory_flags = vk::MemoryPropertyFlagBits::eDeviceLocal;
+                result.usage = vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eTransferDst;
+            }
+            result.vkctx = args.vkctx;
+            result.category = memory_category::UNIFORM;
             return result;
         }
     } // namespace
 
     uniform_buffer::uniform_buffer(const uniform_buffer_args args)
-        : generic_buffer(get_uniform_buffer_args(args.size, args.vkctx))
+        : generic_buffer(get_uniform_buffer_args(args))
+    {
+        if (args.host_mapped)
+        {
+            void* mapped = nullptr;
+            const auto map_result = vmaMapMemory(_args.vkctx->allocator(), _allocation, &mapped);
+            CRITICAL_CHECK(map_result == VK_SUCCESS, "Failure mapping uniform buffer memory");
+            _mapped_memory = static_cast<std::byte*>(mapped);
+        }
+    }
+
+    uniform_buffer::~uniform_buffer()
     {
+        if (_mapped_memory != nullptr && _allocation != nullptr)
+        {
+            vmaUnmapMemory(_args.vkctx->allocator(), _allocation);
+        }
     }
 } // namespace cathedral::gfx
\ No newline at end of file
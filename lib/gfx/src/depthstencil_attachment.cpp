@@ -31,6 +31,7 @@ namespace cathedral::gfx
         if (_image != VK_NULL_HANDLE)
         {
             vmaDestroyImage(_args.vkctx->allocator(), _image, *_image_allocation);
+            _args.vkctx->memory().untrack(memory_category::ATTACHMENT, _image_allocation_info->size);
             delete _image_allocation;
             delete _image_allocation_info;
             _image = VK_NULL_HANDLE;
@@ -70,6 +71,7 @@ namespace cathedral::gfx
         auto image_create_result =
             vmaCreateImage(_args.vkctx->allocator(), &info, &alloc_info, &_image, _image_allocation, _image_allocation_info);
         CRITICAL_CHECK(image_create_result == VK_SUCCESS, "Failure creating vulkan image");
+        _args.vkctx->memory().track(memory_category::ATTACHMENT, _image_allocation_info->size);
 
         vk::ImageViewCreateInfo depth_imageview_info;
         depth_imageview_info.components = vk::ComponentMapping();
@@ -2,6 +2,7 @@
 
 #include <cathedral/gfx/vulkan_context.hpp>
 
+#include <algorithm>
 #include <unordered_set>
 
 namespace cathedral::gfx
@@ -23,6 +24,7 @@ namespace cathedral::gfx
     vk::UniqueDescriptorSetLayout descriptor_set_definition::create_descriptor_set_layout(const vulkan_context& vkctx) const
     {
         std::vector<vk::DescriptorSetLayoutBinding> bindings;
+        std::vector<vk::DescriptorBindingFlags> binding_flags;
         for (const auto& entry : this->entries)
         {
             vk::DescriptorSetLayoutBinding binding;
@@ -31,11 +33,27 @@ namespace cathedral::gfx
             binding.descriptorType = gfx::to_vk_descriptor_type(entry.type);
             binding.stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
             bindings.push_back(binding);
+
+            vk::DescriptorBindingFlags flags;
+            if (entry.partially_bound)
+            {
+                flags = vk::DescriptorBindingFlagBits::ePartiallyBound |
+                        vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending;
+            }
+            binding_flags.push_back(flags);
         }
 
+        vk::DescriptorSetLayoutBindingFlagsCreateInfo binding_flags_info;
+        binding_flags_info.bindingCount = static_cast<uint32_t>(binding_flags.size());
+        binding_flags_info.pBindingFlags = binding_flags.data();
+
         vk::DescriptorSetLayoutCreateInfo dset_layout_info;
         dset_layout_info.bindingCount = static_cast<uint32_t>(bindings.size());
         dset_layout_info.pBindings = bindings.data();
+        if (std::ranges::any_of(entries, [](const descriptor_set_entry& entry) { return entry.partially_bound; }))
+        {
+            dset_layout_info.pNext = &binding_flags_info;
+        }
 
         return vkctx.device().createDescriptorSetLayoutUnique(dset_layout_info);
     }
@@ -50,6 +68,8 @@ namespace cathedral::gfx
             return vk::DescriptorType::eStorageBuffer;
         case cathedral::gfx::descriptor_type::UNIFORM:
             return vk::DescriptorType::eUniformBuffer;
+        case cathedral::gfx::descriptor_type::UNIFORM_DYNAMIC:
+            return vk::DescriptorType::eUniformBufferDynamic;
         default:
             CRITICAL_ERROR("Unhandled descriptor type");
         }
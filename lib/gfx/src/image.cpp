@@ -13,6 +13,8 @@ namespace cathedral::gfx
         , _aspect_flags(args.aspect_flags)
         , _format(args.format)
         , _mip_levels(args.mipmap_levels)
+        , _compressed(args.compressed)
+        , _category(args.category)
     {
         CRITICAL_CHECK(args.validate(), "Invalid vulkan image args");
 
@@ -52,11 +54,14 @@ namespace cathedral::gfx
         const auto result =
             vmaCreateImage(_vkctx->allocator(), &vk_image_info, &alloc_info, &_image, &_allocation, &_allocation_info);
         CRITICAL_CHECK(result == VK_SUCCESS, "Failure creating vulkan (VMA) image");
+
+        _vkctx->memory().track(_category, _allocation_info.size);
     }
 
     image::~image()
     {
         vmaDestroyImage(_vkctx->allocator(), _image, _allocation);
+        _vkctx->memory().untrack(_category, _allocation_info.size);
     }
 
     void image::transition_layout_suboptimal(
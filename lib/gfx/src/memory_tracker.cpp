@@ -0,0 +1,200 @@
+#include <cathedral/gfx/memory_tracker.hpp>
+
+#include <vk_mem_alloc.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace cathedral::gfx
+{
+    memory_budget_subscription::memory_budget_subscription(memory_tracker* tracker, const uint32_t id)
+        : _tracker(tracker)
+        , _id(id)
+    {
+    }
+
+    memory_budget_subscription::~memory_budget_subscription()
+    {
+        reset();
+    }
+
+    memory_budget_subscription::memory_budget_subscription(memory_budget_subscription&& other) noexcept
+        : _tracker(std::exchange(other._tracker, nullptr))
+        , _id(other._id)
+    {
+    }
+
+    memory_budget_subscription& memory_budget_subscription::operator=(memory_budget_subscription&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            _tracker = std::exchange(other._tracker, nullptr);
+            _id = other._id;
+        }
+        return *this;
+    }
+
+    void memory_budget_subscription::reset()
+    {
+        if (_tracker != nullptr)
+        {
+            _tracker->unsubscribe(_id);
+        }
+        _tracker = nullptr;
+    }
+
+    memory_budget_monitor::memory_budget_monitor(const float budget_ratio, const float hysteresis)
+        : _budget_ratio(budget_ratio)
+        , _hysteresis(hysteresis)
+    {
+        CRITICAL_CHECK(_budget_ratio > 0.0F, "Invalid memory budget ratio");
+        CRITICAL_CHECK(_hysteresis >= 0.0F && _hysteresis < _budget_ratio, "Invalid memory budget hysteresis");
+    }
+
+    std::vector<memory_budget_event> memory_budget_monitor::update(const std::span<const memory_heap_budget> heaps)
+    {
+        std::vector<memory_budget_event> events;
+        for (const auto& heap : heaps)
+        {
+            if (heap.heap_index >= _heap_over_budget.size())
+            {
+                _heap_over_budget.resize(heap.heap_index + 1, false);
+            }
+
+            const auto budget = static_cast<double>(heap.budget);
+            const auto threshold = static_cast<uint64_t>(budget * _budget_ratio);
+            const auto release_threshold = static_cast<uint64_t>(budget * (_budget_ratio - _hysteresis));
+
+            const bool was_over_budget = _heap_over_budget[heap.heap_index];
+            const bool over_budget = heap.budget > 0 && heap.usage >= (was_over_budget ? release_threshold : threshold);
+            if (over_budget || was_over_budget)
+            {
+                events.push_back({ .heap_index = heap.heap_index,
+                                   .device_local = heap.device_local,
+                                   .budget = heap.budget,
+                                   .usage = heap.usage,
+                                   .threshold = threshold,
+                                   .over_budget = over_budget });
+            }
+            _heap_over_budget[heap.heap_index] = over_budget;
+        }
+        return events;
+    }
+
+    bool memory_budget_monitor::over_budget(const uint32_t heap_index) const
+    {
+        return heap_index < _heap_over_budget.size() && _heap_over_budget[heap_index];
+    }
+
+    memory_tracker::memory_tracker(VmaAllocator allocator, const float budget_ratio, const float hysteresis)
+        : _allocator(allocator)
+        , _monitor(budget_ratio, hysteresis)
+    {
+        CRITICAL_CHECK_NOTNULL(_allocator);
+    }
+
+    void memory_tracker::track(const memory_category category, const uint64_t bytes)
+    {
+        auto& counters = _categories[std::to_underlying(category)];
+        counters.bytes += bytes;
+        ++counters.allocation_count;
+    }
+
+    void memory_tracker::untrack(const memory_category category, const uint64_t bytes)
+    {
+        auto& counters = _categories[std::to_underlying(category)];
+        counters.bytes -= bytes;
+        --counters.allocation_count;
+    }
+
+    memory_category_stats memory_tracker::category_stats(const memory_category category) const
+    {
+        const auto& counters = _categories[std::to_underlying(category)];
+        return { .bytes = counters.bytes.load(), .allocation_count = counters.allocation_count.load() };
+    }
+
+    std::vector<memory_heap_budget> memory_tracker::heap_budgets() const
+    {
+        const VkPhysicalDeviceMemoryProperties* memory_properties = nullptr;
+        vmaGetMemoryProperties(_allocator, &memory_properties);
+
+        std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets = {};
+        vmaGetHeapBudgets(_allocator, budgets.data());
+
+        std::vector<memory_heap_budget> result;
+        result.reserve(memory_properties->memoryHeapCount);
+        for (uint32_t i = 0; i < memory_properties->memoryHeapCount; ++i)
+        {
+            const auto& heap = memory_properties->memoryHeaps[i];
+            result.push_back({ .heap_index = i,
+                               .device_local = (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0,
+                               .size = heap.size,
+                               .budget = budgets[i].budget,
+                               .usage = budgets[i].usage,
+                               .allocation_bytes = budgets[i].statistics.allocationBytes,
+                               .block_bytes = budgets[i].statistics.blockBytes });
+        }
+        return result;
+    }
+
+    memory_stats memory_tracker::detailed_stats() const
+    {
+        VmaTotalStatistics vma_stats = {};
+        vmaCalculateStatistics(_allocator, &vma_stats);
+
+        memory_stats result;
+        result.heaps = heap_budgets();
+        for (size_t i = 0; i < MEMORY_CATEGORY_COUNT; ++i)
+        {
+            result.categories[i] = category_stats(static_cast<memory_category>(i));
+        }
+        result.allocation_bytes = vma_stats.total.statistics.allocationBytes;
+        result.block_bytes = vma_stats.total.statistics.blockBytes;
+        result.allocation_count = vma_stats.total.statistics.allocationCount;
+        result.block_count = vma_stats.total.statistics.blockCount;
+        if (result.allocation_count > 0)
+        {
+            result.largest_allocation = vma_stats.total.allocationSizeMax;
+        }
+        if (vma_stats.total.unusedRangeCount > 0)
+        {
+            result.largest_unused_range = vma_stats.total.unusedRangeSizeMax;
+        }
+        return result;
+    }
+
+    memory_budget_subscription memory_tracker::subscribe(memory_budget_callback callback)
+    {
+        CRITICAL_CHECK(callback != nullptr, "Invalid memory budget callback");
+
+        const std::scoped_lock lock(_callbacks_mutex);
+        const uint32_t id = _next_callback_id++;
+        _callbacks.emplace_back(id, std::move(callback));
+        return { this, id };
+    }
+
+    void memory_tracker::check_budgets()
+    {
+        const auto events = _monitor.update(heap_budgets());
+        if (events.empty())
+        {
+            return;
+        }
+
+        const std::scoped_lock lock(_callbacks_mutex);
+        for (const auto& event : events)
+        {
+            for (const auto& [id, callback] : _callbacks)
+            {
+                callback(event);
+            }
+        }
+    }
+
+    void memory_tracker::unsubscribe(const uint32_t id)
+    {
+        const std::scoped_lock lock(_callbacks_mutex);
+        std::erase_if(_callbacks, [id](const auto& entry) { return entry.first == id; });
+    }
+} // namespace cathedral::gfx
@@ -0,0 +1,138 @@
+#include <cathedral/gfx/offscreen_target.hpp>
+
+#include <cathedral/gfx/vulkan_context.hpp>
+
+namespace cathedral::gfx
+{
+    namespace
+    {
+        void color_barrier(
+            const vulkan_context& vkctx,
+            const vk::Image image,
+            const vk::ImageLayout old_layout,
+            const vk::ImageLayout new_layout,
+            const vk::CommandBuffer cmdbuff)
+        {
+            vk::ImageMemoryBarrier barrier;
+            barrier.image = image;
+            barrier.oldLayout = old_layout;
+            barrier.newLayout = new_layout;
+            barrier.srcAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite;
+            barrier.srcQueueFamilyIndex = vkctx.graphics_queue_family_index();
+            barrier.dstAccessMask = vk::AccessFlagBits::eMemoryRead | vk::AccessFlagBits::eMemoryWrite;
+            barrier.dstQueueFamilyIndex = vkctx.graphics_queue_family_index();
+            barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+            barrier.subresourceRange.baseArrayLayer = 0;
+            barrier.subresourceRange.baseMipLevel = 0;
+            barrier.subresourceRange.layerCount = 1;
+            barrier.subresourceRange.levelCount = 1;
+
+            cmdbuff.pipelineBarrier(
+                vk::PipelineStageFlagBits::eAllCommands,
+                vk::PipelineStageFlagBits::eAllCommands,
+                static_cast<vk::DependencyFlags>(0),
+                {},
+                {},
+                { barrier });
+        }
+    } // namespace
+
+    offscreen_target::offscreen_target(offscreen_target_args args)
+        : _args(args)
+    {
+        CRITICAL_CHECK_NOTNULL(_args.vkctx);
+        init_images(1);
+    }
+
+    void offscreen_target::init_images(const uint32_t count)
+    {
+        const auto size = _args.vkctx->get_surface_size();
+        CRITICAL_CHECK(size.x > 0 && size.y > 0, "Invalid offscreen target size");
+
+        _args.vkctx->device().waitIdle();
+        _imageviews.clear();
+        _images.clear();
+
+        _extent = VkExtent2D{ .width = static_cast<uint32_t>(size.x), .height = static_cast<uint32_t>(size.y) };
+
+        image_args img_args;
+        img_args.vkctx = _args.vkctx;
+        img_args.width = _extent.width;
+        img_args.height = _extent.height;
+        img_args.mipmap_levels = 1;
+        img_args.format = _args.format;
+        // Transfer source to read frames back, like the swapchain images used for screenshots
+        img_args.usage_flags = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc;
+        img_args.category = memory_category::ATTACHMENT;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            auto& img = _images.emplace_back(std::make_unique<gfx::image>(img_args));
+
+            vk::ImageViewCreateInfo view_info;
+            view_info.components = vk::ComponentMapping();
+            view_info.format = _args.format;
+            view_info.image = img->get_image();
+            view_info.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+            view_info.subresourceRange.baseArrayLayer = 0;
+            view_info.subresourceRange.baseMipLevel = 0;
+            view_info.subresourceRange.layerCount = 1;
+            view_info.subresourceRange.levelCount = 1;
+            view_info.viewType = vk::ImageViewType::e2D;
+            _imageviews.push_back(_args.vkctx->device().createImageViewUnique(view_info));
+        }
+        _image_index = 0;
+    }
+
+    void offscreen_target::recreate()
+    {
+        init_images(static_cast<uint32_t>(_images.size()));
+    }
+
+    void offscreen_target::set_frames_in_flight(const uint32_t count)
+    {
+        CRITICAL_CHECK(count > 0, "Invalid frames in flight count");
+
+        // The renderer waits for frame (n - count) before recording frame n, which makes image (n % count) reusable
+        init_images(count);
+    }
+
+    uint32_t offscreen_target::acquire_next_image(
+        [[maybe_unused]] const std::function<void()>& swapchain_recreate_callback)
+    {
+        _image_index = (_image_index + 1) % static_cast<uint32_t>(_images.size());
+        return _image_index;
+    }
+
+    vk::Image offscreen_target::image(const uint32_t index) const
+    {
+        CRITICAL_CHECK(index < _images.size(), "Invalid offscreen target image index");
+        return _images[index]->get_image();
+    }
+
+    vk::ImageView offscreen_target::imageview(const uint32_t index) const
+    {
+        CRITICAL_CHECK(index < _imageviews.size(), "Invalid offscreen target imageview index");
+        return *_imageviews[index];
+    }
+
+    void offscreen_target::transition_undefined_color(const uint32_t index, const vk::CommandBuffer cmdbuff) const
+    {
+        color_barrier(
+            *_args.vkctx,
+            image(index),
+            vk::ImageLayout::eUndefined,
+            vk::ImageLayout::eColorAttachmentOptimal,
+            cmdbuff);
+    }
+
+    void offscreen_target::transition_color_present(const uint32_t index, const vk::CommandBuffer cmdbuff) const
+    {
+        color_barrier(
+            *_args.vkctx,
+            image(index),
+            vk::ImageLayout::eColorAttachmentOptimal,
+            vk::ImageLayout::eTransferSrcOptimal,
+            cmdbuff);
+    }
+} // namespace cathedral::gfx
@@ -107,25 +107,13 @@ namespace cathedral::gfx
         // Tessellation
         pipeline_info.pTessellationState = nullptr;
 
-        // Viewport
-        const auto wsz = vkctx.get_surface_size();
-        vk::Viewport viewport;
-        viewport.x = 0;
-        viewport.y = 0;
-        viewport.width = static_cast<float>(wsz.x);
-        viewport.height = static_cast<float>(wsz.y);
-        viewport.minDepth = 0.0F;
-        viewport.maxDepth = 1.0F;
-
-        vk::Rect2D scissor;
-        scissor.offset = vk::Offset2D{ .x = 0, .y = 0 };
-        scissor.extent = vk::Extent2D{ .width = static_cast<uint32_t>(wsz.x), .height = static_cast<uint32_t>(wsz.y) };
-
+        // Viewport, both it and the scissor are dynamic state. Not querying the surface size also keeps pipeline
+        // creation free of windowing calls, so pipelines can be created on worker threads
         vk::PipelineViewportStateCreateInfo viewport_state;
         viewport_state.viewportCount = 1;
-        viewport_state.pViewports = &viewport;
+        viewport_state.pViewports = nullptr;
         viewport_state.scissorCount = 1;
-        viewport_state.pScissors = &scissor;
+        viewport_state.pScissors = nullptr;
         pipeline_info.pViewportState = &viewport_state;
 
         // Renderpass
@@ -190,7 +178,7 @@ namespace cathedral::gfx
         std::vector<vk::DescriptorSetLayout> layouts;
 
         std::unordered_set<uint32_t> used_set_indices;
-        for (const auto& [set_index, definition] : _args.descriptor_sets) // Create pipeline descriptor set layouts
+        for (const auto& [set_index, definition, shared_layout] : _args.descriptor_sets)
         {
             if (!definition.validate())
             {
@@ -203,34 +191,34 @@ namespace cathedral::gfx
 
             used_set_indices.emplace(set_index);
 
-            std::vector<vk::DescriptorSetLayoutBinding> bindings;
-            for (const auto& entry : definition.entries)
+            vk::DescriptorSetLayout set_layout = shared_layout;
+            if (!set_layout)
             {
-                vk::DescriptorSetLayoutBinding b;
-                b.binding = entry.binding;
-                b.descriptorCount = entry.count;
-                b.descriptorType = to_vk_descriptor_type(entry.type);
-                b.stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
-
-                bindings.push_back(b);
+                _owned_descriptor_set_layouts.push_back(definition.create_descriptor_set_layout(vkctx));
+                set_layout = *_owned_descriptor_set_layouts.back();
             }
-
-            vk::DescriptorSetLayoutCreateInfo info;
-            info.bindingCount = static_cast<uint32_t>(bindings.size());
-            info.pBindings = bindings.data();
-
-            auto [it, added] =
-                _descriptor_set_layouts.emplace(set_index, vkctx.device().createDescriptorSetLayoutUnique(info));
-            layouts.push_back(*it->second);
+            _descriptor_set_layouts.emplace(set_index, set_layout);
+            layouts.push_back(set_layout);
         }
 
-        vk::PipelineLayoutCreateInfo layout_info;
-        layout_info.pushConstantRangeCount = 0;
-        layout_info.pSetLayouts = layouts.data();
-        layout_info.setLayoutCount = static_cast<uint32_t>(layouts.size());
-        _layout = vkctx.device().createPipelineLayoutUnique(layout_info);
+        _layout = _args.layout;
+        if (!_layout)
+        {
+            vk::PipelineLayoutCreateInfo layout_info;
+            vk::PushConstantRange push_constant_range;
+            push_constant_range.offset = 0;
+            push_constant_range.size = _args.push_constant_size;
+            push_constant_range.stageFlags = vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment;
+
+            layout_info.pushConstantRangeCount = _args.push_constant_size > 0 ? 1 : 0;
+            layout_info.pPushConstantRanges = &push_constant_range;
+            layout_info.pSetLayouts = layouts.data();
+            layout_info.setLayoutCount = static_cast<uint32_t>(layouts.size());
+            _owned_layout = vkctx.device().createPipelineLayoutUnique(layout_info);
+            _layout = *_owned_layout;
+        }
 
-        pipeline_info.layout = *_layout;
+        pipeline_info.layout = _layout;
 
         auto created_pipeline = vkctx.device().createGraphicsPipelineUnique(vkctx.pipeline_cache(), pipeline_info);
         CRITICAL_CHECK(created_pipeline.result == vk::Result::eSuccess, "Failure creating vulkan graphics pipeline");
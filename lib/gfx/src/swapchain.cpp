@@ -7,6 +7,7 @@ namespace cathedral::gfx
     swapchain::swapchain(vulkan_context& vkctx, vk::PresentModeKHR initial_present_mode)
         : _vkctx(vkctx)
         , _present_mode(initial_present_mode)
+        , _image_ready_semaphores(1)
     {
         recreate();
     }
@@ -67,25 +68,44 @@ namespace cathedral::gfx
         init_swapchain();
         init_swapchain_images();
         init_swapchain_imageviews();
-        _image_ready_semaphore = _vkctx.create_default_semaphore();
+
+        // The device is idle, but an acquire may have left its semaphore signalled without a wait
+        for (auto& semaphore : _image_ready_semaphores)
+        {
+            semaphore = _vkctx.create_default_semaphore();
+        }
+    }
+
+    void swapchain::set_frames_in_flight(const uint32_t count)
+    {
+        CRITICAL_CHECK(count > 0, "Invalid frames in flight count");
+
+        _vkctx.device().waitIdle();
+        _image_ready_semaphores.resize(count);
+        for (auto& semaphore : _image_ready_semaphores)
+        {
+            semaphore = _vkctx.create_default_semaphore();
+        }
+        _semaphore_index = 0;
     }
 
     uint32_t swapchain::acquire_next_image(const std::function<void()>& swapchain_recreate_callback)
     {
+        _semaphore_index = (_semaphore_index + 1) % static_cast<uint32_t>(_image_ready_semaphores.size());
+
         while (true)
         {
             vk::ResultValue<uint32_t> acquire_result = { vk::Result::eErrorUnknown, 0 };
             try
             {
                 acquire_result =
-                    _vkctx.device().acquireNextImageKHR(_swapchain.swapchain, 1000000000, *_image_ready_semaphore);
+                    _vkctx.device().acquireNextImageKHR(_swapchain.swapchain, 1000000000, image_ready_semaphore());
             }
             catch (const std::exception& err)
             {
                 if (dynamic_cast<const vk::OutOfDateKHRError*>(&err) != nullptr)
                 {
                     recreate();
-                    _image_ready_semaphore = _vkctx.create_default_semaphore();
                     swapchain_recreate_callback();
                     continue;
                 }
@@ -95,7 +115,6 @@ namespace cathedral::gfx
                 acquire_result.result == vk::Result::eSuboptimalKHR)
             {
                 recreate();
-                _image_ready_semaphore = _vkctx.create_default_semaphore();
                 swapchain_recreate_callback();
             }
             else if (acquire_result.result == vk::Result::eSuccess)
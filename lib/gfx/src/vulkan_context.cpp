@@ -4,14 +4,104 @@
 
 #include <vk_mem_alloc.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <span>
+
 VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE;
 
 namespace cathedral::gfx
 {
+    namespace
+    {
+        constexpr uint32_t PIPELINE_CACHE_FILE_MAGIC = 0x43504C43; // "CLPC"
+        constexpr uint32_t PIPELINE_CACHE_FILE_VERSION = 1;
+
+        // Drivers are expected to reject foreign cache data themselves, but several crash on it instead, so the
+        // device identity is checked before handing them anything
+        struct pipeline_cache_file_header
+        {
+            uint32_t magic = PIPELINE_CACHE_FILE_MAGIC;
+            uint32_t version = PIPELINE_CACHE_FILE_VERSION;
+            uint32_t vendor_id = 0;
+            uint32_t device_id = 0;
+            uint32_t driver_version = 0;
+            std::array<uint8_t, VK_UUID_SIZE> driver_uuid = {};
+            std::array<uint8_t, VK_UUID_SIZE> cache_uuid = {};
+            uint64_t data_size = 0;
+            uint64_t data_hash = 0;
+
+            bool same_device(const pipeline_cache_file_header& other) const
+            {
+                return magic == other.magic && version == other.version && vendor_id == other.vendor_id &&
+                       device_id == other.device_id && driver_version == other.driver_version &&
+                       driver_uuid == other.driver_uuid && cache_uuid == other.cache_uuid;
+            }
+        };
+
+        uint64_t hash_pipeline_cache_data(const std::span<const uint8_t> data)
+        {
+            // FNV-1a
+            uint64_t hash = 0xCBF29CE484222325;
+            for (const uint8_t byte : data)
+            {
+                hash = (hash ^ byte) * 0x100000001B3;
+            }
+            return hash;
+        }
+
+        pipeline_cache_file_header get_pipeline_cache_header(const vk::PhysicalDevice physdev)
+        {
+            const auto properties = physdev.getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceIDProperties>();
+            const auto& device_properties = properties.get<vk::PhysicalDeviceProperties2>().properties;
+            const auto& id_properties = properties.get<vk::PhysicalDeviceIDProperties>();
+
+            pipeline_cache_file_header header;
+            header.vendor_id = device_properties.vendorID;
+            header.device_id = device_properties.deviceID;
+            header.driver_version = device_properties.driverVersion;
+            std::ranges::copy(id_properties.driverUUID, header.driver_uuid.begin());
+            std::ranges::copy(device_properties.pipelineCacheUUID, header.cache_uuid.begin());
+            return header;
+        }
+
+        std::vector<uint8_t> read_pipeline_cache_file(const std::string& path, const pipeline_cache_file_header& expected)
+        {
+            std::error_code ec;
+            const auto file_size = std::filesystem::file_size(path, ec);
+            if (ec || file_size < sizeof(pipeline_cache_file_header))
+            {
+                return {};
+            }
+
+            std::ifstream ifs(path, std::ios::binary);
+            pipeline_cache_file_header header;
+            if (!ifs.read(reinterpret_cast<char*>(&header), sizeof(header)) || !header.same_device(expected) ||
+                header.data_size != file_size - sizeof(header))
+            {
+                return {};
+            }
+
+            std::vector<uint8_t> data(header.data_size);
+            if (!ifs.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size())) ||
+                hash_pipeline_cache_data(data) != header.data_hash)
+            {
+                return {};
+            }
+            return data;
+        }
+    } // namespace
+
     vulkan_context::vulkan_context(const vulkan_context_args& args)
-        : _surface_size_retriever(args.surface_size_retriever)
+        : _descriptor_indexing(args.descriptor_indexing)
+        , _headless(args.headless)
+        , _surface_size_retriever(args.surface_size_retriever)
     {
-        CRITICAL_CHECK_NOTNULL(args.surface_retriever);
+        CRITICAL_CHECK(args.headless || args.surface_retriever, "Surface retriever required unless headless");
         CRITICAL_CHECK_NOTNULL(args.surface_size_retriever);
 
         // Dispatcher init
@@ -22,6 +112,7 @@ namespace cathedral::gfx
         auto inst = instance_builder.enable_validation_layers(args.validation_layers)
                         .require_api_version(1, 3, 0)
                         .set_minimum_instance_version(1, 3, 0)
+                        .set_headless(args.headless)
                         .use_default_debug_messenger()
                         .enable_extensions(args.instance_extensions)
                         .build();
@@ -32,25 +123,40 @@ namespace cathedral::gfx
         VULKAN_HPP_DEFAULT_DISPATCHER.init(vk::Instance(_instance.instance));
 
         // Init surface
-        _surface = args.surface_retriever(_instance.instance);
-        CRITICAL_CHECK(_surface, "Failure retrieving surface");
+        if (!_headless)
+        {
+            _surface = args.surface_retriever(_instance.instance);
+            CRITICAL_CHECK(_surface, "Failure retrieving surface");
+        }
 
         // Init physical device
         auto features = zero_struct<VkPhysicalDeviceFeatures>();
         features.samplerAnisotropy = vk::True;
+        features.shaderSampledImageArrayDynamicIndexing = args.descriptor_indexing ? vk::True : vk::False;
 
         auto features_12 = zero_struct<VkPhysicalDeviceVulkan12Features>();
         // features_12.bufferDeviceAddress = vk::True;
+        features_12.timelineSemaphore = vk::True;
+        if (args.descriptor_indexing)
+        {
+            features_12.descriptorIndexing = vk::True;
+            features_12.runtimeDescriptorArray = vk::True;
+            features_12.descriptorBindingPartiallyBound = vk::True;
+            features_12.descriptorBindingUpdateUnusedWhilePending = vk::True;
+        }
 
         auto features_13 = zero_struct<VkPhysicalDeviceVulkan13Features>();
         features_13.dynamicRendering = vk::True;
         features_13.synchronization2 = vk::True;
 
+        // Discrete GPUs are only preferred, so a headless context also runs on CPU implementations such as lavapipe
         vkb::PhysicalDeviceSelector pdev_selector(_instance);
-        auto pdev = pdev_selector.prefer_gpu_device_type(vkb::PreferredDeviceType::discrete)
-                        .require_present(true)
-                        .set_surface(_surface)
-                        .set_required_features(features)
+        pdev_selector.prefer_gpu_device_type(vkb::PreferredDeviceType::discrete).require_present(!_headless);
+        if (!_headless)
+        {
+            pdev_selector.set_surface(_surface);
+        }
+        auto pdev = pdev_selector.set_required_features(features)
                         .set_required_features_12(features_12)
                         .set_required_features_13(features_13)
                         .select();
@@ -58,6 +164,9 @@ namespace cathedral::gfx
         CRITICAL_CHECK(pdev.has_value(), "Failure retrieving physical device");
         _physdev = pdev.value();
 
+        // Lets VMA report real heap budgets instead of estimating them from the heap sizes
+        const bool memory_budget = _physdev.enable_extension_if_present(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
         // Init device
         const vkb::DeviceBuilder dev_builder(_physdev);
         auto dev = dev_builder.build();
@@ -72,25 +181,53 @@ namespace cathedral::gfx
         CRITICAL_CHECK(gfx_queue.has_value(), "Failure obtaining graphics queue");
         _graphics_queue = gfx_queue.value();
 
+        // Transfer queue, only from a family other than the graphics one
+        if (args.use_transfer_queue)
+        {
+            auto tx_queue = _device.get_queue(vkb::QueueType::transfer);
+            auto tx_index = _device.get_queue_index(vkb::QueueType::transfer);
+            if (tx_queue.has_value() && tx_index.has_value() && tx_index.value() != graphics_queue_family_index())
+            {
+                _transfer_queue = tx_queue.value();
+                _has_transfer_queue = true;
+            }
+        }
+
         // Init allocator
         auto allocator_info = zero_struct<VmaAllocatorCreateInfo>();
         allocator_info.device = device();
         allocator_info.instance = instance();
         allocator_info.physicalDevice = physdev();
         allocator_info.vulkanApiVersion = VK_API_VERSION_1_3;
+        if (memory_budget)
+        {
+            allocator_info.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+        }
 
         auto allocator_create_result = vmaCreateAllocator(&allocator_info, &_allocator);
         CRITICAL_CHECK(allocator_create_result == VkResult::VK_SUCCESS, "Failure creating VMA allocator");
 
+        _memory = std::make_unique<memory_tracker>(_allocator, args.memory_budget_ratio, args.memory_budget_hysteresis);
+
         // Init commandpool
         vk::CommandPoolCreateInfo cmdpool_info;
         cmdpool_info.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
         cmdpool_info.queueFamilyIndex = graphics_queue_family_index();
         _cmdpool = device().createCommandPoolUnique(cmdpool_info);
 
+        if (_has_transfer_queue)
+        {
+            vk::CommandPoolCreateInfo transfer_cmdpool_info;
+            transfer_cmdpool_info.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+            transfer_cmdpool_info.queueFamilyIndex = transfer_queue_family_index();
+            _transfer_cmdpool = device().createCommandPoolUnique(transfer_cmdpool_info);
+        }
+
         // Init descriptor pool
         std::vector<vk::DescriptorPoolSize> dpool_sizes = {
             { .type = vk::DescriptorType::eUniformBuffer, .descriptorCount = args.descriptor_pool_args.uniform_buffer_count },
+            { .type = vk::DescriptorType::eUniformBufferDynamic,
+              .descriptorCount = args.descriptor_pool_args.uniform_buffer_dynamic_count },
             { .type = vk::DescriptorType::eStorageBuffer, .descriptorCount = args.descriptor_pool_args.storage_buffer_count },
             { .type = vk::DescriptorType::eCombinedImageSampler,
               .descriptorCount = args.descriptor_pool_args.combined_image_sampler_count }
@@ -102,11 +239,7 @@ namespace cathedral::gfx
         dpool_info.maxSets = args.descriptor_pool_args.max_sets;
         _descriptor_pool = device().createDescriptorPoolUnique(dpool_info);
 
-        // Pipeline cache
-        vk::PipelineCacheCreateInfo pipeline_cache_info;
-        pipeline_cache_info.initialDataSize = 0;
-        pipeline_cache_info.pInitialData = nullptr;
-        _pipeline_cache = device().createPipelineCacheUnique(pipeline_cache_info);
+        init_pipeline_cache(args.pipeline_cache_dir);
     }
 
     vulkan_context::~vulkan_context() noexcept
@@ -114,6 +247,7 @@ namespace cathedral::gfx
         try
         {
             device().waitIdle();
+            save_pipeline_cache();
         }
         catch (const std::exception&)
         {
@@ -151,6 +285,17 @@ namespace cathedral::gfx
         return _device.get_queue_index(vkb::QueueType::graphics).value();
     }
 
+    vk::Queue vulkan_context::transfer_queue() const
+    {
+        return _has_transfer_queue ? _transfer_queue : _graphics_queue;
+    }
+
+    uint32_t vulkan_context::transfer_queue_family_index() const
+    {
+        return _has_transfer_queue ? _device.get_queue_index(vkb::QueueType::transfer).value()
+                                   : graphics_queue_family_index();
+    }
+
     const VmaAllocator& vulkan_context::allocator() const
     {
         return _allocator;
@@ -161,6 +306,11 @@ namespace cathedral::gfx
         return *_cmdpool;
     }
 
+    vk::CommandPool vulkan_context::transfer_command_pool() const
+    {
+        return _has_transfer_queue ? *_transfer_cmdpool : *_cmdpool;
+    }
+
     vk::DescriptorPool vulkan_context::descriptor_pool() const
     {
         return *_descriptor_pool;
@@ -171,6 +321,68 @@ namespace cathedral::gfx
         return *_pipeline_cache;
     }
 
+    bool vulkan_context::save_pipeline_cache()
+    {
+        if (_pipeline_cache_path.empty())
+        {
+            return true;
+        }
+
+        // Cache data only grows as pipelines are added, an unchanged size means there is nothing new to save
+        const auto data = device().getPipelineCacheData(*_pipeline_cache);
+        if (data.size() == _saved_pipeline_cache_size)
+        {
+            return true;
+        }
+
+        auto header = get_pipeline_cache_header(physdev());
+        header.data_size = data.size();
+        header.data_hash = hash_pipeline_cache_data(data);
+
+        // Written next to the destination and renamed over it, so a crash mid-write never leaves a truncated cache
+        const auto tmp_path = _pipeline_cache_path + ".tmp";
+        {
+            std::ofstream ofs(tmp_path, std::ios::binary | std::ios::trunc);
+            ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            ofs.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            if (!ofs)
+            {
+                debug_log("Failure writing pipeline cache file: " + tmp_path);
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmp_path, _pipeline_cache_path, ec);
+        if (ec)
+        {
+            debug_log("Failure replacing pipeline cache file: " + _pipeline_cache_path);
+            return false;
+        }
+
+        _saved_pipeline_cache_size = data.size();
+        return true;
+    }
+
+    void vulkan_context::set_pipeline_cache_dir(const std::string& cache_dir)
+    {
+        save_pipeline_cache();
+        _pipeline_cache_path.clear();
+        init_pipeline_cache(cache_dir);
+    }
+
+    uint32_t vulkan_context::min_uniform_buffer_offset_alignment() const
+    {
+        return static_cast<uint32_t>(_physdev.properties.limits.minUniformBufferOffsetAlignment);
+    }
+
+    uint32_t vulkan_context::max_sampled_image_descriptors() const
+    {
+        return std::min(
+            _physdev.properties.limits.maxPerStageDescriptorSamplers,
+            _physdev.properties.limits.maxDescriptorSetSampledImages);
+    }
+
     vk::Viewport vulkan_context::get_default_viewport() const
     {
         const auto wsz = get_surface_size();
@@ -203,6 +415,16 @@ namespace cathedral::gfx
         return std::move(result[0]);
     }
 
+    vk::UniqueCommandBuffer vulkan_context::create_transfer_commandbuffer() const
+    {
+        vk::CommandBufferAllocateInfo info;
+        info.commandBufferCount = 1;
+        info.commandPool = transfer_command_pool();
+        info.level = vk::CommandBufferLevel::ePrimary;
+        auto result = device().allocateCommandBuffersUnique(info);
+        return std::move(result[0]);
+    }
+
     void vulkan_context::submit_commandbuffer_sync(vk::CommandBuffer cmdbuff) const
     {
         vk::SubmitInfo submit;
@@ -219,6 +441,17 @@ namespace cathedral::gfx
         return device().createSemaphoreUnique({});
     }
 
+    vk::UniqueSemaphore vulkan_context::create_timeline_semaphore(const uint64_t initial_value) const
+    {
+        vk::SemaphoreTypeCreateInfo type_info;
+        type_info.semaphoreType = vk::SemaphoreType::eTimeline;
+        type_info.initialValue = initial_value;
+
+        vk::SemaphoreCreateInfo info;
+        info.pNext = &type_info;
+        return device().createSemaphoreUnique(info);
+    }
+
     vk::UniqueFence vulkan_context::create_signaled_fence() const
     {
         vk::FenceCreateInfo info;
@@ -230,4 +463,35 @@ namespace cathedral::gfx
     {
         return _surface_size_retriever();
     }
+
+    void vulkan_context::init_pipeline_cache(const std::string& cache_dir)
+    {
+        std::vector<uint8_t> initial_data;
+        if (!cache_dir.empty())
+        {
+            const auto header = get_pipeline_cache_header(physdev());
+
+            std::error_code ec;
+            std::filesystem::create_directories(cache_dir, ec);
+            const auto file_name = std::format("pipelines-{:04x}-{:04x}.bin", header.vendor_id, header.device_id);
+            _pipeline_cache_path = (std::filesystem::path(cache_dir) / file_name).string();
+
+            const auto load_start = std::chrono::steady_clock::now();
+            initial_data = read_pipeline_cache_file(_pipeline_cache_path, header);
+            const auto load_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - load_start);
+
+            debug_log(
+                initial_data.empty() ? "No usable pipeline cache at " + _pipeline_cache_path + ", starting cold"
+                                     : std::format("Loaded {} byte pipeline cache in {}", initial_data.size(), load_time));
+        }
+
+        vk::PipelineCacheCreateInfo pipeline_cache_info;
+        pipeline_cache_info.initialDataSize = initial_data.size();
+        pipeline_cache_info.pInitialData = initial_data.empty() ? nullptr : initial_data.data();
+        _pipeline_cache = device().createPipelineCacheUnique(pipeline_cache_info);
+
+        // What was loaded is already on disk
+        _saved_pipeline_cache_size = initial_data.size();
+    }
 } // namespace cathedral::gfx
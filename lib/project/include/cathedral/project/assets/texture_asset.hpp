@@ -7,6 +7,7 @@
 #include <cathedral/project/serialization/sampler_info.hpp>
 
 #include <cathedral/glm_serializers.hpp>
+#include <cathedral/mapped_file.hpp>
 
 #include <cereal/types/base_class.hpp>
 #include <cereal/types/polymorphic.hpp>
@@ -20,6 +21,28 @@ namespace cathedral::project
     public:
         using asset::asset;
 
+        // Maps the binary once and validates its mip table, to read any number of mips from it
+        class mip_reader
+        {
+        public:
+            explicit mip_reader(const texture_asset& asset);
+
+            CATHEDRAL_NON_COPYABLE(mip_reader);
+            mip_reader(mip_reader&&) = delete;
+            mip_reader& operator=(mip_reader&&) = delete;
+
+            uint32_t mip_count() const { return static_cast<uint32_t>(_compressed_mips.size()); }
+
+            size_t mip_size_bytes(uint32_t mip_index) const;
+
+            void read(uint32_t mip_index, std::span<std::byte> dst) const;
+
+        private:
+            mapped_file _file;
+            std::vector<size_t> _mip_sizes;
+            std::vector<std::span<const std::byte>> _compressed_mips;
+        };
+
         CATHEDRAL_ASSET_SUBCLASS_DECL
 
         uint32_t width() const { return _width; }
@@ -40,6 +63,7 @@ namespace cathedral::project
 
         [[nodiscard]] std::vector<std::vector<std::byte>> load_mips() const;
         [[nodiscard]] std::vector<std::byte> load_single_mip(uint32_t mip_index) const;
+        void load_single_mip(uint32_t mip_index, std::span<std::byte> dst) const;
         void save_mips(const std::vector<std::vector<std::byte>>& mips) const;
 
         const auto& sampler_info() const { return _sampler_info; }
@@ -53,6 +53,9 @@ namespace cathedral::project
 
         const std::string& scenes_path() const { return _scenes_path; }
 
+        // Machine specific data that can be regenerated, such as pipeline caches
+        const std::string& cache_path() const { return _cache_path; }
+
         template <concepts::Asset TAsset>
         void add_asset(std::shared_ptr<TAsset> asset)
         {
@@ -206,6 +209,11 @@ namespace cathedral::project
             return relpath_to_name(abspath_to_relpath<T>(abspath));
         }
 
+        // Streamed textures start with their smallest mips and get the rest on demand from the renderer's texture streamer
+        bool stream_textures() const { return _stream_textures; }
+
+        void set_stream_textures(const bool stream) { _stream_textures = stream; }
+
         engine::scene_loader_funcs get_loader_funcs() const;
 
         std::vector<std::string> available_scenes() const;
@@ -218,6 +226,7 @@ namespace cathedral::project
 
     private:
         bool _loaded = false;
+        bool _stream_textures = true;
         std::string _project_name;
         std::string _root_path;
 
@@ -228,6 +237,7 @@ namespace cathedral::project
         std::string _textures_path;
 
         std::string _scenes_path;
+        std::string _cache_path;
 
         std::unordered_map<std::string, std::shared_ptr<material_asset>> _material_assets;
         std::unordered_map<std::string, std::shared_ptr<mesh_asset>> _mesh_assets;
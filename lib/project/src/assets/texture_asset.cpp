@@ -3,6 +3,7 @@
 #include <cathedral/project/project.hpp>
 
 #include <cathedral/compression.hpp>
+#include <cathedral/mapped_file.hpp>
 
 #include <ien/base64.hpp>
 #include <ien/fs_utils.hpp>
@@ -11,71 +12,190 @@
 
 #include <magic_enum.hpp>
 
+#include <cstddef>
+#include <cstring>
+
 namespace cathedral::project
 {
-    CATHEDRAL_ASSET_SUBCLASS_IMPL(texture_asset);
-
-    std::vector<std::vector<std::byte>> texture_asset::load_mips() const
+    namespace
     {
-        CRITICAL_CHECK(std::filesystem::exists(binpath()), "Texture asset binpath not found");
-        const std::optional<std::vector<std::byte>> compressed_mips_data = ien::read_file_binary(binpath());
-        CRITICAL_CHECK(compressed_mips_data.has_value(), "Unable to read texture mips data from file");
+        // Texture binaries start with a header and a table of mips, followed by the LZ4 compressed data of every mip.
+        // Mips can be decompressed straight out of a mapping of the file. All values are little endian.
+        constexpr uint32_t TEXTURE_CONTAINER_MAGIC = 0x58455443; // "CTEX"
+        constexpr uint32_t TEXTURE_CONTAINER_VERSION = 1;
 
-        ien::deserializer deserializer(std::span{ *compressed_mips_data });
-        const auto compressed_mips = deserializer.deserialize<std::vector<std::vector<std::byte>>>();
+        struct texture_container_header
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t mip_count;
+            uint32_t reserved;
+        };
+
+        struct texture_container_mip
+        {
+            uint64_t offset;
+            uint64_t compressed_size;
+            uint64_t uncompressed_size;
+        };
 
-        std::vector<size_t> mip_uncompressed_sizes;
-        mip_uncompressed_sizes.reserve(_mip_dimensions.size());
-        for (const auto& mip_dim : _mip_dimensions)
+        template <typename T>
+        T read_value(const std::span<const std::byte> data, const size_t offset)
         {
-            mip_uncompressed_sizes.push_back(engine::calc_texture_size(mip_dim.x, mip_dim.y, _format));
+            CRITICAL_CHECK(offset + sizeof(T) <= data.size(), "Texture binary is truncated");
+            T result;
+            std::memcpy(&result, data.data() + offset, sizeof(T));
+            return result;
         }
 
-        std::vector<std::vector<std::byte>> uncompressed_mips;
-        uncompressed_mips.reserve(mip_uncompressed_sizes.size());
-        for (size_t i = 0; i < mip_uncompressed_sizes.size(); ++i)
+        // Binaries written before the container was introduced: a serialized vector<vector<byte>>
+        std::vector<std::span<const std::byte>> get_legacy_compressed_mips(const std::span<const std::byte> data)
         {
-            uncompressed_mips.push_back(
-                decompress_data({ compressed_mips[i].data(), compressed_mips[i].size() }, mip_uncompressed_sizes[i]));
+            using size_type = IEN_SERIALIZE_CONTAINER_SIZE_T;
+
+            size_t offset = 0;
+            const auto mip_count = read_value<size_type>(data, offset);
+            offset += sizeof(size_type);
+
+            std::vector<std::span<const std::byte>> result;
+            for (size_type i = 0; i < mip_count; ++i)
+            {
+                const auto mip_size = static_cast<size_t>(read_value<size_type>(data, offset));
+                offset += sizeof(size_type);
+                CRITICAL_CHECK(offset + mip_size <= data.size(), "Texture binary is truncated");
+                result.push_back(data.subspan(offset, mip_size));
+                offset += mip_size;
+            }
+            return result;
         }
 
-        return uncompressed_mips;
+        std::vector<std::span<const std::byte>> get_compressed_mips(
+            const std::span<const std::byte> data,
+            const std::span<const size_t> mip_sizes)
+        {
+            std::vector<std::span<const std::byte>> result;
+            if (data.size() < sizeof(texture_container_header) ||
+                read_value<uint32_t>(data, offsetof(texture_container_header, magic)) != TEXTURE_CONTAINER_MAGIC)
+            {
+                result = get_legacy_compressed_mips(data);
+            }
+            else
+            {
+                const auto header = read_value<texture_container_header>(data, 0);
+                CRITICAL_CHECK(header.version <= TEXTURE_CONTAINER_VERSION, "Unsupported texture container version");
+                CRITICAL_CHECK(header.mip_count == mip_sizes.size(), "Deserialization failure: mip count mismatch");
+
+                result.reserve(header.mip_count);
+                for (uint32_t i = 0; i < header.mip_count; ++i)
+                {
+                    const auto mip = read_value<texture_container_mip>(
+                        data,
+                        sizeof(texture_container_header) + (i * sizeof(texture_container_mip)));
+                    CRITICAL_CHECK(
+                        mip.offset <= data.size() && mip.compressed_size <= data.size() - mip.offset,
+                        "Texture binary is truncated");
+                    CRITICAL_CHECK(mip.uncompressed_size == mip_sizes[i], "Deserialization failure: mip size mismatch");
+                    result.push_back(data.subspan(mip.offset, mip.compressed_size));
+                }
+            }
+
+            CRITICAL_CHECK(result.size() == mip_sizes.size(), "Deserialization failure: mip count mismatch");
+            return result;
+        }
+    } // namespace
+
+    CATHEDRAL_ASSET_SUBCLASS_IMPL(texture_asset);
+
+    texture_asset::mip_reader::mip_reader(const texture_asset& asset)
+        : _file([&asset] {
+            CRITICAL_CHECK(std::filesystem::exists(asset.binpath()), "Texture asset binpath not found");
+            return mapped_file(asset.binpath());
+        }())
+    {
+        _mip_sizes.reserve(asset._mip_dimensions.size());
+        for (const auto& mip_dim : asset._mip_dimensions)
+        {
+            _mip_sizes.push_back(engine::calc_texture_size(mip_dim.x, mip_dim.y, asset._format));
+        }
+        _compressed_mips = get_compressed_mips(_file.data(), _mip_sizes);
+    }
+
+    size_t texture_asset::mip_reader::mip_size_bytes(const uint32_t mip_index) const
+    {
+        CRITICAL_CHECK(mip_index < _mip_sizes.size(), "Mip index out of range");
+        return _mip_sizes[mip_index];
     }
 
-    std::vector<std::byte> texture_asset::load_single_mip(uint32_t mip_index) const
+    void texture_asset::mip_reader::read(const uint32_t mip_index, const std::span<std::byte> dst) const
     {
-        CRITICAL_CHECK(std::filesystem::exists(binpath()), "Texture asset binpath not found");
-        const std::optional<std::vector<std::byte>> compressed_mips_data = ien::read_file_binary(binpath());
-        CRITICAL_CHECK(compressed_mips_data.has_value(), "Unable to read texture mips data from file");
+        CRITICAL_CHECK(dst.size() == mip_size_bytes(mip_index), "Mip destination size mismatch");
+        decompress_data(_compressed_mips[mip_index], dst);
+    }
 
-        ien::deserializer deserializer(std::span{ *compressed_mips_data });
-        const auto mip_count = deserializer.deserialize<IEN_SERIALIZE_CONTAINER_SIZE_T>();
-        CRITICAL_CHECK(_mip_dimensions.size() == mip_count, "Deserialization failure: mip count mismatch");
+    std::vector<std::vector<std::byte>> texture_asset::load_mips() const
+    {
+        const mip_reader reader(*this);
 
-        for (size_t i = 0; i < mip_index; ++i)
+        std::vector<std::vector<std::byte>> uncompressed_mips;
+        uncompressed_mips.reserve(reader.mip_count());
+        for (uint32_t i = 0; i < reader.mip_count(); ++i)
         {
-            const auto mip_length = deserializer.deserialize<IEN_SERIALIZE_CONTAINER_SIZE_T>();
-            deserializer.advance(mip_length);
+            auto& mip = uncompressed_mips.emplace_back(reader.mip_size_bytes(i));
+            reader.read(i, mip);
         }
 
-        const auto compressed_mip = deserializer.deserialize<std::vector<std::byte>>();
-        const auto& mip_dim = _mip_dimensions[mip_index];
-        const auto uncompressed_size = engine::calc_texture_size(mip_dim.x, mip_dim.y, _format);
-        return decompress_data(compressed_mip, uncompressed_size);
+        return uncompressed_mips;
+    }
+
+    std::vector<std::byte> texture_asset::load_single_mip(const uint32_t mip_index) const
+    {
+        const mip_reader reader(*this);
+
+        std::vector<std::byte> result(reader.mip_size_bytes(mip_index));
+        reader.read(mip_index, result);
+        return result;
+    }
+
+    void texture_asset::load_single_mip(const uint32_t mip_index, const std::span<std::byte> dst) const
+    {
+        mip_reader(*this).read(mip_index, dst);
     }
 
     void texture_asset::save_mips(const std::vector<std::vector<std::byte>>& mips) const
     {
+        CRITICAL_CHECK(mips.size() == _mip_dimensions.size(), "Mip count mismatch");
+
         std::vector<std::vector<std::byte>> compressed_mips;
-        compressed_mips.reserve(_mip_dimensions.size());
-        for (size_t i = 0; i < _mip_dimensions.size(); ++i)
+        compressed_mips.reserve(mips.size());
+        for (const auto& mip : mips)
+        {
+            compressed_mips.push_back(compress_data(mip));
+        }
+
+        const texture_container_header header{ .magic = TEXTURE_CONTAINER_MAGIC,
+                                               .version = TEXTURE_CONTAINER_VERSION,
+                                               .mip_count = static_cast<uint32_t>(mips.size()),
+                                               .reserved = 0 };
+
+        std::vector<texture_container_mip> table;
+        table.reserve(mips.size());
+        uint64_t offset = sizeof(header) + (sizeof(texture_container_mip) * mips.size());
+        for (size_t i = 0; i < mips.size(); ++i)
+        {
+            table.push_back(
+                { .offset = offset, .compressed_size = compressed_mips[i].size(), .uncompressed_size = mips[i].size() });
+            offset += compressed_mips[i].size();
+        }
+
+        std::vector<std::byte> data(offset);
+        std::memcpy(data.data(), &header, sizeof(header));
+        std::memcpy(data.data() + sizeof(header), table.data(), table.size() * sizeof(texture_container_mip));
+        for (size_t i = 0; i < mips.size(); ++i)
         {
-            compressed_mips.push_back(compress_data(mips[i]));
+            std::memcpy(data.data() + table[i].offset, compressed_mips[i].data(), compressed_mips[i].size());
         }
 
-        ien::serializer serializer;
-        serializer.serialize(compressed_mips);
-        write_asset_binary(serializer.data());
+        write_asset_binary(data);
     }
 
     size_t texture_asset::texture_size_bytes() const
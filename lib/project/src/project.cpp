@@ -58,6 +58,7 @@ namespace cathedral::project
         _textures_path = (std::filesystem::path(project_path) / "textures").string();
         _meshes_path = (std::filesystem::path(project_path) / "meshes").string();
         _scenes_path = (std::filesystem::path(project_path) / "scenes").string();
+        _cache_path = (std::filesystem::path(project_path) / ".cache").string();
 
         load_shader_assets();
         load_texture_assets();
@@ -160,6 +161,23 @@ namespace cathedral::project
             }
             const auto& asset = _texture_assets.at(name);
 
+            if (_stream_textures && asset->mip_sizes().size() > 1)
+            {
+                engine::texture_args_streamed tex_args;
+                tex_args.name = asset->name();
+                tex_args.sampler_info = asset->sampler_info();
+                tex_args.format = asset->format();
+                tex_args.mip_sizes = asset->mip_sizes();
+
+                // Every streaming step reads from the same mapping of the binary
+                auto reader = std::make_shared<texture_asset::mip_reader>(*asset);
+                tex_args.mip_loader = [reader](const uint32_t mip_index, const std::span<std::byte> dst) {
+                    reader->read(mip_index, dst);
+                };
+
+                return scene.get_renderer().create_streamed_texture(std::move(tex_args));
+            }
+
             engine::texture_args_from_data tex_args;
             tex_args.name = asset->name();
             tex_args.sampler_info = asset->sampler_info();
@@ -0,0 +1,96 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cathedral/engine/buffer_copy_list.hpp>
+
+#include <cstdint>
+
+using namespace cathedral;
+
+namespace
+{
+    vk::Buffer fake_buffer(const uintptr_t id)
+    {
+        return vk::Buffer(reinterpret_cast<VkBuffer>(id));
+    }
+} // namespace
+
+TEST_CASE("Buffer copy list merges contiguous copies")
+{
+    const auto staging = fake_buffer(1);
+
+    engine::buffer_copy_list list;
+    list.add(staging, 0, 64, 16);
+    list.add(staging, 16, 80, 16);
+    list.add(staging, 32, 96, 32);
+
+    REQUIRE(list.copies().size() == 1);
+    REQUIRE(list.copies()[0].region.srcOffset == 0);
+    REQUIRE(list.copies()[0].region.dstOffset == 64);
+    REQUIRE(list.copies()[0].region.size == 64);
+
+    // Not contiguous in the staging buffer
+    list.add(staging, 128, 128, 16);
+    REQUIRE(list.copies().size() == 2);
+
+    // Contiguous, but from another staging buffer
+    list.add(fake_buffer(2), 144, 144, 16);
+    REQUIRE(list.copies().size() == 3);
+
+    REQUIRE(list.dst_begin() == 64);
+    REQUIRE(list.dst_end() == 160);
+}
+
+TEST_CASE("Buffer copy list keeps the latest data on overlap")
+{
+    const auto staging = fake_buffer(1);
+
+    SECTION("Covered copies are dropped")
+    {
+        engine::buffer_copy_list list;
+        list.add(staging, 0, 0, 64);
+        list.add(staging, 256, 0, 64);
+
+        REQUIRE(list.copies().size() == 1);
+        REQUIRE(list.copies()[0].region.srcOffset == 256);
+        REQUIRE(list.copies()[0].region.size == 64);
+    }
+
+    SECTION("Partially covered copies are trimmed")
+    {
+        engine::buffer_copy_list list;
+        list.add(staging, 0, 0, 64);   // [0, 64)
+        list.add(staging, 100, 48, 32); // [48, 80)
+
+        REQUIRE(list.copies().size() == 2);
+        REQUIRE(list.copies()[0].region.dstOffset == 0);
+        REQUIRE(list.copies()[0].region.size == 48);
+
+        list.add(staging, 200, 40, 16); // [40, 56)
+        REQUIRE(list.copies().size() == 3);
+        REQUIRE(list.copies()[0].region.size == 40);
+        REQUIRE(list.copies()[1].region.srcOffset == 108);
+        REQUIRE(list.copies()[1].region.dstOffset == 56);
+        REQUIRE(list.copies()[1].region.size == 24);
+    }
+
+    SECTION("Copies covering the middle of another split it")
+    {
+        engine::buffer_copy_list list;
+        list.add(staging, 0, 0, 96);
+        list.add(staging, 512, 32, 16);
+
+        REQUIRE(list.copies().size() == 3);
+
+        vk::DeviceSize covered = 0;
+        for (const auto& copy : list.copies())
+        {
+            covered += copy.region.size;
+            if (copy.region.dstOffset == 48)
+            {
+                REQUIRE(copy.region.srcOffset == 48);
+                REQUIRE(copy.region.size == 48);
+            }
+        }
+        REQUIRE(covered == 96);
+    }
+}
@@ -0,0 +1,146 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cathedral/engine/descriptor_allocator.hpp>
+#include <cathedral/gfx/buffers/uniform_buffer.hpp>
+
+#include "headless_vulkan.hpp"
+
+#include <vector>
+
+using namespace cathedral;
+
+namespace
+{
+    gfx::descriptor_set_definition uniform_set_definition()
+    {
+        gfx::descriptor_set_definition result;
+        result.entries.emplace_back(0, 0, gfx::descriptor_type::UNIFORM, 1);
+        return result;
+    }
+} // namespace
+
+TEST_CASE("Descriptor allocator grows its pools on demand")
+{
+    if (!tests::headless_vulkan_available())
+    {
+        SKIP("No Vulkan 1.3 device available");
+    }
+
+    const auto vkctx = tests::make_headless_vulkan_context();
+    const auto definition = uniform_set_definition();
+
+    engine::descriptor_allocator_args args;
+    args.sets_per_pool = 2;
+    args.max_sets_per_pool = 8;
+    engine::descriptor_allocator allocator(*vkctx, args);
+
+    // Pools of 2, 4, 8 and then 8 sets again
+    std::vector<engine::pooled_descriptor_set> sets;
+    const auto allocate_until = [&](const size_t count) {
+        while (sets.size() < count)
+        {
+            sets.push_back(allocator.allocate(definition));
+            REQUIRE(sets.back());
+        }
+    };
+
+    allocate_until(2);
+    REQUIRE(allocator.stats().pool_count == 1);
+    allocate_until(3);
+    REQUIRE(allocator.stats().pool_count == 2);
+    allocate_until(14);
+    REQUIRE(allocator.stats().pool_count == 3);
+    allocate_until(15);
+    REQUIRE(allocator.stats().pool_count == 4);
+    allocate_until(22);
+    REQUIRE(allocator.stats().pool_count == 4);
+
+    REQUIRE(allocator.stats().allocated_sets == 22);
+    REQUIRE(allocator.stats().recycled_sets == 0);
+}
+
+TEST_CASE("Descriptor allocator recycles released sets after the frames in flight")
+{
+    if (!tests::headless_vulkan_available())
+    {
+        SKIP("No Vulkan 1.3 device available");
+    }
+
+    const auto vkctx = tests::make_headless_vulkan_context();
+    const auto definition = uniform_set_definition();
+
+    engine::descriptor_allocator_args args;
+    args.frames_in_flight = 2;
+    engine::descriptor_allocator allocator(*vkctx, args);
+
+    allocator.begin_frame(0);
+    auto released = allocator.allocate(definition);
+    const vk::DescriptorSet released_handle = *released;
+    released = {};
+
+    // Frame 1 may still be using it
+    allocator.begin_frame(1);
+    const auto frame_1_set = allocator.allocate(definition);
+    REQUIRE(*frame_1_set != released_handle);
+    REQUIRE(allocator.stats().recycled_sets == 0);
+
+    allocator.begin_frame(2);
+    const auto frame_2_set = allocator.allocate(definition);
+    REQUIRE(*frame_2_set == released_handle);
+    REQUIRE(allocator.stats().recycled_sets == 1);
+    REQUIRE(allocator.stats().allocated_sets == 2);
+
+    // Recycled sets only serve identical definitions
+    gfx::descriptor_set_definition other_definition;
+    other_definition.entries.emplace_back(0, 0, gfx::descriptor_type::UNIFORM_DYNAMIC, 1);
+    auto other = allocator.allocate(other_definition);
+    other = {};
+    allocator.begin_frame(4);
+    REQUIRE(allocator.layout(other_definition) != allocator.layout(definition));
+
+    const auto frame_4_set = allocator.allocate(definition);
+    REQUIRE(allocator.stats().recycled_sets == 1);
+    REQUIRE(allocator.stats().allocated_sets == 4);
+}
+
+TEST_CASE("Descriptor write batch flushes every write at once")
+{
+    if (!tests::headless_vulkan_available())
+    {
+        SKIP("No Vulkan 1.3 device available");
+    }
+
+    const auto vkctx = tests::make_headless_vulkan_context();
+    const auto definition = uniform_set_definition();
+    engine::descriptor_allocator allocator(*vkctx);
+
+    gfx::uniform_buffer_args buffer_args;
+    buffer_args.vkctx = vkctx.get();
+    buffer_args.size = 256;
+    const gfx::uniform_buffer buffer(buffer_args);
+
+    const auto set_a = allocator.allocate(definition);
+    const auto set_b = allocator.allocate(definition);
+
+    engine::descriptor_write_batch batch;
+    REQUIRE(batch.empty());
+
+    // Nothing to write
+    batch.write_images(*set_a, 1, {});
+    REQUIRE(batch.empty());
+
+    // The buffer infos have to stay valid while more writes are added
+    for (uint32_t i = 0; i < 64; ++i)
+    {
+        const auto& set = (i % 2 == 0) ? set_a : set_b;
+        batch.write_buffer(*set, 0, vk::DescriptorType::eUniformBuffer, { buffer.buffer(), 0, 256 });
+    }
+    REQUIRE_FALSE(batch.empty());
+
+    batch.flush(*vkctx);
+    REQUIRE(batch.empty());
+
+    // Flushing an empty batch is a no-op
+    batch.flush(*vkctx);
+    REQUIRE(batch.empty());
+}
@@ -0,0 +1,382 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cathedral/engine/material.hpp>
+#include <cathedral/engine/mesh.hpp>
+#include <cathedral/engine/nodes/mesh3d_node.hpp>
+#include <cathedral/engine/renderer.hpp>
+#include <cathedral/engine/scene.hpp>
+#include <cathedral/gfx/buffers/staging_buffer.hpp>
+#include <cathedral/gfx/offscreen_target.hpp>
+#include <cathedral/gfx/vulkan_context.hpp>
+
+#include "headless_vulkan.hpp"
+
+#include <ien/image/image.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+using namespace cathedral;
+
+namespace
+{
+    struct headless_renderer
+    {
+        std::unique_ptr<gfx::vulkan_context> vkctx;
+        std::unique_ptr<gfx::offscreen_target> target;
+        std::unique_ptr<engine::renderer> renderer;
+
+        explicit headless_renderer(
+            const uint32_t frames_in_flight,
+            const bool use_transfer_queue = true,
+            const uint32_t recording_threads = 0)
+        {
+            vkctx = tests::make_headless_vulkan_context(use_transfer_queue);
+
+            gfx::offscreen_target_args target_args;
+            target_args.vkctx = vkctx.get();
+            target = std::make_unique<gfx::offscreen_target>(target_args);
+
+            engine::renderer_args renderer_args;
+            renderer_args.swapchain = target.get();
+            renderer_args.frames_in_flight = frames_in_flight;
+            renderer_args.recording_threads = recording_threads;
+            renderer = std::make_unique<engine::renderer>(renderer_args);
+        }
+
+        // 'cpu_work' stands in for the game logic and draw recording the GPU can overlap with
+        void render_frames(const uint32_t count, const std::chrono::microseconds cpu_work = {}) const
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                renderer->begin_frame();
+                const auto work_end = std::chrono::steady_clock::now() + cpu_work;
+                while (std::chrono::steady_clock::now() < work_end)
+                {
+                }
+                renderer->end_frame();
+            }
+        }
+
+        // Runs 'fn' between begin_frame and end_frame, where scenes tick
+        void render_frame(const std::function<void()>& fn) const
+        {
+            renderer->begin_frame();
+            fn();
+            renderer->end_frame();
+        }
+    };
+
+    // Copies a mip of a sampled image back to host memory
+    std::vector<std::byte> read_image_mip(
+        const gfx::vulkan_context& vkctx,
+        const gfx::image& image,
+        const uint32_t mip,
+        const size_t size)
+    {
+        vkctx.device().waitIdle();
+
+        gfx::staging_buffer_args buffer_args;
+        buffer_args.vkctx = &vkctx;
+        buffer_args.size = size;
+        gfx::staging_buffer buffer(buffer_args);
+
+        auto cmdbuff = vkctx.create_primary_commandbuffer();
+        cmdbuff->begin(vk::CommandBufferBeginInfo{});
+        image.transition_layout_suboptimal(
+            vk::ImageLayout::eShaderReadOnlyOptimal,
+            vk::ImageLayout::eTransferSrcOptimal,
+            *cmdbuff,
+            image.aspect_flags(),
+            mip,
+            1);
+
+        vk::BufferImageCopy region;
+        region.imageSubresource = vk::ImageSubresourceLayers(image.aspect_flags(), mip, 0, 1);
+        region.imageExtent = vk::Extent3D{ .width = std::max(image.width() >> mip, 1U),
+                                           .height = std::max(image.height() >> mip, 1U),
+                                           .depth = 1U };
+        cmdbuff->copyImageToBuffer(image.get_image(), vk::ImageLayout::eTransferSrcOptimal, buffer.buffer(), region);
+
+        image.transition_layout_suboptimal(
+            vk::ImageLayout::eTransferSrcOptimal,
+            vk::ImageLayout::eShaderReadOnlyOptimal,
+            *cmdbuff,
+            image.aspect_flags(),
+            mip,
+            1);
+        cmdbuff->end();
+
+        vk::SubmitInfo submit_info;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &*cmdbuff;
+        vkctx.graphics_queue().submit(submit_info);
+        vkctx.device().waitIdle();
+
+        std::vector<std::byte> result(size);
+        std::memcpy(result.data(), buffer.map_memory(), size);
+        return result;
+    }
+
+    // Places quads straight in clip space, the model matrix is their only transform
+    constexpr auto QUAD_VERTEX_SHADER = R"glsl(
+$NODE_VARIABLE mat4 model;
+
+layout (location = 0) out vec4 color;
+
+void main()
+{
+    gl_Position = model * vec4(VERTEX_POSITION, 1.0);
+    color = VERTEX_COLOR;
+}
+)glsl";
+
+    constexpr auto QUAD_FRAGMENT_SHADER = R"glsl(
+$NODE_VARIABLE mat4 model;
+
+layout (location = 0) in vec4 color;
+layout (location = 0) out vec4 out_color;
+
+void main()
+{
+    out_color = color;
+}
+)glsl";
+
+    std::shared_ptr<engine::mesh> make_quad_mesh()
+    {
+        std::vector<glm::vec3> positions = { { -0.5F, -0.5F, 0.0F },
+                                             { 0.5F, -0.5F, 0.0F },
+                                             { 0.5F, 0.5F, 0.0F },
+                                             { -0.5F, 0.5F, 0.0F } };
+        std::vector<glm::vec2> uvcoords = { { 0.0F, 0.0F }, { 1.0F, 0.0F }, { 1.0F, 1.0F }, { 0.0F, 1.0F } };
+        std::vector<glm::vec3> normals(4, glm::vec3{ 0.0F, 0.0F, 1.0F });
+        std::vector<glm::vec4> colors = { { 1.0F, 0.0F, 0.0F, 1.0F },
+                                          { 0.0F, 1.0F, 0.0F, 1.0F },
+                                          { 0.0F, 0.0F, 1.0F, 1.0F },
+                                          { 1.0F, 1.0F, 1.0F, 1.0F } };
+
+        // Both windings, so the quads show whatever the culling mode
+        std::vector<uint32_t> indices = { 0, 1, 2, 2, 3, 0, 0, 2, 1, 2, 0, 3 };
+
+        return std::make_shared<engine::mesh>(
+            std::move(positions),
+            std::move(uvcoords),
+            std::move(normals),
+            std::move(colors),
+            std::move(indices));
+    }
+
+    // Draws a grid of quads, enough of them to span several secondary command buffers when recording on threads
+    ien::image render_quad_grid(const headless_renderer& headless)
+    {
+        constexpr uint32_t COLUMNS = 20;
+        constexpr uint32_t ROWS = 15;
+
+        engine::scene_args scene_args;
+        scene_args.prenderer = headless.renderer.get();
+        scene_args.loaders.material_loader = [](const std::string& name, engine::scene& scene) {
+            engine::material_args args;
+            args.name = name;
+            args.vertex_shader_source = QUAD_VERTEX_SHADER;
+            args.fragment_shader_source = QUAD_FRAGMENT_SHADER;
+            args.node_bindings[engine::shader_node_uniform_binding::NODE_MODEL_MATRIX] = "model";
+            return scene.get_renderer().create_material(std::move(args));
+        };
+        scene_args.loaders.mesh_loader = [](const std::string&, engine::scene&) { return make_quad_mesh(); };
+        scene_args.loaders.texture_loader = [](const std::string&, engine::scene&) {
+            return std::shared_ptr<engine::texture>{};
+        };
+        engine::scene scene(std::move(scene_args));
+
+        for (uint32_t y = 0; y < ROWS; ++y)
+        {
+            for (uint32_t x = 0; x < COLUMNS; ++x)
+            {
+                auto node = scene.add_root_node<engine::mesh3d_node>(std::format("quad_{}_{}", x, y));
+                node->set_mesh("quad");
+                node->set_material("quad");
+                node->set_local_position({ -1.0F + ((static_cast<float>(x) + 0.5F) * 2.0F / COLUMNS),
+                                           -1.0F + ((static_cast<float>(y) + 0.5F) * 2.0F / ROWS),
+                                           0.0F });
+                node->set_local_scale({ 1.6F / COLUMNS, 1.6F / ROWS, 1.0F });
+            }
+        }
+
+        // Material pipelines are compiled on worker threads and nodes start drawing the frame after theirs is ready
+        const auto ready = [&headless] {
+            const auto& materials = headless.renderer->materials();
+            return materials.contains("quad") && materials.at("quad")->pipeline_ready();
+        };
+        for (uint32_t i = 0; i < 1000 && !ready(); ++i)
+        {
+            scene.tick([](double) {});
+        }
+        REQUIRE(ready());
+
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            scene.tick([](double) {});
+        }
+        return headless.renderer->capture_screenshot();
+    }
+
+    void fill_mip_pattern(const uint32_t mip, const std::span<std::byte> dst)
+    {
+        for (size_t i = 0; i < dst.size(); ++i)
+        {
+            dst[i] = static_cast<std::byte>(((mip * 31) + i) & 0xFF);
+        }
+    }
+} // namespace
+
+TEST_CASE("Headless renderer clears the offscreen target")
+{
+    if (!tests::headless_vulkan_available())
+    {
+        SKIP("No Vulkan 1.3 device available");
+    }
+
+    const headless_renderer headless(2);
+
+    // More frames than images, so every image is rendered over after having been left in TransferSrcOptimal
+    headless.render_frames(5);
+
+    const auto screenshot = headless.renderer->capture_screenshot();
+    REQUIRE(screenshot.width() == static_cast<size_t>(tests::HEADLESS_WIDTH));
+    REQUIRE(screenshot.height() == static_cast<size_t>(tests::HEADLESS_HEIGHT));
+
+    // The opaque pass clears to opaque black
+    bool all_cleared = true;
+    for (size_t i = 0; i < screenshot.size(); i += 4)
+    {
+        const auto* px = screenshot.data() + i;
+        all_cleared = all_cleared && px[0] == 0 && px[1] == 0 && px[2] == 0 && px[3] == 255;
+    }
+    REQUIRE(all_cleared);
+}
+
+TEST_CASE("Draws recorded on threads match inline recording")
+{
+    if (!tests::headless_vulkan_available())
+    {
+        SKIP("No Vulkan 1.3 device available");
+    }
+
+    const headless_renderer inline_headless(2);
+    REQUIRE_FALSE(inline_headless.renderer->records_on_threads());
+    const auto inline_image = render_quad_grid(inline_headless);
+
+    const headless_renderer threaded_headless(2, true, 4);
+    REQUIRE(threaded_headless.renderer->records_on_threads());
+    const auto threaded_image = render_quad_grid(threaded_headless);
+
+    REQUIRE(inline_image.size() == threaded_image.size());
+
+    // Something was drawn besides the clear color
+    bool any_drawn = false;
+    for (size_t i = 0; i < inline_image.size(); i += 4)
+    {
+        const auto* px = inline_image.data() + i;
+        any_drawn = any_drawn || px[0] != 0 || px[1] != 0 || px[2] != 0;
+    }
+    REQUIRE(any_drawn);
+
+    REQUIRE(std::equal(inline_image.data(), inline_image.data() + inline_image.size(), threaded_image.data()));
+}
+
+TEST_CASE("frames in flight overlap", "[.][benchmark]")
+{
+    if (!tests::headless_vulkan_available())
+    {
+        SKIP("No Vulkan 1.3 device available");
+    }
+
+    constexpr uint32_t FRAME_COUNT = 200;
+    constexpr auto CPU_WORK = std::chrono::microseconds(2000);
+
+    for (const uint32_t frames_in_flight : { 1U, 2U })
+    {
+        const headless_renderer headless(frames_in_flight);
+        headless.render_frames(10, CPU_WORK);
+
+        std::chrono::nanoseconds total_fence_wait{ 0 };
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < FRAME_COUNT; ++i)
+        {
+            headless.render_frames(1, CPU_WORK);
+            total_fence_wait += headless.renderer->last_frame_fence_wait();
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+
+        WARN(std::format(
+            "{} frame(s) in flight: {:.3f} ms per frame, {:.3f} ms fence wait per frame",
+            frames_in_flight,
+            std::chrono::duration<double, std::milli>(elapsed).count() / FRAME_COUNT,
+            std::chrono::duration<double, std::milli>(total_fence_wait).count() / FRAME_COUNT));
+    }
+}
+
+TEST_CASE("Streamed texture upgrades only load the new mips")
+{
+    if (!tests::headless_vulkan_available())
+    {
+        SKIP("No Vulkan 1.3 device available");
+    }
+
+    // Uploads on a dedicated transfer queue copy the resident mips on the graphics queue, after acquiring the image
+    const bool use_transfer_queue = GENERATE(true, false);
+    const headless_renderer headless(2, use_transfer_queue);
+    if (use_transfer_queue && !headless.vkctx->has_transfer_queue())
+    {
+        SKIP("No dedicated transfer queue family");
+    }
+
+    std::vector<glm::uvec2> mip_sizes;
+    for (uint32_t size = 256; size > 0; size /= 2)
+    {
+        mip_sizes.emplace_back(size, size);
+    }
+
+    auto load_counts = std::make_shared<std::vector<uint32_t>>(mip_sizes.size());
+
+    engine::texture_args_streamed args;
+    args.name = "streamed";
+    args.mip_sizes = mip_sizes;
+    args.min_resident_dimension = 64;
+    args.format = engine::texture_format::R8G8B8A8_LINEAR;
+    args.mip_loader = [load_counts](const uint32_t mip, const std::span<std::byte> dst) {
+        ++(*load_counts)[mip];
+        fill_mip_pattern(mip, dst);
+    };
+    const auto tex = headless.renderer->create_streamed_texture(std::move(args));
+    REQUIRE(tex->resident_base_mip() == 2);
+
+    // One mip per update, with a couple more frames for the last one to complete
+    auto& streamer = headless.renderer->get_texture_streamer();
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        headless.render_frame([&] {
+            streamer.request_mip(*tex, 0);
+            streamer.update(headless.renderer->get_upload_queue(), headless.renderer->current_frame());
+        });
+    }
+
+    REQUIRE(tex->resident_base_mip() == 0);
+    REQUIRE(tex->image().mip_levels() == tex->mip_count());
+    REQUIRE(*load_counts == std::vector<uint32_t>(mip_sizes.size(), 1));
+
+    for (uint32_t mip = 0; mip < tex->mip_count(); ++mip)
+    {
+        std::vector<std::byte> expected(tex->mip_size_bytes(mip));
+        fill_mip_pattern(mip, expected);
+        REQUIRE(read_image_mip(*headless.vkctx, tex->image(), mip, expected.size()) == expected);
+    }
+}
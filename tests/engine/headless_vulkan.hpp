@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cathedral/gfx/vulkan_context.hpp>
+
+#include <VkBootstrap.h>
+
+#include <memory>
+#include <string>
+
+namespace cathedral::tests
+{
+    constexpr int HEADLESS_WIDTH = 640;
+    constexpr int HEADLESS_HEIGHT = 360;
+
+    // Any Vulkan 1.3 device without present support will do, lavapipe included
+    inline bool headless_vulkan_available()
+    {
+        auto inst = vkb::InstanceBuilder{}.set_headless().require_api_version(1, 3, 0).build();
+        if (!inst.has_value())
+        {
+            return false;
+        }
+
+        auto pdev = vkb::PhysicalDeviceSelector(inst.value()).require_present(false).set_minimum_version(1, 3).select();
+        vkb::destroy_instance(inst.value());
+        return pdev.has_value();
+    }
+
+    inline std::unique_ptr<gfx::vulkan_context> make_headless_vulkan_context(
+        const bool use_transfer_queue = true,
+        const std::string& pipeline_cache_dir = {})
+    {
+        gfx::vulkan_context_args vkctx_args;
+        vkctx_args.headless = true;
+        vkctx_args.use_transfer_queue = use_transfer_queue;
+        vkctx_args.pipeline_cache_dir = pipeline_cache_dir;
+        vkctx_args.surface_size_retriever = [] { return glm::ivec2{ HEADLESS_WIDTH, HEADLESS_HEIGHT }; };
+        return std::make_unique<gfx::vulkan_context>(vkctx_args);
+    }
+} // namespace cathedral::tests
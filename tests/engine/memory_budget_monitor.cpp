@@ -0,0 +1,89 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cathedral/gfx/memory_tracker.hpp>
+
+#include <vector>
+
+using namespace cathedral;
+
+namespace
+{
+    // Exact in binary, thresholds land on whole bytes: over budget from 750, back under below 500
+    constexpr float BUDGET_RATIO = 0.75F;
+    constexpr float HYSTERESIS = 0.25F;
+
+    std::vector<gfx::memory_budget_event> update(gfx::memory_budget_monitor& monitor, const uint64_t usage)
+    {
+        const std::vector<gfx::memory_heap_budget> heaps = {
+            { .heap_index = 0, .device_local = true, .size = 2000, .budget = 1000, .usage = usage },
+            { .heap_index = 1, .device_local = false, .size = 8000, .budget = 4000, .usage = 100 }
+        };
+        return monitor.update(heaps);
+    }
+} // namespace
+
+TEST_CASE("Memory budget monitor is quiet under the threshold")
+{
+    gfx::memory_budget_monitor monitor(BUDGET_RATIO, HYSTERESIS);
+
+    REQUIRE(update(monitor, 0).empty());
+    REQUIRE(update(monitor, 500).empty());
+    REQUIRE(update(monitor, 749).empty());
+    REQUIRE_FALSE(monitor.over_budget(0));
+}
+
+TEST_CASE("Memory budget monitor reports every update while over budget")
+{
+    gfx::memory_budget_monitor monitor(BUDGET_RATIO, HYSTERESIS);
+
+    auto events = update(monitor, 750);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].heap_index == 0);
+    REQUIRE(events[0].device_local);
+    REQUIRE(events[0].over_budget);
+    REQUIRE(events[0].usage == 750);
+    REQUIRE(events[0].threshold == 750);
+    REQUIRE(monitor.over_budget(0));
+    REQUIRE_FALSE(monitor.over_budget(1));
+
+    // Usage is followed while the pressure lasts
+    events = update(monitor, 900);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].over_budget);
+    REQUIRE(events[0].usage == 900);
+}
+
+TEST_CASE("Memory budget monitor applies hysteresis before reporting the end of pressure")
+{
+    gfx::memory_budget_monitor monitor(BUDGET_RATIO, HYSTERESIS);
+    REQUIRE(update(monitor, 800).size() == 1);
+
+    // Between the release threshold and the threshold it stays over budget
+    auto events = update(monitor, 700);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].over_budget);
+
+    events = update(monitor, 500);
+    REQUIRE(events.size() == 1);
+    REQUIRE(events[0].over_budget);
+
+    // Below it a single event reports the heap back under budget
+    events = update(monitor, 499);
+    REQUIRE(events.size() == 1);
+    REQUIRE_FALSE(events[0].over_budget);
+    REQUIRE_FALSE(monitor.over_budget(0));
+
+    REQUIRE(update(monitor, 499).empty());
+
+    // Coming back takes the full threshold again
+    REQUIRE(update(monitor, 700).empty());
+    REQUIRE(update(monitor, 750).size() == 1);
+}
+
+TEST_CASE("Memory budget monitor ignores heaps without a budget")
+{
+    gfx::memory_budget_monitor monitor(BUDGET_RATIO, HYSTERESIS);
+
+    const std::vector<gfx::memory_heap_budget> heaps = { { .heap_index = 0, .budget = 0, .usage = 100 } };
+    REQUIRE(monitor.update(heaps).empty());
+}
@@ -0,0 +1,307 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cathedral/engine/descriptor_allocator.hpp>
+#include <cathedral/engine/pipeline_cache.hpp>
+#include <cathedral/gfx/pipeline.hpp>
+#include <cathedral/gfx/shader.hpp>
+#include <cathedral/gfx/vulkan_context.hpp>
+
+#include "headless_vulkan.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace cathedral;
+
+namespace
+{
+    constexpr auto VERTEX_SHADER = R"glsl(#version 450
+layout (location = 0) in vec3 in_position;
+
+void main()
+{
+    gl_Position = vec4(in_position, 1.0);
+}
+)glsl";
+
+    // Distinct SPIR-V per variant, with enough work for the driver's compiler to show up in the timings
+    std::string fragment_shader_source(const uint32_t variant)
+    {
+        return std::format(
+            R"glsl(#version 450
+layout (location = 0) out vec4 out_color;
+
+void main()
+{{
+    vec3 color = vec3(0.0);
+    for (int i = 0; i < 16; ++i)
+    {{
+        color += sin(gl_FragCoord.xyz * float(i + {}));
+    }}
+    out_color = vec4(color, 1.0);
+}}
+)glsl",
+            variant);
+    }
+
+    std::vector<uint32_t> compile_spirv(const gfx::shader_type type, const std::string& source)
+    {
+        gfx::shader shader({ .type = type, .source = source });
+        shader.compile();
+        REQUIRE(!shader.spirv().empty());
+        return shader.spirv();
+    }
+
+    gfx::pipeline_args make_pipeline_args(
+        const gfx::vulkan_context& vkctx,
+        const gfx::shader& vertex_shader,
+        const gfx::shader& fragment_shader)
+    {
+        gfx::pipeline_args args;
+        args.vkctx = &vkctx;
+        args.enable_depth = false;
+        args.enable_stencil = false;
+        args.vertex_input = gfx::vertex_input_description(
+            sizeof(float) * 3,
+            { { .location = 0, .offset = 0, .type = gfx::vertex_data_type::VEC3F } });
+        args.vertex_shader = &vertex_shader;
+        args.fragment_shader = &fragment_shader;
+        args.color_attachment_formats = { vk::Format::eR8G8B8A8Unorm };
+        return args;
+    }
+
+    gfx::descriptor_set_definition uniform_set_definition(const uint32_t count)
+    {
+        gfx::descriptor_set_definition result;
+        result.entries.emplace_back(0, 0, gfx::descriptor_type::UNIFORM, count);
+        return result;
+    }
+
+    bool has_pipeline_cache_file(const std::filesystem::path& dir)
+    {
+        std::error_code ec;
+        return std::filesystem::exists(dir, ec) && !std::filesystem::is_empty(dir, ec);
+    }
+
+    // Times the creation of one pipeline per fragment shader. Shader modules belong to the first context they are used
+    // with, so every call gets its own shaders, and their modules are created before timing
+    std::chrono::nanoseconds time_pipeline_creation(
+        const gfx::vulkan_context& vkctx,
+        const std::vector<uint32_t>& vertex_spirv,
+        const std::vector<std::vector<uint32_t>>& fragment_spirvs)
+    {
+        const auto vertex_shader = gfx::shader::from_compiled(gfx::shader_type::VERTEX, VERTEX_SHADER, vertex_spirv);
+        vertex_shader.get_module(vkctx);
+
+        std::vector<gfx::shader> fragment_shaders;
+        fragment_shaders.reserve(fragment_spirvs.size());
+        for (const auto& spirv : fragment_spirvs)
+        {
+            fragment_shaders.push_back(gfx::shader::from_compiled(gfx::shader_type::FRAGMENT, {}, spirv));
+            fragment_shaders.back().get_module(vkctx);
+        }
+
+        std::vector<std::unique_ptr<gfx::pipeline>> pipelines;
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto& fragment_shader : fragment_shaders)
+        {
+            pipelines.push_back(
+                std::make_unique<gfx::pipeline>(make_pipeline_args(vkctx, vertex_shader, fragment_shader)));
+        }
+        return std::chrono::steady_clock::now() - start;
+    }
+} // namespace
+
+TEST_CASE("Pipeline cache is saved to the directory it points to")
+{
+    if (!tests::headless_vulkan_available())
+    {
+        SKIP("No Vulkan 1.3 device available");
+    }
+
+    const auto first_dir = std::filesystem::temp_directory_path() / "cathedral-tests-pipeline-cache-first";
+    const auto second_dir = std::filesystem::temp_directory_path() / "cathedral-tests-pipeline-cache-second";
+    std::filesystem::remove_all(first_dir);
+    std::filesystem::remove_all(second_dir);
+
+    const auto vertex_spirv = compile_spirv(gfx::shader_type::VERTEX, VERTEX_SHADER);
+    const auto first_spirv = compile_spirv(gfx::shader_type::FRAGMENT, fragment_shader_source(0));
+    const auto second_spirv = compile_spirv(gfx::shader_type::FRAGMENT, fragment_shader_source(1));
+    {
+        auto vkctx = tests::make_headless_vulkan_context(true, first_dir.string());
+        time_pipeline_creation(*vkctx, vertex_spirv, { first_spirv });
+
+        // Switching saves what the first directory's cache gathered
+        vkctx->set_pipeline_cache_dir(second_dir.string());
+        REQUIRE(has_pipeline_cache_file(first_dir));
+        REQUIRE_FALSE(has_pipeline_cache_file(second_dir));
+
+        time_pipeline_creation(*vkctx, vertex_spirv, { second_spirv });
+    }
+    REQUIRE(has_pipeline_cache_file(second_dir));
+
+    std::filesystem::remove_all(first_dir);
+    std::filesystem::remove_all(second_dir);
+}
+
+TEST_CASE("pipeline creation with a cold and a warm pipeline cache", "[.][benchmark]")
+{
+    if (!tests::headless_vulkan_available())
+    {
+        SKIP("No Vulkan 1.3 device available");
+    }
+
+    constexpr uint32_t PIPELINE_COUNT = 64;
+
+    const auto cache_dir = std::filesystem::temp_directory_path() / "cathedral-tests-pipeline-cache-benchmark";
+    std::filesystem::remove_all(cache_dir);
+
+    const auto vertex_spirv = compile_spirv(gfx::shader_type::VERTEX, VERTEX_SHADER);
+    std::vector<std::vector<uint32_t>> fragment_spirvs;
+    for (uint32_t i = 0; i < PIPELINE_COUNT; ++i)
+    {
+        fragment_spirvs.push_back(compile_spirv(gfx::shader_type::FRAGMENT, fragment_shader_source(i)));
+    }
+
+    // The first context starts without a cache file and writes it on destruction, the second one loads it
+    for (const auto* run : { "cold", "warm" })
+    {
+        const auto vkctx = tests::make_headless_vulkan_context(true, cache_dir.string());
+        const auto elapsed = time_pipeline_creation(*vkctx, vertex_spirv, fragment_spirvs);
+
+        WARN(std::format(
+            "{} pipeline cache: {:.3f} ms for {} pipelines, {:.3f} ms per pipeline",
+            run,
+            std::chrono::duration<double, std::milli>(elapsed).count(),
+            PIPELINE_COUNT,
+            std::chrono::duration<double, std::milli>(elapsed).count() / PIPELINE_COUNT));
+    }
+
+    std::filesystem::remove_all(cache_dir);
+}
+
+TEST_CASE("Pipeline cache shares pipelines between identical args")
+{
+    if (!tests::headless_vulkan_available())
+    {
+        SKIP("No Vulkan 1.3 device available");
+    }
+
+    const auto vkctx = tests::make_headless_vulkan_context();
+    engine::descriptor_allocator allocator(*vkctx);
+    engine::pipeline_cache cache(*vkctx, allocator);
+
+    const auto vertex_spirv = compile_spirv(gfx::shader_type::VERTEX, VERTEX_SHADER);
+    const auto fragment_spirv = compile_spirv(gfx::shader_type::FRAGMENT, fragment_shader_source(0));
+    const auto vertex_shader = gfx::shader::from_compiled(gfx::shader_type::VERTEX, VERTEX_SHADER, vertex_spirv);
+    const auto fragment_shader = gfx::shader::from_compiled(gfx::shader_type::FRAGMENT, {}, fragment_spirv);
+
+    // Separately compiled but identical shaders are hits too
+    const auto other_fragment_shader = gfx::shader::from_compiled(gfx::shader_type::FRAGMENT, {}, fragment_spirv);
+
+    auto first = cache.get(make_pipeline_args(*vkctx, vertex_shader, fragment_shader));
+    auto second = cache.get(make_pipeline_args(*vkctx, vertex_shader, other_fragment_shader));
+    REQUIRE(first == second);
+    REQUIRE(cache.stats().hits == 1);
+    REQUIRE(cache.stats().misses == 1);
+    REQUIRE(cache.stats().pipeline_count == 1);
+
+    // Pipelines only live as long as their users, once released they are created again
+    first.reset();
+    second.reset();
+    REQUIRE(cache.get(make_pipeline_args(*vkctx, vertex_shader, fragment_shader)));
+    REQUIRE(cache.stats().hits == 1);
+    REQUIRE(cache.stats().misses == 2);
+    REQUIRE(cache.stats().pipeline_count == 1);
+}
+
+TEST_CASE("Pipeline cache creates pipelines for differing shaders and state")
+{
+    if (!tests::headless_vulkan_available())
+    {
+        SKIP("No Vulkan 1.3 device available");
+    }
+
+    const auto vkctx = tests::make_headless_vulkan_context();
+    engine::descriptor_allocator allocator(*vkctx);
+    engine::pipeline_cache cache(*vkctx, allocator);
+
+    const auto vertex_spirv = compile_spirv(gfx::shader_type::VERTEX, VERTEX_SHADER);
+    const auto vertex_shader = gfx::shader::from_compiled(gfx::shader_type::VERTEX, VERTEX_SHADER, vertex_spirv);
+
+    // Only a constant differs between the variants, their SPIR-V only differs in a few words
+    const auto first_spirv = compile_spirv(gfx::shader_type::FRAGMENT, fragment_shader_source(1));
+    const auto second_spirv = compile_spirv(gfx::shader_type::FRAGMENT, fragment_shader_source(2));
+    REQUIRE(first_spirv != second_spirv);
+    const auto first_shader = gfx::shader::from_compiled(gfx::shader_type::FRAGMENT, {}, first_spirv);
+    const auto second_shader = gfx::shader::from_compiled(gfx::shader_type::FRAGMENT, {}, second_spirv);
+
+    const auto first = cache.get(make_pipeline_args(*vkctx, vertex_shader, first_shader));
+    const auto second = cache.get(make_pipeline_args(*vkctx, vertex_shader, second_shader));
+    REQUIRE(first != second);
+
+    auto culled_args = make_pipeline_args(*vkctx, vertex_shader, first_shader);
+    culled_args.cull_backfaces = !culled_args.cull_backfaces;
+    const auto culled = cache.get(std::move(culled_args));
+    REQUIRE(culled != first);
+
+    REQUIRE(cache.stats().hits == 0);
+    REQUIRE(cache.stats().misses == 3);
+    REQUIRE(cache.stats().pipeline_count == 3);
+}
+
+TEST_CASE("Pipeline cache shares layouts between matching descriptor sets")
+{
+    if (!tests::headless_vulkan_available())
+    {
+        SKIP("No Vulkan 1.3 device available");
+    }
+
+    const auto vkctx = tests::make_headless_vulkan_context();
+    engine::descriptor_allocator allocator(*vkctx);
+    engine::pipeline_cache cache(*vkctx, allocator);
+
+    const auto vertex_spirv = compile_spirv(gfx::shader_type::VERTEX, VERTEX_SHADER);
+    const auto vertex_shader = gfx::shader::from_compiled(gfx::shader_type::VERTEX, VERTEX_SHADER, vertex_spirv);
+    const auto first_shader = gfx::shader::from_compiled(
+        gfx::shader_type::FRAGMENT,
+        {},
+        compile_spirv(gfx::shader_type::FRAGMENT, fragment_shader_source(1)));
+    const auto second_shader = gfx::shader::from_compiled(
+        gfx::shader_type::FRAGMENT,
+        {},
+        compile_spirv(gfx::shader_type::FRAGMENT, fragment_shader_source(2)));
+
+    const auto make_args = [&](const gfx::shader& fragment_shader, const uint32_t uniform_count) {
+        auto args = make_pipeline_args(*vkctx, vertex_shader, fragment_shader);
+        args.descriptor_sets = { { .set_index = 0, .definition = uniform_set_definition(uniform_count) } };
+        return args;
+    };
+
+    // Resolving fills in layouts without creating a pipeline
+    auto resolved_args = make_args(first_shader, 1);
+    cache.resolve_layouts(resolved_args);
+    REQUIRE(resolved_args.layout);
+    REQUIRE(resolved_args.descriptor_sets[0].layout == allocator.layout(uniform_set_definition(1)));
+    REQUIRE(cache.stats().pipeline_count == 0);
+    REQUIRE(cache.stats().layout_count == 1);
+
+    const auto first = cache.get(make_args(first_shader, 1));
+    const auto second = cache.get(make_args(second_shader, 1));
+    REQUIRE(first != second);
+    REQUIRE(first->pipeline_layout() == resolved_args.layout);
+    REQUIRE(second->pipeline_layout() == resolved_args.layout);
+    REQUIRE(first->descriptor_set_layout(0) == second->descriptor_set_layout(0));
+    REQUIRE(cache.stats().layout_count == 1);
+
+    const auto other = cache.get(make_args(first_shader, 2));
+    REQUIRE(other != first);
+    REQUIRE(other->pipeline_layout() != resolved_args.layout);
+    REQUIRE(other->descriptor_set_layout(0) != first->descriptor_set_layout(0));
+    REQUIRE(cache.stats().layout_count == 2);
+}
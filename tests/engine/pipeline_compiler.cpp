@@ -0,0 +1,113 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cathedral/engine/pipeline_compiler.hpp>
+
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace cathedral;
+
+namespace
+{
+    // Holds the compiler's only worker inside a job until released
+    struct blocking_job
+    {
+        std::promise<void> started;
+        std::promise<void> release;
+
+        std::future<int> submit(engine::pipeline_compiler& compiler, const int result)
+        {
+            auto future = compiler.submit([this, release_future = release.get_future(), result]() {
+                started.set_value();
+                release_future.wait();
+                return result;
+            });
+            started.get_future().wait();
+            return future;
+        }
+    };
+} // namespace
+
+TEST_CASE("Pipeline compiler hands job results through futures")
+{
+    engine::pipeline_compiler compiler({ .thread_count = 2 });
+
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 16; ++i)
+    {
+        futures.push_back(compiler.submit([i] { return i * 2; }));
+    }
+
+    for (size_t i = 0; i < futures.size(); ++i)
+    {
+        REQUIRE(futures[i].get() == static_cast<int>(i) * 2);
+    }
+
+    compiler.wait_idle();
+    REQUIRE(compiler.pending_jobs() == 0);
+}
+
+TEST_CASE("Pipeline compiler queues jobs while its workers are busy")
+{
+    engine::pipeline_compiler compiler({ .thread_count = 1 });
+
+    blocking_job blocker;
+    auto blocked = blocker.submit(compiler, -1);
+
+    // Written by the single worker only, and read once wait_idle has returned
+    std::vector<int> order;
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 3; ++i)
+    {
+        futures.push_back(compiler.submit([&order, i] { order.push_back(i); }));
+    }
+    REQUIRE(compiler.pending_jobs() == 3);
+    REQUIRE(futures[0].wait_for(std::chrono::seconds::zero()) == std::future_status::timeout);
+
+    blocker.release.set_value();
+    compiler.wait_idle();
+
+    REQUIRE(blocked.get() == -1);
+    REQUIRE(compiler.pending_jobs() == 0);
+    REQUIRE(order == std::vector<int>{ 0, 1, 2 });
+    for (auto& future : futures)
+    {
+        REQUIRE(future.wait_for(std::chrono::seconds::zero()) == std::future_status::ready);
+    }
+}
+
+TEST_CASE("Pipeline compiler shutdown drops pending jobs")
+{
+    engine::pipeline_compiler compiler({ .thread_count = 1 });
+
+    blocking_job blocker;
+    auto running = blocker.submit(compiler, 1);
+    auto dropped = compiler.submit([] { return 2; });
+    REQUIRE(compiler.pending_jobs() == 1);
+
+    // Shutdown empties the queue right away, then waits for the running job
+    std::jthread stopper([&compiler] { compiler.shutdown(); });
+    while (compiler.pending_jobs() > 0)
+    {
+        std::this_thread::yield();
+    }
+    blocker.release.set_value();
+    stopper.join();
+
+    REQUIRE(running.get() == 1);
+    REQUIRE_THROWS_AS(dropped.get(), std::future_error);
+}
+
+TEST_CASE("Pipeline compiler without threads runs jobs on submission")
+{
+    engine::pipeline_compiler compiler({ .thread_count = 0 });
+
+    auto future = compiler.submit([] { return std::this_thread::get_id(); });
+    REQUIRE(future.wait_for(std::chrono::seconds::zero()) == std::future_status::ready);
+    REQUIRE(future.get() == std::this_thread::get_id());
+    REQUIRE(compiler.pending_jobs() == 0);
+
+    compiler.wait_idle();
+}
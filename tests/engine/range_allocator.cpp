@@ -0,0 +1,63 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cathedral/engine/range_allocator.hpp>
+
+using namespace cathedral;
+
+TEST_CASE("Range allocator hands out first fitting ranges")
+{
+    engine::range_allocator alloc(100);
+
+    REQUIRE(alloc.allocate(10) == 0U);
+    REQUIRE(alloc.allocate(20) == 10U);
+    REQUIRE(alloc.allocate(30) == 30U);
+    REQUIRE(alloc.used() == 60);
+
+    REQUIRE_FALSE(alloc.allocate(41).has_value());
+    REQUIRE(alloc.allocate(40) == 60U);
+    REQUIRE(alloc.largest_free_range() == 0);
+    REQUIRE_FALSE(alloc.allocate(1).has_value());
+}
+
+TEST_CASE("Range allocator reuses freed ranges")
+{
+    engine::range_allocator alloc(100);
+
+    const auto a = alloc.allocate(10);
+    const auto b = alloc.allocate(10);
+    REQUIRE(a.has_value());
+    REQUIRE(b.has_value());
+
+    alloc.free(*a, 10);
+    REQUIRE(alloc.allocate(5) == 0U);
+    REQUIRE(alloc.allocate(5) == 5U);
+
+    // Does not fit in the hole left by 'a', goes after 'b'
+    alloc.free(0, 5);
+    REQUIRE(alloc.allocate(8) == 20U);
+}
+
+TEST_CASE("Range allocator merges neighbouring free ranges")
+{
+    engine::range_allocator alloc(40);
+
+    const auto a = *alloc.allocate(10);
+    const auto b = *alloc.allocate(10);
+    const auto c = *alloc.allocate(10);
+    const auto d = *alloc.allocate(10);
+    REQUIRE(alloc.free_range_count() == 0);
+
+    alloc.free(a, 10);
+    alloc.free(c, 10);
+    REQUIRE(alloc.free_range_count() == 2);
+
+    // Joins both sides
+    alloc.free(b, 10);
+    REQUIRE(alloc.free_range_count() == 1);
+    REQUIRE(alloc.largest_free_range() == 30);
+
+    alloc.free(d, 10);
+    REQUIRE(alloc.free_range_count() == 1);
+    REQUIRE(alloc.largest_free_range() == 40);
+    REQUIRE(alloc.used() == 0);
+}
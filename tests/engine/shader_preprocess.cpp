@@ -85,4 +85,21 @@ TEST_CASE("shader variables")
         REQUIRE(pp_data.node_textures[1] == "ntex_2");
         REQUIRE(pp_data.node_textures[2] == "ntex_3");
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("bindless texture lookups")
+{
+    const auto pp_data = *engine::get_shader_preprocess_data(SOURCE_A_PRE);
+
+    const auto bound_source = engine::preprocess_shader(gfx::shader_type::FRAGMENT, pp_data);
+    REQUIRE(bound_source.has_value());
+    REQUIRE(bound_source->contains("uniform sampler2D cathedral_material_textures[3]"));
+    REQUIRE_FALSE(bound_source->contains("cathedral_textures"));
+
+    const auto bindless_source = engine::preprocess_shader(gfx::shader_type::FRAGMENT, pp_data, true);
+    REQUIRE(bindless_source.has_value());
+    REQUIRE_FALSE(bindless_source->contains("cathedral_material_textures"));
+    REQUIRE(bindless_source->contains("layout (set = 3, binding = 0) uniform sampler2D cathedral_textures[];"));
+    REQUIRE(bindless_source->contains("#define mtex_3 cathedral_textures[cathedral_texture_indices.material[2]]"));
+    REQUIRE(bindless_source->contains("#define ntex_1 cathedral_textures[cathedral_texture_indices.node[0]]"));
+}
@@ -0,0 +1,202 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cathedral/engine/texture_compression.hpp>
+#include <cathedral/engine/texture_decompression.hpp>
+
+#include <ien/image/image.hpp>
+
+#include <stb_dxt.h>
+
+#include <array>
+#include <cstdlib>
+#include <limits>
+#include <random>
+
+using namespace cathedral;
+
+namespace
+{
+    ien::image make_noise_image(const size_t width, const size_t height)
+    {
+        ien::image result(width, height);
+        std::mt19937 rng(1234);
+        std::uniform_int_distribution<int> dist(0, 255);
+        for (size_t i = 0; i < width * height * 4; ++i)
+        {
+            result.data()[i] = static_cast<uint8_t>(dist(rng));
+        }
+        return result;
+    }
+
+    ien::image make_gradient_image(const size_t width, const size_t height, const ien::image_format format)
+    {
+        ien::image result(width, height, format);
+        const size_t channels = result.size() / (width * height);
+        for (size_t y = 0; y < height; ++y)
+        {
+            for (size_t x = 0; x < width; ++x)
+            {
+                for (size_t c = 0; c < channels; ++c)
+                {
+                    const size_t value = (c == 0) ? (x * 255 / (width - 1)) : (y * 255 / (height - 1));
+                    result.data()[(((y * width) + x) * channels) + c] = static_cast<uint8_t>(value);
+                }
+            }
+        }
+        return result;
+    }
+
+    int max_abs_error(const ien::image& source, const std::vector<std::byte>& decompressed)
+    {
+        int result = 0;
+        for (size_t i = 0; i < source.size(); ++i)
+        {
+            const int error = std::abs(static_cast<int>(source.data()[i]) - static_cast<int>(decompressed[i]));
+            result = std::max(result, error);
+        }
+        return result;
+    }
+
+    uint64_t sum_squared_error(const ien::image& source, const std::vector<std::byte>& decompressed)
+    {
+        uint64_t result = 0;
+        for (size_t i = 0; i < source.size(); ++i)
+        {
+            const int error = static_cast<int>(source.data()[i]) - static_cast<int>(decompressed[i]);
+            result += static_cast<uint64_t>(error * error);
+        }
+        return result;
+    }
+
+    // One block at a time, in raster order, as the original encoder did
+    std::vector<std::byte> reference_compress(const ien::image& img, const int alpha, const size_t block_size)
+    {
+        std::vector<std::byte> result;
+        for (size_t y = 0; y < img.height(); y += 4)
+        {
+            for (size_t x = 0; x < img.width(); x += 4)
+            {
+                std::array<uint8_t, 64> block_pixels;
+                for (size_t by = 0; by < 4; ++by)
+                {
+                    for (size_t bx = 0; bx < 16; ++bx)
+                    {
+                        block_pixels[(by * 16) + bx] = img.data()[((y + by) * img.width() * 4) + (x * 4) + bx];
+                    }
+                }
+                std::array<std::byte, 16> block_data{};
+                stb_compress_dxt_block(
+                    reinterpret_cast<unsigned char*>(block_data.data()),
+                    block_pixels.data(),
+                    alpha,
+                    STB_DXT_HIGHQUAL);
+                result.insert(result.end(), block_data.begin(), block_data.begin() + block_size);
+            }
+        }
+        return result;
+    }
+} // namespace
+
+TEST_CASE("texture compression")
+{
+    const auto image = make_noise_image(64, 32);
+
+    SECTION("DXT1/BC1 matches per-block reference")
+    {
+        const auto compressed = engine::create_compressed_texture_data(image, engine::texture_compression_type::DXT1_BC1);
+        REQUIRE(compressed.size() == 64 * 32 / 2);
+        REQUIRE(compressed == reference_compress(image, 0, 8));
+    }
+
+    SECTION("DXT5/BC3 matches per-block reference")
+    {
+        const auto compressed = engine::create_compressed_texture_data(image, engine::texture_compression_type::DXT5_BC3);
+        REQUIRE(compressed.size() == 64 * 32);
+        REQUIRE(compressed == reference_compress(image, 1, 16));
+    }
+}
+
+TEST_CASE("single and dual channel texture compression")
+{
+    SECTION("RGTC1/BC4 round trip")
+    {
+        const auto image = make_gradient_image(64, 64, ien::image_format::R);
+        const auto compressed = engine::create_compressed_texture_data(image, engine::texture_compression_type::RGTC1_BC4);
+        REQUIRE(compressed.size() == 64 * 64 / 2);
+
+        const auto decompressed =
+            engine::decompress_texture_data(compressed.data(), 64, 64, engine::texture_compression_type::RGTC1_BC4);
+        REQUIRE(decompressed.size() == image.size());
+        REQUIRE(max_abs_error(image, decompressed) <= 2);
+    }
+
+    SECTION("RGTC2/BC5 round trip")
+    {
+        const auto image = make_gradient_image(64, 64, ien::image_format::RG);
+        const auto compressed = engine::create_compressed_texture_data(image, engine::texture_compression_type::RGTC2_BC5);
+        REQUIRE(compressed.size() == 64 * 64);
+
+        const auto decompressed =
+            engine::decompress_texture_data(compressed.data(), 64, 64, engine::texture_compression_type::RGTC2_BC5);
+        REQUIRE(decompressed.size() == image.size());
+        REQUIRE(max_abs_error(image, decompressed) <= 2);
+    }
+}
+
+TEST_CASE("BC7 texture compression")
+{
+    constexpr auto type = engine::texture_compression_type::BPTC_BC7;
+
+    SECTION("Gradient round trip")
+    {
+        const auto image = make_gradient_image(64, 64, ien::image_format::RGBA);
+        const auto compressed = engine::create_compressed_texture_data(image, type);
+        REQUIRE(compressed.size() == 64 * 64);
+
+        const auto decompressed = engine::decompress_texture_data(compressed.data(), 64, 64, type);
+        REQUIRE(decompressed.size() == image.size());
+        REQUIRE(max_abs_error(image, decompressed) <= 8);
+    }
+
+    SECTION("Deeper searches never increase the error")
+    {
+        const auto image = make_noise_image(32, 32);
+        uint64_t previous_error = std::numeric_limits<uint64_t>::max();
+        for (const auto depth :
+             { engine::bc7_search_depth::FAST, engine::bc7_search_depth::NORMAL, engine::bc7_search_depth::EXHAUSTIVE })
+        {
+            const auto compressed = engine::create_compressed_texture_data(image, type, depth);
+            const auto decompressed = engine::decompress_texture_data(compressed.data(), 32, 32, type);
+            const auto error = sum_squared_error(image, decompressed);
+            REQUIRE(error <= previous_error);
+            previous_error = error;
+        }
+    }
+}
+
+TEST_CASE("non power of 2 texture compression")
+{
+    SECTION("Edge blocks are padded")
+    {
+        const auto image = make_gradient_image(37, 13, ien::image_format::R);
+        const auto compressed = engine::create_compressed_texture_data(image, engine::texture_compression_type::RGTC1_BC4);
+        REQUIRE(compressed.size() == 10 * 4 * 8);
+        REQUIRE(compressed.size() == engine::calc_compressed_texture_size(37, 13, engine::texture_compression_type::RGTC1_BC4));
+
+        const auto decompressed =
+            engine::decompress_texture_data(compressed.data(), 37, 13, engine::texture_compression_type::RGTC1_BC4);
+        REQUIRE(decompressed.size() == image.size());
+        REQUIRE(max_abs_error(image, decompressed) <= 2);
+    }
+
+    SECTION("Images smaller than a block")
+    {
+        const auto image = make_noise_image(2, 1);
+        const auto compressed = engine::create_compressed_texture_data(image, engine::texture_compression_type::BPTC_BC7);
+        REQUIRE(compressed.size() == 16);
+
+        const auto decompressed =
+            engine::decompress_texture_data(compressed.data(), 2, 1, engine::texture_compression_type::BPTC_BC7);
+        REQUIRE(decompressed.size() == image.size());
+    }
+}
@@ -0,0 +1,239 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cathedral/engine/texture_mip.hpp>
+#include <cathedral/srgb.hpp>
+
+#include <ien/image/image.hpp>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <random>
+
+using namespace cathedral;
+
+namespace
+{
+    ien::image make_noise_image(const size_t width, const size_t height, const ien::image_format format)
+    {
+        ien::image result(width, height, format);
+        std::mt19937 rng(4321);
+        std::uniform_int_distribution<int> dist(0, 255);
+        for (size_t i = 0; i < result.size(); ++i)
+        {
+            result.data()[i] = static_cast<uint8_t>(dist(rng));
+        }
+        return result;
+    }
+
+    // Straightforward level by level 2x2 average
+    std::vector<uint8_t> reference_box_mip(
+        const std::vector<uint8_t>& src,
+        const uint32_t src_width,
+        const uint32_t src_height,
+        const uint32_t pixel_size)
+    {
+        const uint32_t width = std::max<uint32_t>(src_width / 2, 1);
+        const uint32_t height = std::max<uint32_t>(src_height / 2, 1);
+        std::vector<uint8_t> result(static_cast<size_t>(width) * height * pixel_size);
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                for (uint32_t c = 0; c < pixel_size; ++c)
+                {
+                    const auto at = [&](const uint32_t sx, const uint32_t sy) -> uint32_t {
+                        return src[(((std::min(sy, src_height - 1) * src_width) + std::min(sx, src_width - 1)) * pixel_size) + c];
+                    };
+                    const uint32_t sum = at(2 * x, 2 * y) + at((2 * x) + 1, 2 * y) + at(2 * x, (2 * y) + 1) +
+                                         at((2 * x) + 1, (2 * y) + 1);
+                    result[(((y * width) + x) * pixel_size) + c] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+        return result;
+    }
+
+    void check_box_chain(const uint32_t width, const uint32_t height, const ien::image_format format)
+    {
+        const auto image = make_noise_image(width, height, format);
+        const auto pixel_size = static_cast<uint32_t>(image.size() / (static_cast<size_t>(width) * height));
+        const auto chain = engine::create_image_mips(image, engine::mip_filter::BOX, 32);
+
+        std::vector<uint8_t> previous(image.data(), image.data() + image.size());
+        uint32_t previous_width = width;
+        uint32_t previous_height = height;
+        for (size_t i = 0; i < chain.level_count(); ++i)
+        {
+            const auto expected = reference_box_mip(previous, previous_width, previous_height, pixel_size);
+            const auto data = chain.level_data(i);
+            REQUIRE(data.size() == expected.size());
+            REQUIRE(std::equal(expected.begin(), expected.end(), reinterpret_cast<const uint8_t*>(data.data())));
+
+            previous = expected;
+            previous_width = chain.level(i).width;
+            previous_height = chain.level(i).height;
+        }
+        REQUIRE(previous_width == 1);
+        REQUIRE(previous_height == 1);
+    }
+} // namespace
+
+TEST_CASE("mip chain generation")
+{
+    SECTION("Levels are laid out back to back")
+    {
+        const auto image = make_noise_image(300, 20, ien::image_format::RGBA);
+        const auto chain = engine::create_image_mips(image, engine::mip_filter::BOX, 32);
+        REQUIRE(chain.level_count() == 8);
+
+        size_t offset = 0;
+        for (const auto& level : chain.levels())
+        {
+            REQUIRE(level.offset == offset);
+            offset += level.size;
+        }
+        REQUIRE(chain.data().size() == offset);
+        REQUIRE(chain.level(6).width == 2);
+        REQUIRE(chain.level(7).width == 1);
+        REQUIRE(chain.level(7).height == 1);
+    }
+
+    SECTION("Box filter matches level by level reference")
+    {
+        check_box_chain(256, 256, ien::image_format::RGBA);
+        check_box_chain(300, 77, ien::image_format::RGBA);
+        check_box_chain(131, 257, ien::image_format::RGB);
+        check_box_chain(90, 45, ien::image_format::R);
+    }
+
+    SECTION("Windowed sinc filters preserve flat images")
+    {
+        ien::image image(96, 40, ien::image_format::RG);
+        std::fill(image.data(), image.data() + image.size(), static_cast<uint8_t>(77));
+
+        for (const auto filter : { engine::mip_filter::KAISER, engine::mip_filter::LANCZOS3 })
+        {
+            const auto chain = engine::create_image_mips(image, filter, 3);
+            REQUIRE(chain.level_count() == 3);
+            REQUIRE(std::ranges::all_of(chain.data(), [](const std::byte value) { return value == std::byte{ 77 }; }));
+        }
+    }
+}
+
+TEST_CASE("sRGB conversion kernels")
+{
+    SECTION("Every encoded value survives a round trip")
+    {
+        std::array<uint8_t, 256> encoded = {};
+        std::array<float, 256> linear = {};
+        std::array<uint8_t, 256> round_trip = {};
+        for (size_t i = 0; i < encoded.size(); ++i)
+        {
+            encoded[i] = static_cast<uint8_t>(i);
+        }
+
+        srgb_to_linear(encoded.data(), linear.data(), linear.size());
+        linear_to_srgb(linear.data(), round_trip.data(), round_trip.size());
+        REQUIRE(round_trip == encoded);
+        REQUIRE(linear[0] == 0.0F);
+        REQUIRE(linear[255] == 1.0F);
+    }
+
+    SECTION("Batch and scalar encoding agree and clamp")
+    {
+        std::vector<float> linear;
+        for (int i = -100; i <= 1100; ++i)
+        {
+            linear.push_back(static_cast<float>(i) / 1000.0F);
+        }
+        linear.push_back(std::numeric_limits<float>::quiet_NaN());
+
+        std::vector<uint8_t> encoded(linear.size());
+        linear_to_srgb(linear.data(), encoded.data(), linear.size());
+        for (size_t i = 0; i < linear.size(); ++i)
+        {
+            REQUIRE(encoded[i] == linear_to_srgb(linear[i]));
+        }
+        REQUIRE(encoded.front() == 0);
+        REQUIRE(encoded[1100] == 255);
+        REQUIRE(encoded.back() == 0);
+    }
+}
+
+TEST_CASE("sRGB mip generation")
+{
+    SECTION("Color is averaged in linear light, alpha is not")
+    {
+        ien::image image(2, 2, ien::image_format::RGBA);
+        for (size_t i = 0; i < image.size(); ++i)
+        {
+            image.data()[i] = (i / 4) % 3 == 0 ? 255 : 0;
+        }
+
+        for (const auto filter : { engine::mip_filter::BOX, engine::mip_filter::KAISER })
+        {
+            const auto gamma_chain = engine::create_image_mips(image, filter, 1);
+            const auto linear_chain = engine::create_image_mips(image, filter, 1, true);
+            const auto* gamma = reinterpret_cast<const uint8_t*>(gamma_chain.level_data(0).data());
+            const auto* linear = reinterpret_cast<const uint8_t*>(linear_chain.level_data(0).data());
+
+            REQUIRE(gamma[0] == 128);
+            REQUIRE(linear[0] == linear_to_srgb(0.5F));
+            REQUIRE(linear[3] == 128);
+        }
+    }
+
+    SECTION("Flat images stay flat")
+    {
+        ien::image image(70, 33, ien::image_format::RGBA);
+        std::fill(image.data(), image.data() + image.size(), static_cast<uint8_t>(200));
+
+        for (const auto filter : { engine::mip_filter::BOX, engine::mip_filter::LANCZOS3 })
+        {
+            const auto chain = engine::create_image_mips(image, filter, 32, true);
+            REQUIRE(std::ranges::all_of(chain.data(), [](const std::byte value) { return value == std::byte{ 200 }; }));
+        }
+    }
+}
+
+TEST_CASE("mip generation throughput", "[.][benchmark]")
+{
+    const auto image = make_noise_image(2048, 2048, ien::image_format::RGBA);
+
+    BENCHMARK("Box, gamma space")
+    {
+        return engine::create_image_mips(image, engine::mip_filter::BOX, 32);
+    };
+
+    BENCHMARK("Box, linear light")
+    {
+        return engine::create_image_mips(image, engine::mip_filter::BOX, 32, true);
+    };
+
+    BENCHMARK("Kaiser, gamma space")
+    {
+        return engine::create_image_mips(image, engine::mip_filter::KAISER, 32);
+    };
+
+    BENCHMARK("Kaiser, linear light")
+    {
+        return engine::create_image_mips(image, engine::mip_filter::KAISER, 32, true);
+    };
+
+    std::vector<uint8_t> encoded(image.data(), image.data() + image.size());
+    std::vector<float> linear(image.size());
+
+    BENCHMARK("sRGB decode")
+    {
+        srgb_to_linear(encoded.data(), linear.data(), linear.size());
+        return linear.back();
+    };
+
+    BENCHMARK("sRGB encode")
+    {
+        linear_to_srgb(linear.data(), encoded.data(), encoded.size());
+        return encoded.back();
+    };
+}
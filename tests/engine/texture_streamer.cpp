@@ -0,0 +1,159 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cathedral/engine/texture_streamer.hpp>
+
+#include <array>
+#include <vector>
+
+using namespace cathedral;
+
+namespace
+{
+    // 1024x1024 RGBA8 mip chain, 11 mips
+    const std::vector<size_t> MIP_BYTES = [] {
+        std::vector<size_t> result;
+        for (size_t size = 1024; size > 0; size /= 2)
+        {
+            result.push_back(size * size * 4);
+        }
+        return result;
+    }();
+
+    size_t bytes_from(const uint32_t base_mip)
+    {
+        size_t result = 0;
+        for (size_t mip = base_mip; mip < MIP_BYTES.size(); ++mip)
+        {
+            result += MIP_BYTES[mip];
+        }
+        return result;
+    }
+
+    engine::texture_streaming_state make_state(
+        const uint32_t resident_base_mip,
+        const uint32_t target_mip,
+        const uint64_t last_used_frame)
+    {
+        return { .resident_base_mip = resident_base_mip,
+                 .min_resident_base_mip = 6,
+                 .target_mip = target_mip,
+                 .last_used_frame = last_used_frame,
+                 .mip_bytes = MIP_BYTES };
+    }
+} // namespace
+
+TEST_CASE("Texture streaming mip follows the projected size")
+{
+    const glm::uvec2 size = { 1024, 512 };
+    constexpr uint32_t mip_count = 11;
+
+    REQUIRE(engine::calc_texture_streaming_mip(size, 1024.0F, mip_count) == 0);
+    REQUIRE(engine::calc_texture_streaming_mip(size, 512.0F, mip_count) == 1);
+    REQUIRE(engine::calc_texture_streaming_mip(size, 500.0F, mip_count) == 1);
+    REQUIRE(engine::calc_texture_streaming_mip(size, 256.0F, mip_count) == 2);
+    REQUIRE(engine::calc_texture_streaming_mip(size, 4.0F, mip_count) == 8);
+}
+
+TEST_CASE("Texture streaming mip is clamped to the mip chain")
+{
+    const glm::uvec2 size = { 1024, 1024 };
+
+    // Magnified textures want the full resolution mip
+    REQUIRE(engine::calc_texture_streaming_mip(size, 4096.0F, 11) == 0);
+
+    // Tiny or off screen textures want the last mip
+    REQUIRE(engine::calc_texture_streaming_mip(size, 0.5F, 11) == 10);
+    REQUIRE(engine::calc_texture_streaming_mip(size, 1.0F, 4) == 3);
+    REQUIRE(engine::calc_texture_streaming_mip(size, 0.0F, 11) == 10);
+    REQUIRE(engine::calc_texture_streaming_mip(size, -1.0F, 11) == 10);
+}
+
+TEST_CASE("Texture streaming evicts nothing within budget")
+{
+    const std::array states = { make_state(0, 6, 1), make_state(0, 6, 2) };
+    const size_t resident = bytes_from(0) * 2;
+
+    REQUIRE(engine::plan_texture_evictions(states, resident, resident).empty());
+}
+
+TEST_CASE("Texture streaming evicts least recently used textures first")
+{
+    const std::array states = { make_state(0, 6, 30), make_state(0, 6, 10), make_state(0, 6, 20) };
+    const size_t resident = bytes_from(0) * 3;
+
+    // Dropping one texture to its minimum residency is enough
+    const auto one = engine::plan_texture_evictions(states, resident, resident - bytes_from(0) + bytes_from(6));
+    REQUIRE(one.size() == 1);
+    REQUIRE(one[0].texture_index == 1);
+    REQUIRE(one[0].base_mip == 6);
+
+    // Two are needed here, the most recently used one is kept
+    const auto two = engine::plan_texture_evictions(states, resident, bytes_from(0) + (bytes_from(6) * 2));
+    REQUIRE(two.size() == 2);
+    REQUIRE(two[0].texture_index == 1);
+    REQUIRE(two[1].texture_index == 2);
+}
+
+TEST_CASE("Texture streaming evictions keep the mips textures still need")
+{
+    // Texture 0 still needs mip 2 and up, texture 1 is already at its target
+    const std::array states = { make_state(0, 2, 1), make_state(3, 3, 2) };
+    const size_t resident = bytes_from(0) + bytes_from(3);
+
+    const auto changes = engine::plan_texture_evictions(states, resident, 0);
+    REQUIRE(changes.size() == 1);
+    REQUIRE(changes[0].texture_index == 0);
+    REQUIRE(changes[0].base_mip == 2);
+}
+
+TEST_CASE("Texture streaming upgrades one mip at a time within budget")
+{
+    const std::array states = { make_state(6, 0, 5), make_state(6, 0, 9), make_state(6, 5, 9), make_state(6, 6, 9) };
+    const size_t resident = bytes_from(6) * 4;
+
+    // Most recently used first, furthest from the target first, never past the target
+    const auto all = engine::plan_texture_upgrades(states, resident, resident * 2, 8);
+    REQUIRE(all.size() == 3);
+    REQUIRE(all[0].texture_index == 1);
+    REQUIRE(all[1].texture_index == 2);
+    REQUIRE(all[2].texture_index == 0);
+    for (const auto& change : all)
+    {
+        REQUIRE(change.base_mip == 5);
+    }
+
+    // Per frame limit
+    REQUIRE(engine::plan_texture_upgrades(states, resident, resident * 2, 1).size() == 1);
+
+    // Only what fits in the budget
+    const auto fitting = engine::plan_texture_upgrades(states, resident, resident + MIP_BYTES[5], 8);
+    REQUIRE(fitting.size() == 1);
+    REQUIRE(fitting[0].texture_index == 1);
+}
+
+TEST_CASE("Texture streaming budget follows the memory pressure")
+{
+    constexpr size_t configured = 512;
+
+    gfx::memory_budget_event event;
+    event.device_local = true;
+    event.budget = 2000;
+    event.threshold = 1800;
+
+    // Other allocations use 1500 of the 1800 below the threshold, leaving 300 for streamed textures
+    event.usage = 1900;
+    REQUIRE(engine::calc_texture_streaming_budget(event, configured, 400) == 300);
+
+    // Never above the configured budget
+    event.usage = 1000;
+    REQUIRE(engine::calc_texture_streaming_budget(event, configured, 400) == configured);
+
+    // Nothing left when everything else already exceeds the threshold
+    event.usage = 2000;
+    REQUIRE(engine::calc_texture_streaming_budget(event, configured, 100) == 0);
+
+    // The configured budget is restored once the pressure ends, even if usage is still close to the threshold
+    event.over_budget = false;
+    event.usage = 1700;
+    REQUIRE(engine::calc_texture_streaming_budget(event, configured, 400) == configured);
+}
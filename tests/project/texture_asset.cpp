@@ -0,0 +1,116 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cathedral/project/assets/texture_asset.hpp>
+
+#include <cathedral/compression.hpp>
+
+#include <ien/io_utils.hpp>
+#include <ien/serialization.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <random>
+
+using namespace cathedral;
+
+namespace
+{
+    constexpr uint32_t TEXTURE_SIZE = 64;
+
+    // Assets only need a project to be placed by name, a path is enough to read and write their binaries
+    project::texture_asset make_asset(const std::string& name)
+    {
+        const auto dir = std::filesystem::temp_directory_path() / "cathedral-tests-project";
+        std::filesystem::create_directories(dir);
+
+        project::texture_asset asset(nullptr, (dir / (name + ".casset")).string());
+        asset.set_width(TEXTURE_SIZE);
+        asset.set_height(TEXTURE_SIZE);
+        asset.set_format(engine::texture_format::R8G8B8A8_LINEAR);
+
+        std::vector<glm::uvec2> mip_sizes;
+        for (uint32_t size = TEXTURE_SIZE; size > 0; size /= 2)
+        {
+            mip_sizes.emplace_back(size, size);
+        }
+        asset.set_mip_dimensions(mip_sizes);
+        return asset;
+    }
+
+    std::vector<std::vector<std::byte>> make_mips(const project::texture_asset& asset)
+    {
+        std::mt19937 rng(1234);
+        std::uniform_int_distribution<int> dist(0, 255);
+
+        std::vector<std::vector<std::byte>> result;
+        for (const auto& size : asset.mip_sizes())
+        {
+            auto& mip = result.emplace_back(engine::calc_texture_size(size.x, size.y, asset.format()));
+            for (auto& b : mip)
+            {
+                b = static_cast<std::byte>(dist(rng));
+            }
+        }
+        return result;
+    }
+
+    // Layout of the binaries written before the mip table was introduced: a serialized vector<vector<byte>> of the
+    // compressed mips
+    void write_legacy_binary(const project::texture_asset& asset, const std::vector<std::vector<std::byte>>& mips)
+    {
+        using size_type = IEN_SERIALIZE_CONTAINER_SIZE_T;
+
+        std::vector<std::byte> data;
+        const auto append = [&data](const void* src, const size_t size) {
+            const auto offset = data.size();
+            data.resize(offset + size);
+            std::memcpy(data.data() + offset, src, size);
+        };
+
+        const auto mip_count = static_cast<size_type>(mips.size());
+        append(&mip_count, sizeof(mip_count));
+        for (const auto& mip : mips)
+        {
+            const auto compressed = compress_data(mip);
+            const auto compressed_size = static_cast<size_type>(compressed.size());
+            append(&compressed_size, sizeof(compressed_size));
+            append(compressed.data(), compressed.size());
+        }
+
+        REQUIRE(ien::write_file_binary(asset.binpath(), data));
+    }
+} // namespace
+
+TEST_CASE("Texture asset mips round trip through the binary")
+{
+    const auto asset = make_asset("round_trip");
+    const auto mips = make_mips(asset);
+    asset.save_mips(mips);
+
+    REQUIRE(asset.load_mips() == mips);
+    for (uint32_t i = 0; i < mips.size(); ++i)
+    {
+        REQUIRE(asset.load_single_mip(i) == mips[i]);
+    }
+
+    const project::texture_asset::mip_reader reader(asset);
+    REQUIRE(reader.mip_count() == mips.size());
+
+    std::vector<std::byte> mip(reader.mip_size_bytes(2));
+    reader.read(2, mip);
+    REQUIRE(mip == mips[2]);
+
+    std::filesystem::remove(asset.binpath());
+}
+
+TEST_CASE("Texture asset loads legacy binaries")
+{
+    const auto asset = make_asset("legacy");
+    const auto mips = make_mips(asset);
+    write_legacy_binary(asset, mips);
+
+    REQUIRE(asset.load_mips() == mips);
+    REQUIRE(asset.load_single_mip(static_cast<uint32_t>(mips.size() - 1)) == mips.back());
+
+    std::filesystem::remove(asset.binpath());
+}